@@ -0,0 +1,302 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <random>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/thread_pool.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/etl.hpp>
+#include <silkworm/db/history_index.hpp>
+#include <silkworm/db/intermediate_hashes.hpp>
+#include <silkworm/db/tables.hpp>
+#include <silkworm/db/util.hpp>
+#include <silkworm/types/account.hpp>
+#include <vector>
+
+using namespace silkworm;
+
+namespace {
+
+constexpr size_t kNumOfAccounts{1'000'000};
+constexpr size_t kNumOfContracts{1'000};
+constexpr size_t kNumOfSlotsPerContract{1'000};
+
+// A PlainState populated with random accounts and contract storage
+struct PlainStateFixture {
+    TemporaryDirectory tmp_dir;
+    std::shared_ptr<lmdb::Environment> env;
+
+    std::vector<evmc::address> accounts;
+    std::vector<Bytes> storage_prefixes;
+    std::vector<evmc::bytes32> locations;
+
+    PlainStateFixture() {
+        lmdb::DatabaseConfig db_config{tmp_dir.path()};
+        db_config.set_readonly(false);
+        db_config.map_size = 8ull << 30;
+        env = lmdb::get_env(db_config);
+
+        std::mt19937_64 rng{42};
+        auto random_bytes{[&rng](uint8_t* out, size_t n) {
+            for (size_t i{0}; i < n; ++i) {
+                out[i] = static_cast<uint8_t>(rng());
+            }
+        }};
+
+        auto txn{env->begin_rw_transaction()};
+        db::table::create_all(*txn);
+        auto state{txn->open(db::table::kPlainState)};
+
+        accounts.resize(kNumOfAccounts);
+        for (evmc::address& address : accounts) {
+            random_bytes(address.bytes, kAddressLength);
+            Account account;
+            account.nonce = rng() % 1000;
+            account.balance = rng();
+            state->put(full_view(address), account.encode_for_storage(/*omit_code_hash=*/false));
+        }
+
+        locations.resize(kNumOfSlotsPerContract);
+        for (evmc::bytes32& location : locations) {
+            random_bytes(location.bytes, kHashLength);
+        }
+        for (size_t i{0}; i < kNumOfContracts; ++i) {
+            storage_prefixes.push_back(db::storage_prefix(accounts[i], db::kDefaultIncarnation));
+            for (const evmc::bytes32& location : locations) {
+                Bytes data{full_view(location)};
+                data.push_back(static_cast<uint8_t>(rng() | 1));
+                state->put(storage_prefixes.back(), data);
+            }
+        }
+
+        state.reset();
+        lmdb::err_handler(txn->commit());
+    }
+};
+
+PlainStateFixture& fixture() {
+    static PlainStateFixture instance;
+    return instance;
+}
+
+// The fixture with its hashed state in kCurrentState
+lmdb::Environment& hashed_state_env() {
+    static std::shared_ptr<lmdb::Environment> env{[] {
+        auto txn{fixture().env->begin_rw_transaction()};
+        db::regenerate_intermediate_hashes(*txn);
+        lmdb::err_handler(txn->commit());
+        return fixture().env;
+    }()};
+    return *env;
+}
+
+std::vector<ByteView> random_account_keys(size_t n) {
+    std::mt19937_64 rng{n};
+    std::vector<ByteView> keys(n);
+    for (ByteView& key : keys) {
+        key = full_view(fixture().accounts[rng() % kNumOfAccounts]);
+    }
+    return keys;
+}
+
+std::vector<std::pair<ByteView, ByteView>> random_storage_keys(size_t n) {
+    std::mt19937_64 rng{n};
+    std::vector<std::pair<ByteView, ByteView>> keys(n);
+    for (auto& key : keys) {
+        key.first = fixture().storage_prefixes[rng() % kNumOfContracts];
+        key.second = full_view(fixture().locations[rng() % kNumOfSlotsPerContract]);
+    }
+    return keys;
+}
+
+// An index chunk of n elements with random gaps
+Bytes random_history_chunk(size_t n) {
+    std::mt19937_64 rng{n};
+    db::history_index::Chunk chunk;
+    uint64_t block{rng() % 10'000'000};
+    for (size_t i{0}; i < n; ++i) {
+        chunk.push_back(block, rng() % 8 == 0);
+        block += 1 + rng() % 100;
+    }
+    return chunk.encode();
+}
+
+std::vector<uint64_t> random_blocks(ByteView chunk, size_t n) {
+    db::history_index::Chunk decoded{chunk};
+    uint64_t first{decoded[0].change_block};
+    uint64_t last{decoded[decoded.size() - 1].change_block};
+    std::mt19937_64 rng{n};
+    std::vector<uint64_t> blocks(n);
+    for (uint64_t& block : blocks) {
+        block = first + rng() % (last - first + 1);
+    }
+    return blocks;
+}
+
+constexpr size_t kNumOfSearches{1'000};
+
+// Collects n entries with random 8-byte keys and values
+void collect_random_entries(db::etl::Collector& collector, size_t n) {
+    std::mt19937_64 rng{n};
+    uint8_t entry[16];
+    for (size_t i{0}; i < n; ++i) {
+        boost::endian::store_big_u64(&entry[0], rng());
+        boost::endian::store_big_u64(&entry[8], rng());
+        collector.collect({&entry[0], 8}, {&entry[8], 8});
+    }
+}
+
+}  // namespace
+
+static void history_index_find(benchmark::State& state) {
+    const Bytes chunk{random_history_chunk(state.range(0))};
+    const std::vector<uint64_t> blocks{random_blocks(chunk, kNumOfSearches)};
+    for (auto _ : state) {
+        for (uint64_t block : blocks) {
+            benchmark::DoNotOptimize(db::history_index::find(chunk, block));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * blocks.size());
+}
+
+static void history_index_chunk_find(benchmark::State& state) {
+    const Bytes encoded{random_history_chunk(state.range(0))};
+    const std::vector<uint64_t> blocks{random_blocks(encoded, kNumOfSearches)};
+    const db::history_index::Chunk chunk{encoded};
+    for (auto _ : state) {
+        for (uint64_t block : blocks) {
+            benchmark::DoNotOptimize(chunk.find(block));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * blocks.size());
+}
+
+static void history_index_chunk_decode(benchmark::State& state) {
+    const Bytes encoded{random_history_chunk(state.range(0))};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db::history_index::Chunk{encoded});
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void plain_state_get(benchmark::State& state) {
+    const std::vector<ByteView> keys{random_account_keys(state.range(0))};
+    auto txn{fixture().env->begin_ro_transaction()};
+    auto table{txn->open(db::table::kPlainState)};
+    for (auto _ : state) {
+        for (ByteView key : keys) {
+            benchmark::DoNotOptimize(table->get(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void plain_state_multi_get(benchmark::State& state) {
+    const std::vector<ByteView> keys{random_account_keys(state.range(0))};
+    auto txn{fixture().env->begin_ro_transaction()};
+    auto table{txn->open(db::table::kPlainState)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table->multi_get(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void plain_storage_get(benchmark::State& state) {
+    const std::vector<std::pair<ByteView, ByteView>> keys{random_storage_keys(state.range(0))};
+    auto txn{fixture().env->begin_ro_transaction()};
+    auto table{txn->open(db::table::kPlainState)};
+    for (auto _ : state) {
+        for (const auto& [key, sub_key] : keys) {
+            benchmark::DoNotOptimize(table->get(key, sub_key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void plain_storage_multi_get(benchmark::State& state) {
+    const std::vector<std::pair<ByteView, ByteView>> keys{random_storage_keys(state.range(0))};
+    auto txn{fixture().env->begin_ro_transaction()};
+    auto table{txn->open(db::table::kPlainState)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table->multi_get(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void etl_collect_and_sort(benchmark::State& state) {
+    for (auto _ : state) {
+        db::etl::Collector collector;
+        collect_random_entries(collector, state.range(0));
+        uint64_t checksum{0};
+        collector.load([&checksum](ByteView key, ByteView) { checksum += key[0]; });
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void etl_load_table(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        TemporaryDirectory tmp_dir;
+        lmdb::DatabaseConfig db_config{tmp_dir.path()};
+        db_config.set_readonly(false);
+        db_config.map_size = 64ull << 30;
+        auto env{lmdb::get_env(db_config)};
+        auto txn{env->begin_rw_transaction()};
+        db::table::create_all(*txn);
+        auto table{txn->open(db::table::kHeaderNumbers)};
+        state.ResumeTiming();
+
+        db::etl::Collector collector;
+        collect_random_entries(collector, state.range(0));
+        collector.load(*table);
+
+        state.PauseTiming();
+        table.reset();
+        txn.reset();
+        env.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void state_root(benchmark::State& state) {
+    lmdb::Environment& env{hashed_state_env()};
+    ThreadPool pool{static_cast<size_t>(state.range(0))};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db::calculate_state_root(env, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * kNumOfAccounts);
+}
+
+BENCHMARK(history_index_find)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(history_index_chunk_find)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(history_index_chunk_decode)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(plain_state_get)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(plain_state_multi_get)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(plain_storage_get)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(plain_storage_multi_get)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(etl_collect_and_sort)->Arg(1'000'000)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(etl_load_table)->Arg(1'000'000)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(state_root)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
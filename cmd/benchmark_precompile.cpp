@@ -16,8 +16,14 @@
 
 #include <benchmark/benchmark.h>
 
+#include <cstring>
 #include <silkworm/common/util.hpp>
+#include <silkworm/crypto/blake2b.hpp>
+#include <silkworm/crypto/ecdsa.hpp>
+#include <silkworm/crypto/keccak.hpp>
+#include <silkworm/crypto/modexp.hpp>
 #include <silkworm/execution/precompiled.hpp>
+#include <vector>
 
 static void ec_recovery(benchmark::State& state) {
     using namespace silkworm;
@@ -32,4 +38,170 @@ static void ec_recovery(benchmark::State& state) {
 
 BENCHMARK(ec_recovery);
 
+static void ec_recovery_batch(benchmark::State& state) {
+    using namespace silkworm;
+    Bytes message{from_hex("18c547e4f7b0f325ad1e56f57e26c745b09a3e503d86e00e5255ff7f715d3d1c")};
+    Bytes rs{from_hex("73b1693892219d736caba55bdb67216e485557ea6b6af75f37096c9aa6a5a75f"
+                      "eeb940b1d03b21e36b0e47e79769f095fe2ab855bd91e3a38756b7d75a9c4549")};
+
+    ecdsa::RecoverableSignature signature;
+    std::memcpy(signature.message, message.data(), message.length());
+    std::memcpy(signature.signature, rs.data(), rs.length());
+    signature.recovery_id = 1;  // v = 28
+
+    const auto n{static_cast<size_t>(state.range(0))};
+    std::vector<ecdsa::RecoverableSignature> signatures(n, signature);
+    std::vector<evmc::address> addresses(n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ecdsa::recover_addresses(signatures.data(), n, addresses.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(ec_recovery_batch)->Arg(1)->Arg(1'000);
+
+// Like the topics and addresses of a bloom, or short trie leaves
+static std::vector<silkworm::Bytes> keccak_messages(size_t n) {
+    std::vector<silkworm::Bytes> messages(n, silkworm::Bytes(32, '\0'));
+    for (size_t k{0}; k < n; ++k) {
+        std::memcpy(messages[k].data(), &k, sizeof(k));
+    }
+    return messages;
+}
+
+static void keccak(benchmark::State& state) {
+    using namespace silkworm;
+    std::vector<Bytes> messages{keccak_messages(1'000)};
+    for (auto _ : state) {
+        for (const Bytes& message : messages) {
+            benchmark::DoNotOptimize(keccak256(message));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * messages.size());
+}
+
+BENCHMARK(keccak);
+
+static void keccak_batch(benchmark::State& state) {
+    using namespace silkworm;
+    std::vector<Bytes> messages{keccak_messages(1'000)};
+    std::vector<ByteView> views(messages.begin(), messages.end());
+    std::vector<ethash::hash256> hashes(views.size());
+    for (auto _ : state) {
+        keccak256_batch(views.data(), views.size(), hashes.data());
+        benchmark::DoNotOptimize(hashes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * views.size());
+}
+
+BENCHMARK(keccak_batch);
+
+// MODEXP input with an odd modulus of state.range(0) bits; the exponent is either 65537,
+// as for RSA signature verification, or as long as the modulus, as for signing
+static silkworm::Bytes expmod_input(size_t modulus_bits, bool short_exponent) {
+    using namespace silkworm;
+    const size_t len{modulus_bits / 8};
+    Bytes base(len, '\0');
+    Bytes modulus(len, '\0');
+    for (size_t i{0}; i < len; ++i) {
+        base[i] = static_cast<uint8_t>(i * 7 + 1);
+        modulus[i] = static_cast<uint8_t>(0xff - i * 3);
+    }
+    modulus.back() |= 1;
+    Bytes exponent{short_exponent ? from_hex("010001") : Bytes(len, '\xa5')};
+
+    Bytes in(3 * 32, '\0');
+    in[31] = static_cast<uint8_t>(len);
+    in[30] = static_cast<uint8_t>(len >> 8);
+    in[63] = static_cast<uint8_t>(exponent.length());
+    in[62] = static_cast<uint8_t>(exponent.length() >> 8);
+    in[95] = static_cast<uint8_t>(len);
+    in[94] = static_cast<uint8_t>(len >> 8);
+    return in + base + exponent + modulus;
+}
+
+static void expmod(benchmark::State& state, bool short_exponent) {
+    using namespace silkworm;
+    Bytes in{expmod_input(static_cast<size_t>(state.range(0)), short_exponent)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(precompiled::expmod_run(in));
+    }
+}
+
+// Same computation through boost::multiprecision::powm, as expmod_run used to do
+static void expmod_generic(benchmark::State& state, bool short_exponent) {
+    using namespace silkworm;
+    Bytes in{expmod_input(static_cast<size_t>(state.range(0)), short_exponent)};
+    const size_t len{static_cast<size_t>(state.range(0)) / 8};
+    const size_t exponent_len{short_exponent ? 3 : len};
+    ByteView base{ByteView{in}.substr(3 * 32, len)};
+    ByteView exponent{ByteView{in}.substr(3 * 32 + len, exponent_len)};
+    ByteView modulus{ByteView{in}.substr(3 * 32 + len + exponent_len)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(modexp_generic(base, exponent, modulus));
+    }
+}
+
+BENCHMARK_CAPTURE(expmod, verify, true)->Arg(1024)->Arg(2048)->Arg(4096);
+BENCHMARK_CAPTURE(expmod_generic, verify, true)->Arg(1024)->Arg(2048)->Arg(4096);
+BENCHMARK_CAPTURE(expmod, sign, false)->Arg(1024)->Arg(2048)->Arg(4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(expmod_generic, sign, false)->Arg(1024)->Arg(2048)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+static void sha256(benchmark::State& state) {
+    using namespace silkworm;
+    Bytes in(static_cast<size_t>(state.range(0)), '\xa5');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(precompiled::sha256_run(in));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(sha256)->Arg(32)->Arg(1024);
+
+static void rip160(benchmark::State& state) {
+    using namespace silkworm;
+    Bytes in(static_cast<size_t>(state.range(0)), '\xa5');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(precompiled::rip160_run(in));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(rip160)->Arg(32)->Arg(1024);
+
+// Vector 5 of EIP-152 with state.range(0) rounds
+static void blake2_f(benchmark::State& state) {
+    using namespace silkworm;
+    Bytes in{from_hex(
+        "0000000c48c9bdf267e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5d182e6ad7f520e511f6c"
+        "3e2b8c68059b6bbd41fbabd9831f79217e1319cde05b616263000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+        "0000000000000000000000000300000000000000000000000000000001")};
+    const auto rounds{static_cast<uint32_t>(state.range(0))};
+    in[0] = static_cast<uint8_t>(rounds >> 24);
+    in[1] = static_cast<uint8_t>(rounds >> 16);
+    in[2] = static_cast<uint8_t>(rounds >> 8);
+    in[3] = static_cast<uint8_t>(rounds);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(precompiled::blake2_f_run(in));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same rounds through blake2b-ref.c, as blake2_f_run used to do
+static void blake2_f_reference(benchmark::State& state) {
+    blake2b_state s{};
+    uint8_t block[BLAKE2B_BLOCKBYTES]{'a', 'b', 'c'};
+    const auto rounds{static_cast<size_t>(state.range(0))};
+    for (auto _ : state) {
+        blake2b_compress(&s, block, rounds);
+        benchmark::DoNotOptimize(s.h);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(blake2_f)->Arg(12)->Arg(1'000)->Arg(1'000'000);
+BENCHMARK(blake2_f_reference)->Arg(12)->Arg(1'000)->Arg(1'000'000);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/receipt.hpp>
+#include <silkworm/types/transaction.hpp>
+#include <vector>
+
+// A block's worth of receipts, each with a couple of ERC-20 Transfer-like logs
+static std::vector<silkworm::Receipt> sample_receipts() {
+    using namespace silkworm;
+    std::vector<Receipt> receipts(200);
+    for (size_t i{0}; i < receipts.size(); ++i) {
+        Receipt& r{receipts[i]};
+        r.success = true;
+        r.cumulative_gas_used = 21'000 * (i + 1);
+        r.bloom[i % kBloomByteLength] = 0xff;
+        for (size_t j{0}; j < 2; ++j) {
+            Log& log{r.logs.emplace_back()};
+            log.address = 0xa0b86991c6218b36c1d19d4a2e9eb0ce3606eb48_address;
+            log.topics.resize(3);
+            log.topics[0].bytes[0] = static_cast<uint8_t>(j);
+            log.topics[1].bytes[31] = static_cast<uint8_t>(i);
+            log.data = Bytes(32, static_cast<uint8_t>(i));
+        }
+    }
+    return receipts;
+}
+
+static std::vector<silkworm::Transaction> sample_transactions() {
+    using namespace silkworm;
+    std::vector<Transaction> transactions(200);
+    for (size_t i{0}; i < transactions.size(); ++i) {
+        Transaction& txn{transactions[i]};
+        txn.nonce = 172339 + i;
+        txn.gas_price = 50 * kGiga;
+        txn.gas_limit = 90'000;
+        txn.to = 0xe5ef458d37212a06e3f59d40c454e76150ae7c32_address;
+        txn.value = 1'027'501'080 * kGiga;
+        txn.data = Bytes(68, static_cast<uint8_t>(i));
+        txn.v = 37;
+        txn.r = intx::from_string<intx::uint256>("0x48b55bfa915ac795c431978d8a6a992b628d557da5ff759b307d495a36649353");
+        txn.s = intx::from_string<intx::uint256>("0x1fffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804");
+    }
+    return transactions;
+}
+
+// Each item into a fresh Bytes, as for DB values
+template <class T>
+static void rlp_append(benchmark::State& state, const std::vector<T>& items) {
+    using namespace silkworm;
+    size_t bytes{0};
+    for (auto _ : state) {
+        for (const T& x : items) {
+            Bytes rlp{};
+            rlp::encode(rlp, x);
+            bytes += rlp.length();
+            benchmark::DoNotOptimize(rlp.data());
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * items.size());
+}
+
+// Each item into the same buffer, as for trie leaves
+template <class T>
+static void rlp_append_reused(benchmark::State& state, const std::vector<T>& items) {
+    using namespace silkworm;
+    size_t bytes{0};
+    Bytes rlp{};
+    for (auto _ : state) {
+        for (const T& x : items) {
+            rlp.clear();
+            rlp::encode(rlp, x);
+            bytes += rlp.length();
+            benchmark::DoNotOptimize(rlp.data());
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * items.size());
+}
+
+// Each item into the same preallocated buffer through a SpanWriter, as into an arena or an MDB_RESERVE'd value
+template <class T>
+static void rlp_span(benchmark::State& state, const std::vector<T>& items) {
+    using namespace silkworm;
+    size_t bytes{0};
+    Bytes buffer(64 * 1024, '\0');
+    for (auto _ : state) {
+        for (const T& x : items) {
+            const size_t length{rlp::length(x)};
+            rlp::SpanWriter writer{buffer.data(), length};
+            rlp::encode(writer, x);
+            bytes += length;
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * items.size());
+}
+
+BENCHMARK_CAPTURE(rlp_append, receipts, sample_receipts());
+BENCHMARK_CAPTURE(rlp_append_reused, receipts, sample_receipts());
+BENCHMARK_CAPTURE(rlp_span, receipts, sample_receipts());
+
+BENCHMARK_CAPTURE(rlp_append, transactions, sample_transactions());
+BENCHMARK_CAPTURE(rlp_append_reused, transactions, sample_transactions());
+BENCHMARK_CAPTURE(rlp_span, transactions, sample_transactions());
+
+BENCHMARK_MAIN();
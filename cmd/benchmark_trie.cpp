@@ -0,0 +1,56 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <silkworm/trie/hash_builder.hpp>
+
+// Root of num_leaves random 32-byte keys with account-sized values.
+// Keys are generated in order on the fly: the top 8 bytes of key i are drawn at random from the i-th of num_leaves
+// equal slices of the key space, which keeps the input out of memory while giving it the shape of a random trie.
+static void trie_root(benchmark::State& state) {
+    using namespace silkworm;
+
+    const auto num_leaves{static_cast<uint64_t>(state.range(0))};
+    const uint64_t slice{UINT64_MAX / num_leaves};
+
+    for (auto _ : state) {
+        std::mt19937_64 rng{42};
+        trie::HashBuilder hb;
+        uint8_t key[kHashLength];
+        uint8_t value[70];
+        for (uint64_t i{0}; i < num_leaves; ++i) {
+            uint64_t prefix{i * slice + rng() % slice};
+            for (size_t j{0}; j < 8; ++j) {
+                key[j] = static_cast<uint8_t>(prefix >> (56 - 8 * j));
+            }
+            for (size_t j{8}; j < kHashLength; ++j) {
+                key[j] = static_cast<uint8_t>(rng());
+            }
+            for (uint8_t& b : value) {
+                b = static_cast<uint8_t>(rng());
+            }
+            hb.add({key, kHashLength}, {value, sizeof(value)});
+        }
+        benchmark::DoNotOptimize(hb.root_hash());
+    }
+    state.SetItemsProcessed(state.iterations() * num_leaves);
+}
+
+BENCHMARK(trie_root)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
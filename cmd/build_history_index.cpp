@@ -0,0 +1,70 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/history_index_builder.hpp>
+#include <silkworm/db/util.hpp>
+
+int main(int argc, char* argv[]) {
+    using namespace silkworm;
+
+    CLI::App app{"Build account & storage history indices from plain change sets"};
+
+    std::string db_path{db::default_path()};
+    app.add_option("--datadir", db_path, "Path to chain db", true)->check(CLI::ExistingDirectory);
+
+    uint64_t to_block{std::numeric_limits<uint64_t>::max()};
+    app.add_option("--to", to_block, "Index blocks up to (inclusive); defaults to execution progress");
+
+    size_t memory_mib{256};
+    app.add_option("--memory_mib", memory_mib, "Memory budget in mebibytes for sorting before spilling to disk", true)
+        ->check(CLI::Range(1u, 1u << 20));
+
+    CLI11_PARSE(app, argc, argv);
+
+    try {
+        lmdb::DatabaseConfig db_config{db_path};
+        db_config.set_readonly(false);
+        std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+        std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+
+        to_block = std::min(to_block, db::read_stage_progress(*txn, db::kExecutionStage).value_or(0));
+
+        for (bool storage : {false, true}) {
+            const char* stage{storage ? db::kStorageHistoryIndexStage : db::kAccountHistoryIndexStage};
+            uint64_t from_block{db::read_stage_progress(*txn, stage).value_or(0) + 1};
+            if (from_block > to_block) {
+                std::clog << stage << " is up to date" << std::endl;
+                continue;
+            }
+
+            db::build_history_index(*txn, storage, from_block, to_block + 1, memory_mib << 20);
+            db::write_stage_progress(*txn, stage, to_block);
+            std::clog << stage << ": blocks [" << from_block << "; " << to_block << "] indexed" << std::endl;
+        }
+
+        lmdb::err_handler(txn->commit());
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -22,6 +22,8 @@
 
 #include <iostream>
 #include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/tables.hpp>
+#include <silkworm/db/util.hpp>
 #include <silkworm/execution/execution.hpp>
 
 using namespace evmc::literals;
@@ -62,6 +64,9 @@ int main(int argc, char* argv[]) {
     const uint64_t from{absl::GetFlag(FLAGS_from)};
     const uint64_t to{absl::GetFlag(FLAGS_to)};
 
+    db::HistoryCache history_cache;
+    db::HistoricalState state{*env->begin_ro_transaction(), from, /*window_size=*/64, &history_cache};
+
     uint64_t block_num{from};
     for (; block_num < to; ++block_num) {
         std::unique_ptr<lmdb::Transaction> txn{env->begin_ro_transaction()};
@@ -71,41 +76,43 @@ int main(int argc, char* argv[]) {
             break;
         }
 
-        db::Buffer buffer{txn.get(), block_num};
+        db::Buffer buffer{txn.get(), state};
 
         execute_block(bh->block, buffer);
 
-        std::optional<db::AccountChanges> db_account_changes{db::read_account_changes(*txn, block_num)};
-        if (buffer.account_changes() != db_account_changes) {
-            bool mismatch{false};
-            if (db_account_changes) {
-                for (const auto& e : *db_account_changes) {
-                    if (buffer.account_changes().count(e.first) == 0) {
-                        if (!kPhantomAccounts.contains(e.first)) {
-                            std::cerr << to_hex(e.first) << " is missing\n";
-                            mismatch = true;
-                        }
-                    } else if (Bytes val{buffer.account_changes().at(e.first)}; val != e.second) {
-                        std::cerr << "Value mismatch for " << to_hex(e.first) << ":\n";
-                        std::cerr << to_hex(val) << "\n";
-                        std::cerr << "vs DB\n";
-                        std::cerr << to_hex(e.second) << "\n";
-                        mismatch = true;
-                    }
-                }
-                for (const auto& e : buffer.account_changes()) {
-                    if (db_account_changes->count(e.first) == 0) {
-                        std::cerr << to_hex(e.first) << " is not in DB\n";
+        auto account_change_table{txn->open(db::table::kPlainAccountChangeSet)};
+        std::optional<ByteView> db_account_changes{account_change_table->get(db::encode_timestamp(block_num))};
+        db::AccountChanges calculated_account_changes{buffer.account_changes()};
+        bool mismatch{false};
+        if (db_account_changes) {
+            db::AccountChangeSetView db_view{*db_account_changes};
+            for (const db::AccountChangeSetView::Entry& e : db_view) {
+                evmc::address address{to_address(e.address)};
+                if (calculated_account_changes.count(address) == 0) {
+                    if (!kPhantomAccounts.contains(address)) {
+                        std::cerr << to_hex(address) << " is missing\n";
                         mismatch = true;
                     }
+                } else if (Bytes val{calculated_account_changes.at(address)}; val != e.value) {
+                    std::cerr << "Value mismatch for " << to_hex(address) << ":\n";
+                    std::cerr << to_hex(val) << "\n";
+                    std::cerr << "vs DB\n";
+                    std::cerr << to_hex(e.value) << "\n";
+                    mismatch = true;
                 }
-            } else {
-                std::cerr << "Nil DB account changes\n";
-                mismatch = true;
             }
-            if (mismatch) {
-                std::cerr << "Account change mismatch for block " << block_num << " 😲\n";
+            for (const auto& e : calculated_account_changes) {
+                if (!db_view.find(full_view(e.first))) {
+                    std::cerr << to_hex(e.first) << " is not in DB\n";
+                    mismatch = true;
+                }
             }
+        } else {
+            std::cerr << "Nil DB account changes\n";
+            mismatch = true;
+        }
+        if (mismatch) {
+            std::cerr << "Account change mismatch for block " << block_num << " 😲\n";
         }
 
         Bytes db_storage_changes{db::read_storage_changes(*txn, block_num)};
@@ -120,10 +127,14 @@ int main(int argc, char* argv[]) {
             std::cerr << to_hex(db_storage_changes) << "\n";
         }
 
+        state.advance(*txn);
+
         if (block_num % 1000 == 0) {
             absl::Time t2{absl::Now()};
+            const db::HistoryCacheStats& stats{history_cache.stats()};
             std::cout << t2 << " Checked blocks ≤ " << block_num << " in " << absl::ToDoubleSeconds(t2 - t1) << " s"
-                      << std::endl;
+                      << " (history cache hit rates: index " << stats.index_hit_rate() << ", change sets "
+                      << stats.change_set_hit_rate() << ")" << std::endl;
             t1 = t2;
         }
     }
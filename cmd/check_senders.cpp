@@ -15,23 +15,22 @@
 */
 
 #include <CLI/CLI.hpp>
+#include <algorithm>
 #include <atomic>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/endian/conversion.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/mapped_region.hpp>
-#include <boost/signals2.hpp>
-#include <condition_variable>
 #include <csignal>
 #include <ethash/keccak.hpp>
 #include <iostream>
-#include <queue>
 #include <regex>
 #include <silkworm/chain/config.hpp>
-#include <silkworm/common/worker.hpp>
-#include <silkworm/crypto/ecdsa.hpp>
+#include <silkworm/common/thread_pool.hpp>
+#include <silkworm/crypto/keccak.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/sender_recovery.hpp>
 #include <silkworm/db/tables.hpp>
 #include <silkworm/db/util.hpp>
 #include <silkworm/types/block.hpp>
@@ -41,19 +40,17 @@
 namespace bfs = boost::filesystem;
 using namespace silkworm;
 
-std::atomic_bool should_stop_{false};           // Request for stop from user or OS
-std::atomic_bool main_thread_error_{false};     // Error detected in main thread
-std::atomic_bool workers_thread_error_{false};  // Error detected in one of workers threads
+std::atomic_bool should_stop_{false};        // Request for stop from user or OS
+std::atomic_bool main_thread_error_{false};  // Error detected in main thread
 
 struct app_options_t {
     std::string datadir{};          // Provided database path
     uint64_t mapsize{0};            // Provided lmdb map size
     uint32_t numthreads{1};         // Number of recovery threads to start
-    size_t batch_size{10'000};      // Number of work packages to serve e worker
+    size_t batch_size{10'000};      // Number of transactions to hand over to recovery threads at once
     uint32_t block_from{1u};        // Initial block number to start from
     uint32_t block_to{UINT32_MAX};  // Final block number to process
     bool replay{false};             // Whether to replay already extracted senders
-    bool debug{false};              // Whether to display some debug info
     bool rundry{false};             // Runs in dry mode (no data is persisted on disk)
 };
 
@@ -114,194 +111,6 @@ std::optional<uint64_t> parse_size(const std::string& strsize) {
     }
 }
 
-class Recoverer : public silkworm::Worker {
-   public:
-    Recoverer(uint32_t id, size_t size, bool debug) : id_(id), debug_{debug}, mysize_{size} {};
-
-    struct package {
-        uint64_t blockNum;
-        ethash::hash256 messageHash;
-        uint8_t recoveryId;
-        intx::uint256 r;
-        intx::uint256 s;
-    };
-
-    // Provides a container of packages to process
-    void set_work(uint32_t batch_id, std::vector<package>& packages) {
-        std::unique_lock l{mywork_};
-        std::swap(packages_, packages);
-        current_batch_id_ = batch_id;
-    }
-
-    // Returns whether or not this worker is busy
-    bool is_busy() { return busy_.load(); }
-
-    // Pulls results from worker
-    std::vector<std::pair<uint64_t, MDB_val>>& get_results(void) { return myresults_; };
-
-    // Signal to connected handlers the task has completed
-    boost::signals2::signal<void(uint32_t sender_id, uint32_t batch_id, bool has_error)> signal_completed;
-
-   private:
-    uint32_t id_;                                            // Current worker identifier
-    bool debug_;                                             // Whether or not display debug info
-    std::atomic_bool busy_{false};                           // Whether the thread is busy processing
-    mutable std::mutex mywork_;                              // Work mutex
-    std::vector<package> packages_{};                        // Work packages to process
-    uint32_t current_batch_id_{0};                           // Identifier of the batch being processed
-    size_t mysize_;                                          // Size of the recovery data
-    uint8_t* mydata_{nullptr};                               // Pointer to data where rsults are stored
-    std::vector<std::pair<uint64_t, MDB_val>> myresults_{};  // Results per block pointing to data area
-
-    // Basic work loop (overrides Worker::work())
-    void work() final {
-        bool recovery_error_{false};
-
-        // Try allocate enough memory to store
-        // results output
-        mydata_ = static_cast<uint8_t*>(std::calloc(1, mysize_));
-        if (!mydata_) {
-            throw std::runtime_error("Unable to allocate memory");
-        }
-
-        while (!should_stop()) {
-            bool expectedKick{true};
-            if (!kicked_.compare_exchange_strong(expectedKick, false, std::memory_order_relaxed)) {
-                std::unique_lock l(xwork_);
-                kicked_signal_.wait_for(l, std::chrono::seconds(1));
-                continue;
-            }
-
-            if (debug_) {
-                std::cout << format_time() << " DBG : worker #" << id_ << " started batch #" << current_batch_id_
-                          << std::endl;
-            };
-
-            busy_.store(true);
-            {
-                // Lock mutex so no other jobs may be set
-                std::unique_lock l{mywork_};
-                myresults_.clear();
-
-                Bytes signature(64, '\0');
-                uint64_t current_block{packages_.at(0).blockNum};
-                size_t block_result_offset{0};
-                size_t block_result_length{0};
-
-                // Loop
-                for (size_t x{0}; x < packages_.size() && !recovery_error_; x++) {
-                    Recoverer::package rp = packages_.at(x);
-
-                    // On block switching store the results
-                    if (current_block != rp.blockNum) {
-                        MDB_val result{block_result_length, (void*)&mydata_[block_result_offset]};
-                        myresults_.push_back({current_block, result});
-                        block_result_offset += block_result_length;
-                        block_result_length = 0;
-                        current_block = rp.blockNum;
-                        if (should_stop_) break;
-                    }
-
-                    // Endianess swap for r and s
-                    for (int i{0}; i < 2; i++) {
-                        std::uint8_t* p = reinterpret_cast<uint8_t*>(i == 0 ? &rp.r.lo : &rp.s.lo);
-                        int offset{i ? 32 : 0};
-                        for (int j{0}; j < 32; j++) {
-                            signature[offset + j] = p[31 - j];
-                        }
-                    }
-
-                    ByteView message{rp.messageHash.bytes, 32};
-                    std::optional<Bytes> key{ecdsa::recover(message, signature, rp.recoveryId)};
-
-                    if (key.has_value() && (int)key->at(0) == 4) {
-                        ethash::hash256 keyHash{ethash::keccak256(key->data() + 1, key->length() - 1)};
-                        std::memcpy(&mydata_[block_result_offset + block_result_length],
-                                    &keyHash.bytes[sizeof(keyHash) - kAddressLength], kAddressLength);
-                        block_result_length += kAddressLength;
-                    } else {
-                        std::cout << format_time() << " Recoverer #" << id_ << " "
-                                  << "Public key recovery failed at block #" << rp.blockNum << std::endl;
-                        recovery_error_ = true;
-                        break;  // No need to process other txns
-                    }
-                }
-
-                // Store results for last block
-                if (block_result_length && !recovery_error_) {
-                    MDB_val result{block_result_length, (void*)&mydata_[block_result_offset]};
-                    myresults_.push_back({current_block, result});
-                }
-
-                // Raise finished event
-                signal_completed(id_, current_batch_id_, recovery_error_);
-                if (debug_) {
-                    std::cout << format_time() << " DBG : worker #" << id_ << " completed batch #" << current_batch_id_
-                              << std::endl;
-                };
-                packages_.clear();  // Clear here. Next set_work will swap the cleaned container to master thread
-            }
-
-            busy_.store(false);
-        }
-
-        std::free(mydata_);
-    };
-};
-
-void process_txs_for_signing(ChainConfig& config, uint64_t block_num, BlockBody& body,
-                             std::vector<Recoverer::package>& packages) {
-    for (const silkworm::Transaction& txn : body.transactions) {
-        if (!silkworm::ecdsa::is_valid_signature(txn.r, txn.s, config.has_homestead(block_num))) {
-            throw std::runtime_error("Got invalid signature in tx for block number " + std::to_string(block_num));
-        }
-
-        ecdsa::RecoveryId x{ecdsa::get_signature_recovery_id(txn.v)};
-
-        Bytes rlp{};
-        if (x.eip155_chain_id) {
-            if (!config.has_spurious_dragon(block_num)) {
-                throw std::runtime_error("EIP-155 signature in tx before Spurious Dragon for block number " +
-                                         std::to_string(block_num));
-            } else if (x.eip155_chain_id != config.chain_id) {
-                throw std::runtime_error("Got invalid EIP-155 signature in tx for block number " +
-                                         std::to_string(block_num) + " chain_id : expected " +
-                                         std::to_string(config.chain_id) + " got " +
-                                         intx::to_string(*x.eip155_chain_id));
-            }
-            rlp::encode(rlp, txn, true, {config.chain_id});
-        } else {
-            rlp::encode(rlp, txn, true, {});
-        }
-
-        ethash::hash256 hash{keccak256(rlp)};
-        Recoverer::package rp{block_num, hash, x.recovery_id, txn.r, txn.s};
-        packages.push_back(rp);
-    }
-}
-
-bool start_workers(std::vector<std::unique_ptr<Recoverer>>& workers) {
-    for (size_t r = 0; r < workers.size(); r++) {
-        std::cout << format_time() << " Starting worker thread #" << r << std::endl;
-        workers.at(r)->start();
-        // Wait for thread to init properly
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-        if (workers.at(r)->get_state() != Worker::WorkerState::kStarted) {
-            return false;
-        }
-    }
-    return true;
-}
-
-void stop_workers(std::vector<std::unique_ptr<Recoverer>>& workers, bool wait) {
-    for (size_t r = 0; r < workers.size(); r++) {
-        if (workers.at(r)->get_state() == Worker::WorkerState::kStarted) {
-            std::cout << format_time() << " Stopping worker thread #" << r << std::endl;
-            workers.at(r)->stop(wait);
-        }
-    }
-}
-
 std::optional<uint64_t> get_highest_canonical_header(std::unique_ptr<lmdb::Table>& headers) {
     size_t count{0};
     lmdb::err_handler(headers->get_rcount(&count));
@@ -322,155 +131,15 @@ std::optional<uint64_t> get_highest_canonical_header(std::unique_ptr<lmdb::Table
     return std::nullopt;
 }
 
-uint64_t load_canonical_headers(std::unique_ptr<lmdb::Table>& headers, uint64_t from, uint64_t to, evmc::bytes32* out) {
-    uint64_t retvar{0};
-
-    // Locate starting canonical block selected
-    // and navigate headers
-    MDB_val key, data;
-    Bytes header_key(9, 'n');
-    boost::endian::store_big_u64(&header_key[0], from);
-    key.mv_data = (void*)&header_key[0];
-    key.mv_size = header_key.length();
-
-    uint32_t percent{0};
-    uint32_t percent_step{5};  // 5% increment among batches
-    size_t batch_size{(to - from + 1) / (100 / percent_step)};
-
-    std::cout << format_time() << " Locating canonical header at height " << from << std::endl;
-    bool eof{false};
-    int rc{headers->seek_exact(&key, &data)};
-    if (!rc) std::cout << format_time() << " Scanning canonical headers ... " << std::endl;
-    while (!should_stop_ && !eof && rc == MDB_SUCCESS) {
-        // Canonical header key is 9 bytes (8 blocknumber + 'n')
-        if (key.mv_size == header_key.length()) {
-            ByteView v{static_cast<uint8_t*>(key.mv_data), key.mv_size};
-            if (v[8] == 'n') {
-                uint64_t header_block = boost::endian::load_big_u64(&v[0]);
-                if (header_block > to) {
-                    eof = true;
-                } else {
-                    memcpy((void*)&out[header_block - from], data.mv_data, kHashLength);
-                    retvar++;
-                    batch_size--;
-                }
-            }
-
-            if (!batch_size) {
-                batch_size = (to - from + 1) / (100 / percent_step);
-                percent += percent_step;
-                std::cout << format_time() << " ... " << std::right << std::setw(3) << std::setfill(' ') << percent
-                          << " %" << std::endl;
-            }
-        }
-        if (!eof) rc = headers->get_next(&key, &data);
-    }
-
-    return (should_stop_ ? 0 : retvar);
-}
-
-// Writes batch results to db
-size_t write_results(std::queue<std::pair<uint32_t, uint32_t>>& batches, std::mutex& batches_mtx,
-                     std::vector<std::unique_ptr<Recoverer>>& workers, evmc::bytes32* headers,
-                     std::unique_ptr<lmdb::Table>& senders, uint64_t initial_block) {
-    size_t ret{0};
-    std::vector<std::pair<uint64_t, MDB_val>> results{};
-
-    do {
-        // Loop all completed batches until queue
-        // empty. Other batches may complete while
-        // writing of batch is in progress
-        std::unique_lock l{batches_mtx};
-        if (batches.empty()) break;
-        std::pair<uint32_t, uint32_t> item{batches.front().first, batches.front().second};
-        batches.pop();
-        l.unlock();
-
-        // Pull result from proper worker
-        std::swap(results, workers.at(item.first)->get_results());
-
-        // Append results to senders table
-        Bytes senders_key(40, '\0');
-        MDB_val key{40, (void*)&senders_key[0]};
-        for (auto& result : results) {
-            boost::endian::store_big_u64(&senders_key[0], result.first);
-            memcpy((void*)&senders_key[8], (void*)&headers[result.first - initial_block], kHashLength);
-            lmdb::err_handler(senders->put_append(&key, &result.second));
-            ret += (key.mv_size + result.second.mv_size);
-        }
-        results.clear();
-
-    } while (true);
-
-    return ret;
-}
-
 // Executes the recovery stage
 int do_recover(app_options_t& options) {
     std::shared_ptr<lmdb::Environment> lmdb_env{nullptr};  // Main lmdb environment
     std::unique_ptr<lmdb::Transaction> lmdb_txn{nullptr};  // Main lmdb transaction
-    std::unique_ptr<lmdb::Table> lmdb_headers{nullptr};    // Block headers table
-    std::unique_ptr<lmdb::Table> lmdb_bodies{nullptr};     // Block bodies table
-    std::unique_ptr<lmdb::Table> lmdb_senders{nullptr};    // Transaction senders table
     ChainConfig config{kMainnetConfig};                    // Main net config flags
-    evmc::bytes32* canonical_headers{nullptr};             // Storage space for canonical headers
-    uint64_t canonical_headers_count{0};                   // Overall number of canonical headers collected
-    std::vector<Recoverer::package> recoverPackages{};     // Where to store work packages for recoverers
-
-    uint32_t next_batch_id{0};                   // Batch identifier sent to recoverer thread
-    size_t batch_size{0};                        // Progressive number of delivered work
-    std::atomic<uint32_t> expected_batch_id{0};  // Holder of queue flushing order
-    std::queue<std::pair<uint32_t, uint32_t>>
-        batches_completed{};           // Queue of batches completed waiting to be written on disk
-    std::mutex batches_completed_mtx;  // Guards the queue
-    size_t bytes_written{0};           // Total bytes written
-
-    uint32_t next_worker_id{0};                  // Used to serialize the dispatch of works to threads
-    std::atomic<uint32_t> workers_in_flight{0};  // Number of workers in flight
-    uint64_t total_transactions{0};              // Overall number of transactions processed
-
-    // Recoverer's signal handlers
-    boost::function<void(uint32_t, uint32_t, bool)> finishedHandler =
-        [&expected_batch_id, &batches_completed, &batches_completed_mtx, &workers_in_flight](
-            uint32_t sender_id, uint32_t batch_id, bool has_error) {
-            // Ensure threads flush in the right order to preserve key sorting
-            // Threads waits for its ticket before flushing
-            while (expected_batch_id.load(std::memory_order_relaxed) != batch_id) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            }
+    uint64_t last_block{0};                                // Last block processed
 
-            // Store error condition if applicabile
-            if (has_error) workers_thread_error_.store(true);
-
-            // Save my ids in the queue of results to
-            // store in db
-            std::unique_lock l{batches_completed_mtx};
-            std::pair<uint32_t, uint32_t> item{sender_id, batch_id};
-            batches_completed.push(item);
-
-            // Ready to serve next thread
-            expected_batch_id++;
-            workers_in_flight--;
-        };
-
-    // Each recoverer will allocate enough
-    // storage space to hold results for
-    // a full batch. Worker object is not copyable
-    // thus the need of a unique_ptr.
-    std::vector<std::unique_ptr<Recoverer>> recoverers_{};
-    for (uint32_t i = 0; i < options.numthreads; i++) {
-        auto worker = std::make_unique<Recoverer>(i, (options.batch_size * kAddressLength), options.debug);
-        worker->signal_completed.connect(boost::bind(finishedHandler, _1, _2, _3));
-        recoverers_.push_back(std::move(worker));
-    }
-
-    // Start recoverers (here occurs allocation)
-    if (!start_workers(recoverers_)) {
-        std::cout << format_time() << " Unable to start required recoverers" << std::endl;
-        stop_workers(recoverers_, true);
-        recoverers_.clear();
-        return -1;
-    }
+    // Blocks to process before checking for a stop request
+    constexpr uint64_t kBlocksPerStep{100'000};
 
     try {
         // Open db and start transaction
@@ -479,9 +148,9 @@ int do_recover(app_options_t& options) {
         db_config.map_size = options.mapsize;
         lmdb_env = lmdb::get_env(db_config);
         lmdb_txn = lmdb_env->begin_rw_transaction();
-        lmdb_senders = lmdb_txn->open(db::table::kSenders, MDB_CREATE);  // Throws on error
-        lmdb_headers = lmdb_txn->open(db::table::kBlockHeaders);         // Throws on error
-        lmdb_bodies = lmdb_txn->open(db::table::kBlockBodies);           // Throws on error
+        std::unique_ptr<lmdb::Table> lmdb_senders{lmdb_txn->open(db::table::kSenders, MDB_CREATE)};  // Throws on error
+        std::unique_ptr<lmdb::Table> lmdb_headers{lmdb_txn->open(db::table::kBlockHeaders)};        // Throws on error
+        std::unique_ptr<lmdb::Table> lmdb_bodies{lmdb_txn->open(db::table::kBlockBodies)};          // Throws on error
 
         size_t rcount{0};
 
@@ -521,8 +190,6 @@ int do_recover(app_options_t& options) {
                     if (options.block_from == 1u) {
                         std::cout << format_time() << " Clearing senders table ... " << std::endl;
                         lmdb::err_handler(lmdb_senders->clear());
-                        lmdb_senders.reset();
-                        lmdb_senders = lmdb_txn->open(db::table::kSenders, MDB_CREATE);
                     } else {
                         // Delete all senders records with key >= po_from_block
                         std::cout << format_time() << " Deleting senders table from block " << options.block_from
@@ -560,6 +227,11 @@ int do_recover(app_options_t& options) {
             }
         }
 
+        // Tables are reopened by the recovery stage
+        lmdb_senders.reset();
+        lmdb_headers.reset();
+        lmdb_bodies.reset();
+
         std::cout << format_time() << " Processing transactions from block " << options.block_from << " to block "
                   << options.block_to << std::endl;
         if (options.block_from > options.block_to) {
@@ -567,160 +239,19 @@ int do_recover(app_options_t& options) {
             throw std::logic_error("No valid block range selected. Aborting");
         }
 
-        // Try allocate enough memory space to fit all cananonical header hashes
-        // which need to be processed
-        {
-            void* mem{std::calloc((size_t)(options.block_to - options.block_from) + 1, kHashLength)};
-            if (!mem) {
-                // not enough space to store all
-                throw std::runtime_error("Can't allocate enough memory for headers");
-            }
-            canonical_headers = static_cast<evmc::bytes32*>(mem);
-        }
-
-        // Scan headers table to collect all canonical headers
-        canonical_headers_count =
-            load_canonical_headers(lmdb_headers, options.block_from, options.block_to, canonical_headers);
-        if (!canonical_headers_count) {
-            // Nothing to process
-            throw std::logic_error("No canonical headers collected.");
-        }
-        std::cout << format_time() << " Collected " << canonical_headers_count << " canonical headers" << std::endl;
-
-        {
-            MDB_val key, data;
-
-            // Set to first key which is initial block number
-            // plus canonical hash
-
-            uint64_t current_block{options.block_from};
-            uint64_t detected_block{0};
-            size_t header_index{0};
-
-            Bytes block_key(40, '\0');
-            boost::endian::store_big_u64(&block_key[0], current_block);
-            memcpy((void*)&block_key[8], (void*)&canonical_headers[0], kHashLength);
-            key.mv_data = (void*)&block_key[0];
-            key.mv_size = block_key.length();
-
-            std::cout << format_time() << " Scanning bodies ... " << std::endl;
-            int rc{lmdb_bodies->seek_exact(&key, &data)};
-            lmdb::err_handler(rc);
-
-            while (!should_stop_) {
-                ByteView v{static_cast<uint8_t*>(key.mv_data), key.mv_size};
-                detected_block = boost::endian::load_big_u64(&v[0]);
-                if (detected_block > current_block) {
-                    // We assume keys in block bodies are properly sorted
-                    throw std::runtime_error("Bad block body sequence. Expected " + std::to_string(current_block) +
-                                             " got " + std::to_string(detected_block));
-                }
-                if (memcmp((void*)&v[8], (void*)&canonical_headers[header_index], 32) != 0) {
-                    // We stumbled into a non canonical block (not matching header)
-                    // move next and repeat
-                    rc = lmdb_bodies->get_next(&key, &data);
-                    if (rc) {
-                        if (rc == MDB_NOTFOUND) break;  // Reached the end of records for bodies table
-                        lmdb::err_handler(rc);          // Something bad happened
-                    }
-                }
-
-                // We get here with a matching block number + header
-                // Process it if not empty (ie 0 transactions and 0 ommers)
-                if (data.mv_size > 3) {
-                    // Actually rlp-decoding the whole block adds a
-                    // little overhead as transactions are decoded as
-                    // well as ommers which actually are not needed
-                    // in this scope. Worth optimize it ?
-                    ByteView bv{static_cast<uint8_t*>(data.mv_data), data.mv_size};
-                    BlockBody body{};
-                    rlp::decode(bv, body);
-
-                    // Should we overflow the batch queue dispatch the work
-                    // accumulated so far to the recoverer thread
-                    if ((batch_size + body.transactions.size()) > options.batch_size) {
-                        // If all workers busy no other option than to wait for
-                        // at least one free slot
-                        while (workers_in_flight == options.numthreads) {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                        }
-
-                        // Throw if any error from workers
-                        if (workers_thread_error_) throw std::runtime_error("Error from worker thread");
-
-                        // Write results to db (if any)
-                        bytes_written += write_results(batches_completed, batches_completed_mtx, recoverers_,
-                                                       canonical_headers, lmdb_senders, options.block_from);
-
-                        // Dispatch new task to worker
-                        total_transactions += recoverPackages.size();
-                        recoverers_.at(next_worker_id)->set_work(next_batch_id++, recoverPackages);
-                        recoverers_.at(next_worker_id)->kick();
-                        workers_in_flight++;
-                        batch_size = 0;
-
-                        std::cout << format_time() << " Block " << std::right << std::setw(9) << std::setfill(' ')
-                                  << current_block << " Transactions " << std::right << std::setw(12)
-                                  << std::setfill(' ') << total_transactions << " Workers " << workers_in_flight << "/"
-                                  << options.numthreads << std::endl;
-
-                        if (++next_worker_id == options.numthreads) {
-                            next_worker_id = 0;
-                        }
-                    }
-
-                    // Enqueue Txs in current batch
-                    process_txs_for_signing(config, current_block, body, recoverPackages);
-                    batch_size += body.transactions.size();
-                }
-
-                // After processing move to next block number and header
-                if (++header_index == canonical_headers_count) {
-                    // We'd go beyond collected canonical headers
-                    break;
-                }
-                rc = lmdb_bodies->get_next(&key, &data);
-                if (rc) {
-                    if (rc == MDB_NOTFOUND) break;  // Reached the end of records for bodies table
-                    lmdb::err_handler(rc);          // Something bad happened
-                }
-                ++current_block;
+        ThreadPool pool{options.numthreads};
+        for (uint64_t from{options.block_from}; from <= options.block_to && !should_stop_; from = last_block + 1) {
+            uint64_t to{std::min<uint64_t>(from + kBlocksPerStep - 1, options.block_to)};
+            std::optional<uint64_t> last{db::recover_senders(*lmdb_txn, config, from, to, pool, options.batch_size)};
+            if (!last) {
+                throw std::logic_error("Can't locate canonical block #" + std::to_string(from));
             }
-
-            // Should we have a partially filled work package deliver it now
-            if (batch_size && !should_stop_) {
-                // If all workers busy no other option than to wait for
-                // at least one free slot
-                while (workers_in_flight == options.numthreads) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                }
-
-                // Throw if any error from workers
-                if (workers_thread_error_) throw std::runtime_error("Error from worker thread");
-
-                // Write results to db (if any)
-                bytes_written += write_results(batches_completed, batches_completed_mtx, recoverers_, canonical_headers,
-                                               lmdb_senders, options.block_from);
-
-                total_transactions += recoverPackages.size();
-                recoverers_.at(next_worker_id)->set_work(next_batch_id, recoverPackages);
-                recoverers_.at(next_worker_id)->kick();
-                workers_in_flight++;
-                batch_size = 0;
-
-                std::cout << format_time() << " Block " << std::right << std::setw(9) << std::setfill(' ')
-                          << current_block << " Transactions " << std::right << std::setw(12) << std::setfill(' ')
-                          << total_transactions << " Workers " << workers_in_flight << "/" << options.numthreads
-                          << std::endl;
-            }
-
-            // Wait for all workers to complete and write their results
-            while (workers_in_flight != 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            }
-            if (!should_stop_) {
-                bytes_written += write_results(batches_completed, batches_completed_mtx, recoverers_, canonical_headers,
-                                               lmdb_senders, options.block_from);
+            last_block = *last;
+            std::cout << format_time() << " Senders recovered up to block " << std::right << std::setw(9)
+                      << std::setfill(' ') << last_block << std::endl;
+            if (last_block < to) {
+                // Reached the end of bodies
+                break;
             }
         }
 
@@ -735,26 +266,14 @@ int do_recover(app_options_t& options) {
         main_thread_error_ = true;
     } catch (std::runtime_error& ex) {
         // This handles runtime logic errors
-        // eg. trying to open two rw txns
+        // eg. trying to open two rw txns or invalid signatures
         std::cout << format_time() << " Unexpected error : " << ex.what() << std::endl;
         main_thread_error_ = true;
     }
 
-    // Stop all recoverers and close all tables
-    stop_workers(recoverers_, true);
-
-    lmdb_senders.reset();
-    lmdb_headers.reset();
-    lmdb_bodies.reset();
-
-    // free memory
-    if (canonical_headers) {
-        std::free(canonical_headers);
-    }
-
     // Should we commit ?
-    if (!main_thread_error_ && !workers_thread_error_ && !options.rundry && !should_stop_) {
-        std::cout << format_time() << " Committing work ( " << bytes_written << " bytes )" << std::endl;
+    if (!main_thread_error_ && !options.rundry && !should_stop_) {
+        std::cout << format_time() << " Committing work up to block " << last_block << std::endl;
         try {
             lmdb::err_handler(lmdb_txn->commit());
             lmdb::err_handler(lmdb_env->sync());
@@ -824,9 +343,9 @@ int do_verify(app_options_t& options) {
                       << " " << std::left << std::setw(42) << std::setfill('-') << "" << std::endl;
 
             for (size_t i = 0; i < bh->block.transactions.size(); i++) {
-                Bytes rlp{};
-                rlp::encode(rlp, bh->block.transactions.at(i), /*forsigning*/ false, {});
-                ethash::hash256 hash{ethash::keccak256(rlp.data(), rlp.length())};
+                KeccakHasher hasher;
+                rlp::encode(hasher, bh->block.transactions.at(i));
+                ethash::hash256 hash{hasher.finalize()};
                 ByteView bv{hash.bytes, 32};
                 std::cout << std::right << std::setw(4) << std::setfill(' ') << i << " 0x" << to_hex(bv) << " 0x"
                           << to_hex(*(bh->block.transactions.at(i).from)) << " 0x"
@@ -867,7 +386,6 @@ int main(int argc, char* argv[]) {
         ->check(CLI::Range(1u, UINT32_MAX));
     app.add_option("--to", options.block_to, "Final block number to process (inclusive)", true)
         ->check(CLI::Range(1u, UINT32_MAX));
-    app.add_flag("--debug", options.debug, "May print some debug/trace info.");
     app.add_flag("--replay", options.replay, "Replay transactions.");
     app.add_flag("--dry", options.rundry, "Runs the full cycle but nothing is persisted");
 
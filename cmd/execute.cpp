@@ -112,6 +112,10 @@ int main(int argc, char* argv[]) {
     uint64_t batch_mib{512};
     app.add_option("--batch_mib", batch_mib, "Batch size in mebibytes of DB changes to accumulate before committing", true);
 
+    bool validate_bodies{false};
+    app.add_flag("--validate_bodies", validate_bodies,
+                 "Check transactions roots, ommers hashes and logs blooms of the headers on spare cores");
+
     CLI11_PARSE(app, argc, argv);
 
     std::clog << "Starting block execution. DB: " << db_path << std::endl;
@@ -141,10 +145,12 @@ int main(int argc, char* argv[]) {
 
     for (uint64_t block_number{previous_progress + 1}; block_number <= to_block; ++block_number) {
         int lmdb_error_code{MDB_SUCCESS};
-        SilkwormStatusCode status{silkworm_execute_blocks(txn, /*chain_id=*/1, block_number, to_block, batch_size,
-                                                          write_receipts, &current_progress, &lmdb_error_code)};
+        SilkwormStatusCode status{silkworm_execute_blocks_ex(txn, /*chain_id=*/1, block_number, to_block, batch_size,
+                                                             write_receipts, &current_progress, &lmdb_error_code,
+                                                             validate_bodies)};
         if (status != kSilkwormSuccess && status != kSilkwormBlockNotFound) {
-            std::clog << "Error in silkworm_execute_blocks: " << status << ", LMDB: " << lmdb_error_code << std::endl;
+            std::clog << "Error in silkworm_execute_blocks_ex: " << status << ", LMDB: " << lmdb_error_code
+                      << std::endl;
             return status;
         }
 
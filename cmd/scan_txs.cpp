@@ -23,6 +23,7 @@
 #include <boost/filesystem.hpp>
 #include <iostream>
 #include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/reader_pool.hpp>
 #include <silkworm/execution/execution.hpp>
 
 ABSL_FLAG(std::string, datadir, silkworm::db::default_path(), "chain DB path");
@@ -55,20 +56,20 @@ int main(int argc, char* argv[]) {
     std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
     // Note: If TurboGeth is actively syncing its database (syncing), it is important not to create
     // long-running datbase reads transactions even though that may make your processing faster.
-    // Uncomment the following line (and comment the line below) only if you're certain TG is not
-    // running on the same machine.
-    // std::unique_ptr<lmdb::Transaction> txn{env->begin_ro_transaction()};
+    // Readers are therefore leased from a pool once per block: each lease is recycled on the latest
+    // snapshot with mdb_txn_renew, which is much cheaper than beginning a new transaction.
 
     try {
+        lmdb::ReaderPool readers{env, lmdb::ReaderPoolConfig{/*max_readers=*/1}};
+        db::HistoryCache history_cache;
+        db::HistoricalState state{*readers.acquire(), from, /*window_size=*/64, &history_cache};
+
         // counters
         uint64_t nTxs{0}, nErrors{0};
 
         uint64_t block_num{from};
         for (; block_num < to; ++block_num) {
-            // Note: See the comment above. You may uncomment that line and comment the next line if you're certain
-            // that TG is not syncing on the same machine. If you use a long-running transaction by doing this, and
-            // you're mistaken (TG is syncing), the database file may 'grow quickly' as per the LMDB docs.
-            std::unique_ptr<lmdb::Transaction> txn{env->begin_ro_transaction()};
+            lmdb::ReaderPool::Lease txn{readers.acquire()};
 
             // Read the block
             std::optional<BlockWithHash> bh{db::read_block(*txn, block_num, /*read_senders=*/true)};
@@ -76,7 +77,7 @@ int main(int argc, char* argv[]) {
                 break;
             }
 
-            db::Buffer buffer{txn.get(), block_num};
+            db::Buffer buffer{txn.get(), state};
 
             // Execute the block and retreive the receipts
             std::vector<Receipt> receipts = execute_block(bh->block, buffer);
@@ -90,6 +91,8 @@ int main(int argc, char* argv[]) {
                 nErrors += (!receipt.success);
             }
 
+            state.advance(*txn);
+
             // Report and reset counters
             if (!(block_num % 50000)) {
                 std::cout << block_num << "," << nTxs << "," << nErrors << std::endl;
@@ -101,10 +104,13 @@ int main(int argc, char* argv[]) {
                 std::cerr.flush();
             }
 
-            // Note: If per-block database transaction (txn) is being used, it will go out of scope here
-            // and will be reset. No need to explicitly clean up here.
+            // Note: The lease goes out of scope here and its reader is reset and returned to the pool.
         }
 
+        const db::HistoryCacheStats& stats{history_cache.stats()};
+        std::cerr << "History cache hit rates: index " << stats.index_hit_rate() << ", change sets "
+                  << stats.change_set_hit_rate() << std::endl;
+
     } catch (lmdb::exception& ex) {
         // This handles specific lmdb errors
         std::cout << ex.err() << " " << ex.what() << std::endl;
@@ -117,10 +123,5 @@ int main(int argc, char* argv[]) {
         retvar = -1;
     }
 
-    // Note: See notes above. Even though this will go out of scope and automatically clean up, you may
-    // uncomment this if you're using the long-lived database transaction noted above.
-    // txn.reset();
-    env.reset();
-
     return retvar;
 }
@@ -39,6 +39,11 @@ class DecodingError : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+class ValidationError : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
 constexpr size_t kAddressLength{20};
 
 constexpr size_t kHashLength{32};
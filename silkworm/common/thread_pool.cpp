@@ -0,0 +1,120 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "thread_pool.hpp"
+
+namespace silkworm {
+
+// Pool and queue index of the current thread, if it's a pool thread
+static thread_local const ThreadPool* tls_pool{nullptr};
+static thread_local size_t tls_index{0};
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    for (size_t i{0}; i < num_threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i{0}; i < num_threads; ++i) {
+        threads_.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{sleep_mutex_};
+        stopping_ = true;
+    }
+    wake_up_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::push(Task task) {
+    size_t index{tls_pool == this ? tls_index : next_queue_++ % queues_.size()};
+    ++pending_;
+    {
+        Queue& queue{*queues_[index]};
+        std::lock_guard lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        // Pairs with the predicate check of sleeping threads, so that the notification isn't lost
+        std::lock_guard lock{sleep_mutex_};
+    }
+    wake_up_.notify_one();
+}
+
+bool ThreadPool::try_pop(size_t index, Task& task) {
+    const size_t n{queues_.size()};
+    if (index < n) {
+        Queue& own{*queues_[index]};
+        std::lock_guard lock{own.mutex};
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i{1}; i <= n; ++i) {
+        Queue& victim{*queues_[(index + i) % n]};
+        std::lock_guard lock{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::try_run_one() {
+    if (pending_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    Task task;
+    if (!try_pop(tls_pool == this ? tls_index : queues_.size(), task)) {
+        return false;
+    }
+    --pending_;
+    task();
+    return true;
+}
+
+void ThreadPool::work(size_t index) {
+    tls_pool = this;
+    tls_index = index;
+
+    Task task;
+    while (true) {
+        if (try_pop(index, task)) {
+            --pending_;
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock{sleep_mutex_};
+        wake_up_.wait(lock, [this]() NO_THREAD_SAFETY_ANALYSIS { return stopping_ || pending_ > 0; });
+        if (stopping_ && pending_ == 0) {
+            return;
+        }
+    }
+}
+
+}  // namespace silkworm
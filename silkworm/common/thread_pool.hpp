@@ -0,0 +1,86 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_COMMON_THREAD_POOL_H_
+#define SILKWORM_COMMON_THREAD_POOL_H_
+
+#include <absl/base/thread_annotations.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace silkworm {
+
+/** @brief Fixed-size pool of threads with a task queue per thread and work stealing.
+ *
+ * Tasks pushed from a pool thread go to its own queue, others are spread round-robin.
+ * A thread runs the newest task of its own queue first; once that's empty it steals the oldest
+ * task of another queue, so uneven tasks balance out without a central queue.
+ * Tasks must not throw.
+ */
+class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+    // 0 stands for std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t num_threads = 0);
+
+    // Runs the remaining tasks and joins the threads
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const noexcept { return threads_.size(); }
+
+    void push(Task task);
+
+    /** Runs one pending task, if any, on the calling thread.
+     * Lets a thread waiting for results help instead of blocking.
+     */
+    bool try_run_one();
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        GUARDED_BY(mutex) std::deque<Task> tasks;
+    };
+
+    void work(size_t index);
+
+    // From own queue (if index is valid) first, then stealing from the others
+    bool try_pop(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<size_t> pending_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+    GUARDED_BY(sleep_mutex_) bool stopping_{false};
+};
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_COMMON_THREAD_POOL_H_
@@ -0,0 +1,75 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "thread_pool.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkworm {
+
+TEST_CASE("Thread pool") {
+    constexpr size_t kNumOfTasks{10'000};
+    std::vector<uint64_t> results(kNumOfTasks);
+    std::atomic<size_t> pending{kNumOfTasks};
+
+    SECTION("tasks from the outside") {
+        ThreadPool pool{4};
+        CHECK(pool.size() == 4);
+        for (size_t i{0}; i < kNumOfTasks; ++i) {
+            pool.push([&, i] {
+                results[i] = i * i;
+                --pending;
+            });
+        }
+        while (pending) {
+            pool.try_run_one();
+        }
+    }
+
+    SECTION("tasks spawning tasks") {
+        ThreadPool pool{3};
+        pool.push([&] {
+            for (size_t i{0}; i < kNumOfTasks; ++i) {
+                pool.push([&, i] {
+                    results[i] = i * i;
+                    --pending;
+                });
+            }
+        });
+        while (pending) {
+            pool.try_run_one();
+        }
+    }
+
+    SECTION("remaining tasks run on destruction") {
+        {
+            ThreadPool pool{2};
+            for (size_t i{0}; i < kNumOfTasks; ++i) {
+                pool.push([&, i] {
+                    results[i] = i * i;
+                    --pending;
+                });
+            }
+        }
+        CHECK(pending == 0);
+    }
+
+    for (size_t i{0}; i < kNumOfTasks; ++i) {
+        CHECK(results[i] == i * i);
+    }
+}
+
+}  // namespace silkworm
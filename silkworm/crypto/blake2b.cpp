@@ -0,0 +1,145 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "blake2b.hpp"
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
+namespace silkworm {
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+// Message words are loaded as they are
+static_assert(boost::endian::order::native == boost::endian::order::little,
+              "We assume a little-endian architecture like amd64");
+
+// Same as in blake2b-ref.c
+static const uint64_t kIV[8]{0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+                             0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+static const uint8_t kSigma[10][16]{
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4}, {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13}, {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11}, {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5}, {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+};
+
+// Rotations by whole bytes are byte shuffles within each lane
+__attribute__((target("avx2"))) static inline __m256i rotr(__m256i v, int n) {
+    switch (n) {
+        case 32:
+            return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        case 24:
+            return _mm256_shuffle_epi8(v, _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4,
+                                                           5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+        case 16:
+            return _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3,
+                                                           4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+        default:  // 63
+            return _mm256_or_si256(_mm256_srli_epi64(v, 63), _mm256_add_epi64(v, v));
+    }
+}
+
+// Four G functions side by side, one per lane; a, b, c & d are rows of the 4x4 working vector
+__attribute__((target("avx2"))) static inline void g4(__m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i x,
+                                                      __m256i y) {
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+    d = rotr(_mm256_xor_si256(d, a), 32);
+    c = _mm256_add_epi64(c, d);
+    b = rotr(_mm256_xor_si256(b, c), 24);
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+    d = rotr(_mm256_xor_si256(d, a), 16);
+    c = _mm256_add_epi64(c, d);
+    b = rotr(_mm256_xor_si256(b, c), 63);
+}
+
+__attribute__((target("avx2"))) static void blake2b_compress_avx2(blake2b_state* S,
+                                                                  const uint8_t block[BLAKE2B_BLOCKBYTES], size_t r) {
+    long long m[16];
+    std::memcpy(m, block, sizeof(m));
+
+    // Message words x & y of the column step, then of the diagonal step
+    __m256i schedule[10][4];
+    const size_t distinct_rounds{std::min<size_t>(r, 10)};
+    for (size_t i{0}; i < distinct_rounds; ++i) {
+        const uint8_t* s{kSigma[i]};
+        schedule[i][0] = _mm256_setr_epi64x(m[s[0]], m[s[2]], m[s[4]], m[s[6]]);
+        schedule[i][1] = _mm256_setr_epi64x(m[s[1]], m[s[3]], m[s[5]], m[s[7]]);
+        schedule[i][2] = _mm256_setr_epi64x(m[s[8]], m[s[10]], m[s[12]], m[s[14]]);
+        schedule[i][3] = _mm256_setr_epi64x(m[s[9]], m[s[11]], m[s[13]], m[s[15]]);
+    }
+
+    const __m256i h0{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&S->h[0]))};
+    const __m256i h1{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&S->h[4]))};
+
+    __m256i a{h0};
+    __m256i b{h1};
+    __m256i c{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&kIV[0]))};
+    __m256i d{_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&kIV[4])),
+                               _mm256_setr_epi64x(static_cast<long long>(S->t[0]), static_cast<long long>(S->t[1]),
+                                                  static_cast<long long>(S->f[0]), static_cast<long long>(S->f[1])))};
+
+    for (size_t i{0}, k{0}; i < r; ++i) {
+        const __m256i* x{schedule[k]};
+        if (++k == 10) {
+            k = 0;
+        }
+
+        g4(a, b, c, d, x[0], x[1]);
+
+        // Rotate rows b, c & d so that the diagonals line up as columns
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+
+        g4(a, b, c, d, x[2], x[3]);
+
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&S->h[0]), _mm256_xor_si256(h0, _mm256_xor_si256(a, c)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&S->h[4]), _mm256_xor_si256(h1, _mm256_xor_si256(b, d)));
+}
+
+#endif
+
+using CompressFunction = void (*)(blake2b_state*, const uint8_t*, size_t);
+
+static CompressFunction select_compress_function() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return blake2b_compress_avx2;
+    }
+#endif
+    return blake2b_compress;
+}
+
+void blake2b_f(blake2b_state* S, const uint8_t block[BLAKE2B_BLOCKBYTES], size_t r) {
+    static const CompressFunction compress_function{select_compress_function()};
+    compress_function(S, block, r);
+}
+
+}  // namespace silkworm
@@ -0,0 +1,35 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_CRYPTO_BLAKE2B_H_
+#define SILKWORM_CRYPTO_BLAKE2B_H_
+
+#include <silkworm/crypto/blake2.h>
+
+namespace silkworm {
+
+/** @brief BLAKE2b compression function F with r rounds, as per EIP-152.
+ *
+ * On CPUs with AVX2 the rows of the working vector are processed a register at a time, and the message words
+ * of the 10 distinct round permutations are gathered once per call rather than once per round,
+ * which is what pays off for calls with large round counts.
+ * The implementation is chosen once at run time with blake2b_compress of blake2b-ref.c as the fallback.
+ */
+void blake2b_f(blake2b_state* S, const uint8_t block[BLAKE2B_BLOCKBYTES], size_t r);
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_CRYPTO_BLAKE2B_H_
@@ -0,0 +1,94 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "blake2b.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <silkworm/common/util.hpp>
+#include <string>
+
+namespace silkworm {
+
+TEST_CASE("BLAKE2b F against the reference") {
+    std::mt19937_64 rng{152};
+
+    // Around and beyond the period of 10 of the message permutations
+    for (size_t r : {0u, 1u, 2u, 9u, 10u, 11u, 12u, 19u, 20u, 21u, 37u, 1'000u}) {
+        for (int k{0}; k < 10; ++k) {
+            blake2b_state state{};
+            for (uint64_t& h : state.h) {
+                h = rng();
+            }
+            state.t[0] = rng();
+            state.t[1] = rng();
+            state.f[0] = k % 2 ? std::numeric_limits<uint64_t>::max() : 0;
+            state.f[1] = k % 3 ? 0 : rng();
+
+            uint8_t block[BLAKE2B_BLOCKBYTES];
+            for (uint8_t& b : block) {
+                b = static_cast<uint8_t>(rng());
+            }
+
+            blake2b_state expected{state};
+            blake2b_compress(&expected, block, r);
+            blake2b_f(&state, block, r);
+            CHECK(std::memcmp(state.h, expected.h, sizeof(state.h)) == 0);
+        }
+    }
+}
+
+// F over the state & message of the EIP-152 test vectors, which are those of the BLAKE2b-512 of "abc"
+static std::string eip152_compress(size_t r, bool final_block) {
+    static_assert(boost::endian::order::native == boost::endian::order::little);
+
+    blake2b_state state{};
+    Bytes h{from_hex("48c9bdf267e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5d182e6ad7f520e511f6c3e2b8c68059b"
+                     "6bbd41fbabd9831f79217e1319cde05b")};
+    std::memcpy(state.h, h.data(), sizeof(state.h));
+    state.t[0] = 3;
+    if (final_block) {
+        state.f[0] = std::numeric_limits<uint64_t>::max();
+    }
+
+    uint8_t block[BLAKE2B_BLOCKBYTES]{'a', 'b', 'c'};
+    blake2b_f(&state, block, r);
+    return to_hex(ByteView{reinterpret_cast<const uint8_t*>(state.h), sizeof(state.h)});
+}
+
+TEST_CASE("BLAKE2b F EIP-152 vectors") {
+    // Test vector 4
+    CHECK(eip152_compress(0, true) ==
+          "08c9bcf367e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5d282e6ad7f520e511f6c3e2b8c68059b"
+          "9442be0454267ce079217e1319cde05b");
+    // Test vector 5
+    CHECK(eip152_compress(12, true) ==
+          "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d17d87c5392aab792dc252d5de4533cc95"
+          "18d38aa8dbf1925ab92386edd4009923");
+    // Test vector 6
+    CHECK(eip152_compress(12, false) ==
+          "75ab69d3190a562c51aef8d88f1c2775876944407270c42c9844252c26d2875298743e7f6d5ea2f2d3e8d226039cd31b"
+          "4e426ac4f2d3d666a610c2116fde4735");
+    // Test vector 7
+    CHECK(eip152_compress(1, true) ==
+          "b63a380cb2897d521994a85234ee2c181b5f844d2c624c002677e9703449d2fba551b3a8333bcdf5f2f7e08993d53923"
+          "de3d64fcc68c034e717b9293fed7a421");
+}
+
+}  // namespace silkworm
@@ -76,4 +76,43 @@ std::optional<Bytes> recover(ByteView message, ByteView signature, uint8_t recov
     secp256k1_ec_pubkey_serialize(kDefaultContext, &out[0], &kOutLen, &pub_key, SECP256K1_EC_UNCOMPRESSED);
     return out;
 }
+
+// The context is only read from, so all threads share it
+static bool recover_into(const RecoverableSignature& in, evmc::address& out) {
+    secp256k1_ecdsa_recoverable_signature sig;
+    if (!secp256k1_ecdsa_recoverable_signature_parse_compact(kDefaultContext, &sig, in.signature, in.recovery_id)) {
+        return false;
+    }
+
+    secp256k1_pubkey pub_key;
+    if (!secp256k1_ecdsa_recover(kDefaultContext, &pub_key, &sig, in.message)) {
+        return false;
+    }
+
+    uint8_t key[65];
+    size_t key_len{sizeof(key)};
+    secp256k1_ec_pubkey_serialize(kDefaultContext, key, &key_len, &pub_key, SECP256K1_EC_UNCOMPRESSED);
+
+    // Ignore the first byte of the public key, which is always 4 for uncompressed keys
+    ethash::hash256 hash{ethash::keccak256(key + 1, key_len - 1)};
+    std::memcpy(out.bytes, &hash.bytes[kHashLength - kAddressLength], kAddressLength);
+    return true;
+}
+
+std::optional<evmc::address> recover_address(const RecoverableSignature& signature) {
+    evmc::address out;
+    if (!recover_into(signature, out)) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+bool recover_addresses(const RecoverableSignature* signatures, size_t n, evmc::address* out) {
+    for (size_t i{0}; i < n; ++i) {
+        if (!recover_into(signatures[i], out[i])) {
+            return false;
+        }
+    }
+    return true;
+}
 }  // namespace silkworm::ecdsa
@@ -47,6 +47,21 @@ bool is_valid_signature(const intx::uint256& r, const intx::uint256& s, bool hom
 // Tries recover the public key used for message signing
 std::optional<Bytes> recover(ByteView message, ByteView signature, uint8_t recovery_id);
 
+struct RecoverableSignature {
+    uint8_t message[kHashLength]{};        // hash of the signed message
+    uint8_t signature[2 * kHashLength]{};  // r ‖ s, big-endian
+    uint8_t recovery_id{0};
+};
+
+// Tries recover the address of the message signer,
+// i.e. the last 20 bytes of the Keccak hash of the public key
+std::optional<evmc::address> recover_address(const RecoverableSignature& signature);
+
+// Recovers the signer addresses of signatures[0..n) into out[0..n).
+// Stops and returns false at the first signature that can't be recovered.
+// Cheaper per signature than recover, as no memory is allocated.
+bool recover_addresses(const RecoverableSignature* signatures, size_t n, evmc::address* out);
+
 }  // namespace silkworm::ecdsa
 
 #endif  // SILKWORM_CRYPTO_ECDSA_H_
@@ -0,0 +1,87 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ecdsa.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <silkworm/common/util.hpp>
+#include <vector>
+
+namespace silkworm::ecdsa {
+
+static RecoverableSignature recoverable_signature(std::string_view message, std::string_view signature,
+                                                  uint8_t recovery_id) {
+    RecoverableSignature s;
+    Bytes message_bytes{from_hex(message)};
+    Bytes signature_bytes{from_hex(signature)};
+    REQUIRE(message_bytes.length() == sizeof(s.message));
+    REQUIRE(signature_bytes.length() == sizeof(s.signature));
+    std::memcpy(s.message, message_bytes.data(), sizeof(s.message));
+    std::memcpy(s.signature, signature_bytes.data(), sizeof(s.signature));
+    s.recovery_id = recovery_id;
+    return s;
+}
+
+TEST_CASE("Recover address") {
+    // Same as the Ecrecover test of precompiled
+    const RecoverableSignature ecrec{recoverable_signature(
+        "18c547e4f7b0f325ad1e56f57e26c745b09a3e503d86e00e5255ff7f715d3d1c",
+        "73b1693892219d736caba55bdb67216e485557ea6b6af75f37096c9aa6a5a75f"
+        "eeb940b1d03b21e36b0e47e79769f095fe2ab855bd91e3a38756b7d75a9c4549",
+        /*recovery_id=*/1)};
+
+    // The example of EIP-155
+    const RecoverableSignature eip155{recoverable_signature(
+        "daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53",
+        "28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"
+        "67cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83",
+        /*recovery_id=*/0)};
+
+    // Same as the unrecoverable key of the Ecrecover test
+    const RecoverableSignature unrecoverable{recoverable_signature(
+        "a8b53bdf3306a35a7103ab5504a0c9b492295564b6202b1942a84ef300107281",
+        "3078356531653033663533636531386237373263636230303933666637316633"
+        "6635336635633735623734646362333161383561613862383839326234653862",
+        /*recovery_id=*/0)};
+
+    CHECK(recover_address(ecrec) == 0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b_address);
+    CHECK(recover_address(eip155) == 0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f_address);
+    CHECK(recover_address(unrecoverable) == std::nullopt);
+
+    // Same as recover followed by hashing
+    std::optional<Bytes> public_key{recover(full_view(ecrec.message), full_view(ecrec.signature), 1)};
+    REQUIRE(public_key);
+    REQUIRE(public_key->length() == 65);
+    ethash::hash256 hash{keccak256(public_key->substr(1))};
+    CHECK(to_hex(ByteView{&hash.bytes[12], kAddressLength}) == "a94f5374fce5edbc8e2a8697c15331677e6ebf0b");
+
+    SECTION("batch") {
+        std::vector<RecoverableSignature> signatures{eip155, ecrec, eip155};
+        std::vector<evmc::address> addresses(signatures.size());
+        REQUIRE(recover_addresses(signatures.data(), signatures.size(), addresses.data()));
+        CHECK(addresses == std::vector<evmc::address>{0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f_address,
+                                                       0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b_address,
+                                                       0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f_address});
+
+        CHECK(recover_addresses(signatures.data(), 0, addresses.data()));
+
+        signatures[1] = unrecoverable;
+        CHECK(!recover_addresses(signatures.data(), signatures.size(), addresses.data()));
+    }
+}
+
+}  // namespace silkworm::ecdsa
@@ -0,0 +1,320 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "keccak.hpp"
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+#include <ethash/keccak.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
+namespace silkworm {
+
+// Lanes are XORed in as bytes
+static_assert(boost::endian::order::native == boost::endian::order::little,
+              "We assume a little-endian architecture like amd64");
+
+void KeccakHasher::absorb_block() {
+    ethash_keccakf1600(state_);
+    offset_ = 0;
+}
+
+void KeccakHasher::append(ByteView data) {
+    while (!data.empty()) {
+        size_t n{std::min(kRate - offset_, data.length())};
+        uint8_t* block{bytes() + offset_};
+        for (size_t i{0}; i < n; ++i) {
+            block[i] ^= data[i];
+        }
+        offset_ += n;
+        data.remove_prefix(n);
+        if (offset_ == kRate) {
+            absorb_block();
+        }
+    }
+}
+
+ethash::hash256 KeccakHasher::finalize() {
+    // Original Keccak padding, not the SHA-3 one
+    bytes()[offset_] ^= 0x01;
+    bytes()[kRate - 1] ^= 0x80;
+    ethash_keccakf1600(state_);
+
+    ethash::hash256 hash;
+    std::memcpy(hash.bytes, state_, sizeof(hash.bytes));
+
+    std::memset(state_, 0, sizeof(state_));
+    offset_ = 0;
+    return hash;
+}
+
+// Messages are absorbed by blocks of kRate bytes, the last one padded
+static constexpr size_t kRate{136};
+static constexpr size_t kRateWords{kRate / 8};
+
+static size_t num_of_blocks(ByteView message) { return message.length() / kRate + 1; }
+
+static void load_block(ByteView message, size_t block, uint64_t (&words)[kRateWords]) {
+    const size_t offset{block * kRate};
+    if (offset + kRate <= message.length()) {
+        std::memcpy(words, &message[offset], kRate);
+        return;
+    }
+    std::memset(words, 0, kRate);
+    uint8_t* bytes{reinterpret_cast<uint8_t*>(words)};
+    if (offset < message.length()) {
+        std::memcpy(bytes, &message[offset], message.length() - offset);
+    }
+    bytes[message.length() - offset] ^= 0x01;
+    bytes[kRate - 1] ^= 0x80;
+}
+
+static void keccak256_scalar(const ByteView* in, size_t n, ethash::hash256* out) {
+    for (size_t i{0}; i < n; ++i) {
+        out[i] = ethash::keccak256(in[i].data(), in[i].length());
+    }
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+static constexpr uint64_t kRoundConstants[24]{
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000, 0x000000000000808b,
+    0x0000000080000001, 0x8000000080008081, 0x8000000000008009, 0x000000000000008a, 0x0000000000000088,
+    0x0000000080008009, 0x000000008000000a, 0x000000008000808b, 0x800000000000008b, 0x8000000000008089,
+    0x8000000000008003, 0x8000000000008002, 0x8000000000000080, 0x000000000000800a, 0x800000008000000a,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+};
+
+// Rotation offsets (ρ) of lanes x + 5y
+static constexpr int kRho[25]{0,  1,  62, 28, 27, 36, 44, 6,  55, 20, 3,  10, 43,
+                              25, 39, 41, 45, 15, 21, 8,  18, 2,  61, 56, 14};
+
+// Destinations (π) of lanes x + 5y, i.e. y + 5(2x + 3y)
+static constexpr int kPi[25]{0,  10, 20, 5,  15, 16, 1,  11, 21, 6, 7,  17, 2,
+                             12, 22, 23, 8,  18, 3,  13, 14, 24, 9, 19, 4};
+
+__attribute__((target("avx2"))) static inline __m256i rol(__m256i v, int n) {
+    return _mm256_or_si256(_mm256_sll_epi64(v, _mm_cvtsi32_si128(n)), _mm256_srl_epi64(v, _mm_cvtsi32_si128(64 - n)));
+}
+
+// Keccak-f[1600] over 4 states at once; lane i of state k is in the 64-bit element k of s[i]
+__attribute__((target("avx2"))) static void keccakf1600_x4(__m256i (&s)[25]) {
+    __m256i c[5], b[25];
+    for (uint64_t round_constant : kRoundConstants) {
+        for (int x{0}; x < 5; ++x) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(s[x], s[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(s[x + 10], s[x + 15]), s[x + 20]));
+        }
+        for (int x{0}; x < 5; ++x) {
+            __m256i d{_mm256_xor_si256(c[(x + 4) % 5], rol(c[(x + 1) % 5], 1))};
+            for (int y{0}; y < 25; y += 5) {
+                s[x + y] = _mm256_xor_si256(s[x + y], d);
+            }
+        }
+        for (int i{0}; i < 25; ++i) {
+            b[kPi[i]] = rol(s[i], kRho[i]);
+        }
+        for (int y{0}; y < 25; y += 5) {
+            for (int x{0}; x < 5; ++x) {
+                s[x + y] = _mm256_xor_si256(b[x + y], _mm256_andnot_si256(b[(x + 1) % 5 + y], b[(x + 2) % 5 + y]));
+            }
+        }
+        s[0] = _mm256_xor_si256(s[0], _mm256_set1_epi64x(static_cast<long long>(round_constant)));
+    }
+}
+
+// Hashes up to 4 messages
+__attribute__((target("avx2"))) static void keccak256_x4(const ByteView* in, size_t n, ethash::hash256* out) {
+    size_t num_blocks[4]{};
+    size_t max_blocks{0};
+    for (size_t k{0}; k < n; ++k) {
+        num_blocks[k] = num_of_blocks(in[k]);
+        max_blocks = std::max(max_blocks, num_blocks[k]);
+    }
+
+    __m256i s[25];
+    for (__m256i& lane : s) {
+        lane = _mm256_setzero_si256();
+    }
+
+    uint64_t words[4][kRateWords]{};
+    for (size_t block{0}; block < max_blocks; ++block) {
+        for (size_t k{0}; k < n; ++k) {
+            if (block < num_blocks[k]) {
+                load_block(in[k], block, words[k]);
+            } else {
+                std::memset(words[k], 0, kRate);
+            }
+        }
+        for (size_t i{0}; i < kRateWords; ++i) {
+            __m256i v{_mm256_set_epi64x(static_cast<long long>(words[3][i]), static_cast<long long>(words[2][i]),
+                                        static_cast<long long>(words[1][i]), static_cast<long long>(words[0][i]))};
+            s[i] = _mm256_xor_si256(s[i], v);
+        }
+
+        keccakf1600_x4(s);
+
+        for (size_t k{0}; k < n; ++k) {
+            if (block + 1 == num_blocks[k]) {
+                uint64_t hash[4];
+                for (size_t i{0}; i < 4; ++i) {
+                    uint64_t lanes[4];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), s[i]);
+                    hash[i] = lanes[k];
+                }
+                std::memcpy(out[k].bytes, hash, sizeof(hash));
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2"))) static void keccak256_avx2(const ByteView* in, size_t n, ethash::hash256* out) {
+    while (n >= 2) {
+        size_t group{std::min<size_t>(n, 4)};
+        keccak256_x4(in, group, out);
+        in += group;
+        out += group;
+        n -= group;
+    }
+    keccak256_scalar(in, n, out);
+}
+
+// AVX-512 intrinsics of GCC start from _mm512_undefined_epi32(), which -Wmaybe-uninitialized mistakes for a bug
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f"))) static inline __m512i rol(__m512i v, int n) {
+    return _mm512_rolv_epi64(v, _mm512_set1_epi64(n));
+}
+
+// Same as keccakf1600_x4, over 8 states
+__attribute__((target("avx512f"))) static void keccakf1600_x8(__m512i (&s)[25]) {
+    __m512i c[5], b[25];
+    for (uint64_t round_constant : kRoundConstants) {
+        for (int x{0}; x < 5; ++x) {
+            c[x] = _mm512_xor_si512(_mm512_xor_si512(s[x], s[x + 5]),
+                                    _mm512_xor_si512(_mm512_xor_si512(s[x + 10], s[x + 15]), s[x + 20]));
+        }
+        for (int x{0}; x < 5; ++x) {
+            __m512i d{_mm512_xor_si512(c[(x + 4) % 5], rol(c[(x + 1) % 5], 1))};
+            for (int y{0}; y < 25; y += 5) {
+                s[x + y] = _mm512_xor_si512(s[x + y], d);
+            }
+        }
+        for (int i{0}; i < 25; ++i) {
+            b[kPi[i]] = rol(s[i], kRho[i]);
+        }
+        for (int y{0}; y < 25; y += 5) {
+            for (int x{0}; x < 5; ++x) {
+                s[x + y] = _mm512_xor_si512(b[x + y], _mm512_andnot_si512(b[(x + 1) % 5 + y], b[(x + 2) % 5 + y]));
+            }
+        }
+        s[0] = _mm512_xor_si512(s[0], _mm512_set1_epi64(static_cast<long long>(round_constant)));
+    }
+}
+
+// Hashes up to 8 messages
+__attribute__((target("avx512f"))) static void keccak256_x8(const ByteView* in, size_t n, ethash::hash256* out) {
+    size_t num_blocks[8]{};
+    size_t max_blocks{0};
+    for (size_t k{0}; k < n; ++k) {
+        num_blocks[k] = num_of_blocks(in[k]);
+        max_blocks = std::max(max_blocks, num_blocks[k]);
+    }
+
+    __m512i s[25];
+    for (__m512i& lane : s) {
+        lane = _mm512_setzero_si512();
+    }
+
+    // Words are transposed into lanes with a gather: word i of message k is at index k * kRateWords + i
+    constexpr long long kStride{kRateWords};
+    const __m512i word_indices{_mm512_set_epi64(7 * kStride, 6 * kStride, 5 * kStride, 4 * kStride, 3 * kStride,
+                                                2 * kStride, kStride, 0)};
+    uint64_t words[8][kRateWords]{};
+    for (size_t block{0}; block < max_blocks; ++block) {
+        for (size_t k{0}; k < n; ++k) {
+            if (block < num_blocks[k]) {
+                load_block(in[k], block, words[k]);
+            } else {
+                std::memset(words[k], 0, kRate);
+            }
+        }
+        for (size_t i{0}; i < kRateWords; ++i) {
+            s[i] = _mm512_xor_si512(s[i], _mm512_i64gather_epi64(word_indices, &words[0][i], 8));
+        }
+
+        keccakf1600_x8(s);
+
+        for (size_t k{0}; k < n; ++k) {
+            if (block + 1 == num_blocks[k]) {
+                uint64_t hash[4];
+                for (size_t i{0}; i < 4; ++i) {
+                    uint64_t lanes[8];
+                    _mm512_storeu_si512(lanes, s[i]);
+                    hash[i] = lanes[k];
+                }
+                std::memcpy(out[k].bytes, hash, sizeof(hash));
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f"))) static void keccak256_avx512(const ByteView* in, size_t n, ethash::hash256* out) {
+    // Smaller groups are left to AVX2
+    while (n >= 5) {
+        size_t group{std::min<size_t>(n, 8)};
+        keccak256_x8(in, group, out);
+        in += group;
+        out += group;
+        n -= group;
+    }
+    keccak256_avx2(in, n, out);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+using BatchFunction = void (*)(const ByteView*, size_t, ethash::hash256*);
+
+static BatchFunction select_batch_function() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return keccak256_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return keccak256_avx2;
+    }
+#endif
+    return keccak256_scalar;
+}
+
+void keccak256_batch(const ByteView* in, size_t n, ethash::hash256* out) {
+    static const BatchFunction batch_function{select_batch_function()};
+    batch_function(in, n, out);
+}
+
+}  // namespace silkworm
@@ -0,0 +1,67 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_CRYPTO_KECCAK_H_
+#define SILKWORM_CRYPTO_KECCAK_H_
+
+#include <ethash/hash_types.hpp>
+#include <silkworm/common/base.hpp>
+
+namespace silkworm {
+
+/** @brief Incremental Keccak-256.
+ *
+ * Hashes data fed piece by piece without concatenating it first.
+ * Having the push_back & append interface of Bytes, it can be passed to rlp::encode
+ * in order to hash an RLP encoding without materializing it.
+ */
+class KeccakHasher {
+  public:
+    void push_back(uint8_t byte) {
+        bytes()[offset_++] ^= byte;
+        if (offset_ == kRate) {
+            absorb_block();
+        }
+    }
+
+    void append(ByteView data);
+
+    // Returns the hash of all the data fed so far and resets the hasher
+    ethash::hash256 finalize();
+
+  private:
+    static constexpr size_t kRate{136};  // (1600 - 2 * 256) / 8
+
+    uint8_t* bytes() { return reinterpret_cast<uint8_t*>(state_); }
+
+    void absorb_block();
+
+    uint64_t state_[25]{};
+    size_t offset_{0};  // of the next byte within the current block
+};
+
+/** @brief Keccak-256 of independent messages in[0..n) into out[0..n).
+ *
+ * Messages are hashed 8 or 4 at a time on CPUs with AVX-512 or AVX2 respectively,
+ * one lane per message; the implementation is chosen once at run time with a scalar fallback.
+ * Batches of messages with similar lengths are the most efficient,
+ * as a group takes as many permutations as its longest message.
+ */
+void keccak256_batch(const ByteView* in, size_t n, ethash::hash256* out);
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_CRYPTO_KECCAK_H_
@@ -0,0 +1,97 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "keccak.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/transaction.hpp>
+#include <vector>
+
+namespace silkworm {
+
+TEST_CASE("Incremental Keccak") {
+    KeccakHasher hasher;
+    CHECK(to_hex(full_view(hasher.finalize().bytes)) ==
+          "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470");
+
+    Bytes data(1'000, '\0');
+    for (size_t i{0}; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    // Pieces of all sizes around the block length of 136 bytes
+    for (size_t piece : {1u, 3u, 135u, 136u, 137u, 1'000u}) {
+        for (size_t len : {0u, 1u, 135u, 136u, 137u, 272u, 1'000u}) {
+            ByteView view{data.data(), len};
+            while (!view.empty()) {
+                size_t n{std::min(piece, view.length())};
+                if (n == 1) {
+                    hasher.push_back(view[0]);
+                } else {
+                    hasher.append(view.substr(0, n));
+                }
+                view.remove_prefix(n);
+            }
+            CHECK(full_view(hasher.finalize().bytes) == full_view(keccak256(ByteView{data.data(), len}).bytes));
+        }
+    }
+}
+
+TEST_CASE("Keccak of RLP") {
+    Transaction txn{};
+    txn.nonce = 12;
+    txn.gas_price = 20000000000;
+    txn.gas_limit = 21000;
+    txn.to = 0x727fc6a68321b754475c668a6abfb6e9e71c169a_address;
+    txn.value = intx::from_string<intx::uint256>("10000000000000000000");
+    txn.data = Bytes(300, '\x42');
+    txn.v = 37;
+    txn.r = 1;
+    txn.s = 2;
+
+    Bytes rlp{};
+    rlp::encode(rlp, txn, /*for_signing=*/true, 1);
+
+    KeccakHasher hasher;
+    rlp::encode(hasher, txn, /*for_signing=*/true, 1);
+    CHECK(full_view(hasher.finalize().bytes) == full_view(keccak256(rlp).bytes));
+}
+
+TEST_CASE("Batch Keccak") {
+    Bytes data(1'000, '\0');
+    for (size_t i{0}; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 13);
+    }
+
+    // Lengths around the block length of 136 bytes, so that lanes of a group finish at different blocks
+    const size_t lengths[]{0, 1, 32, 135, 136, 137, 271, 272, 600, 1'000, 20, 64, 300};
+    for (size_t n{0}; n <= 20; ++n) {
+        std::vector<ByteView> messages;
+        for (size_t k{0}; k < n; ++k) {
+            size_t len{lengths[(k * 5 + n) % std::size(lengths)]};
+            messages.push_back(ByteView{data.data() + k, std::min(len, data.size() - k)});
+        }
+        std::vector<ethash::hash256> hashes(n);
+        keccak256_batch(messages.data(), n, hashes.data());
+        for (size_t k{0}; k < n; ++k) {
+            CHECK(full_view(hashes[k].bytes) == full_view(keccak256(messages[k]).bytes));
+        }
+    }
+}
+
+}  // namespace silkworm
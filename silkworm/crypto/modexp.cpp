@@ -0,0 +1,393 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "modexp.hpp"
+
+#include <array>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cassert>
+#include <gsl/span>
+#include <intx/intx.hpp>
+#include <iterator>
+#include <vector>
+
+namespace silkworm {
+
+namespace {
+
+    // Returns the high word of a * b + c + d and stores its low word into lo; it can't overflow.
+    inline uint64_t mul_add(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t& lo) noexcept {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 t{static_cast<unsigned __int128>(a) * b};
+        t += c;
+        t += d;
+        lo = static_cast<uint64_t>(t);
+        return static_cast<uint64_t>(t >> 64);
+#else
+        intx::uint128 t{intx::umul(a, b)};
+        t += c;
+        t += d;
+        lo = t.lo;
+        return t.hi;
+#endif
+    }
+
+    // Returns the carry of a + b + carry, storing the sum into sum
+    inline uint64_t add_carry(uint64_t a, uint64_t b, uint64_t carry, uint64_t& sum) noexcept {
+        uint64_t s{a + carry};
+        uint64_t c{s < carry};
+        sum = s + b;
+        return c + (sum < s);
+    }
+
+    // Returns the borrow of a - b - borrow, storing the difference into diff
+    inline uint64_t sub_borrow(uint64_t a, uint64_t b, uint64_t borrow, uint64_t& diff) noexcept {
+        uint64_t d{a - b};
+        uint64_t c{a < b};
+        diff = d - borrow;
+        return c + (d < borrow);
+    }
+
+    // Little-endian limbs of the big-endian number (whose length is at most 8 * limbs.size())
+    void load_limbs(gsl::span<uint64_t> limbs, ByteView be) {
+        std::fill(limbs.begin(), limbs.end(), 0);
+        for (size_t i{0}; i < be.length(); ++i) {
+            limbs[i / 8] |= static_cast<uint64_t>(be[be.length() - 1 - i]) << (8 * (i % 8));
+        }
+    }
+
+    /** @brief Arithmetic modulo an odd m < 2^(64 * N) in the Montgomery domain, R being 2^(64 * N).
+     *
+     * Numbers are kept as x * R mod m, in which form mul (CIOS Montgomery multiplication) needs no division.
+     */
+    template <size_t N>
+    class Montgomery {
+      public:
+        using Number = std::array<uint64_t, N>;
+
+        explicit Montgomery(const Number& m) : m_{m} {
+            assert(m[0] & 1);
+
+            // -m^-1 mod 2^64 by Newton's iteration, each step doubling the correct low bits
+            uint64_t inv{m[0]};  // correct to 3 bits as m is odd
+            for (int i{0}; i < 5; ++i) {
+                inv *= 2 - m[0] * inv;
+            }
+            m_inv_ = 0 - inv;
+
+            // R mod m by doubling 2^(bit length of m - 1), the highest power of 2 below m
+            size_t top_limb{N - 1};
+            while (top_limb > 0 && m[top_limb] == 0) {
+                --top_limb;
+            }
+            const size_t bits{64 * top_limb + 64 - intx::clz(m[top_limb])};
+            Number x{};
+            if (bits > 1) {  // else m is 1 and everything is 0
+                x[top_limb] = uint64_t{1} << ((bits - 1) % 64);
+            }
+            for (size_t i{bits - 1}; i < 64 * N; ++i) {
+                double_mod(x);
+            }
+            one_ = x;
+
+            // R^2 mod m, being the Montgomery form of R = (2^N)^64: 2^N by doubling, then squared 6 times
+            for (size_t i{0}; i < N; ++i) {
+                double_mod(x);
+            }
+            for (int i{0}; i < 6; ++i) {
+                x = mul(x, x);
+            }
+            r2_ = x;
+        }
+
+        const Number& one() const { return one_; }
+
+        // a * b / R mod m, given a * b < m * R
+        Number mul(const Number& a, const Number& b) const {
+            std::array<uint64_t, N + 2> t{};
+            for (size_t i{0}; i < N; ++i) {
+                uint64_t carry{0};
+                for (size_t j{0}; j < N; ++j) {
+                    carry = mul_add(a[j], b[i], t[j], carry, t[j]);
+                }
+                t[N + 1] = add_carry(t[N], carry, 0, t[N]);
+
+                const uint64_t q{t[0] * m_inv_};
+                uint64_t discarded;
+                carry = mul_add(q, m_[0], t[0], 0, discarded);
+                for (size_t j{1}; j < N; ++j) {
+                    carry = mul_add(q, m_[j], t[j], carry, t[j - 1]);
+                }
+                t[N + 1] += add_carry(t[N], carry, 0, t[N - 1]);
+                t[N] = t[N + 1];
+                t[N + 1] = 0;
+            }
+
+            // t < 2m
+            Number res;
+            std::copy_n(t.begin(), N, res.begin());
+            if (t[N] || !less(res, m_)) {
+                sub(res, m_);
+            }
+            return res;
+        }
+
+        // Montgomery form of x, x < R
+        Number to_montgomery(const Number& x) const { return mul(x, r2_); }
+
+        Number from_montgomery(const Number& x) const {
+            Number one{};
+            one[0] = 1;
+            return mul(x, one);
+        }
+
+        // Montgomery form of the number, N limbs at a time from the most significant
+        Number reduce(ByteView be) const {
+            Number acc{};
+            size_t head{be.length() % (8 * N)};
+            if (head == 0) {
+                head = std::min(be.length(), 8 * N);
+            }
+            for (bool first{true}; !be.empty(); first = false) {
+                Number chunk;
+                load_limbs(chunk, be.substr(0, head));
+                be.remove_prefix(head);
+                head = 8 * N;
+                if (first) {
+                    acc = to_montgomery(chunk);
+                } else {
+                    acc = mul(acc, r2_);  // times R
+                    add_mod(acc, to_montgomery(chunk));
+                }
+            }
+            return acc;
+        }
+
+      private:
+        static bool less(const Number& a, const Number& b) {
+            for (size_t i{N}; i-- > 0;) {
+                if (a[i] != b[i]) {
+                    return a[i] < b[i];
+                }
+            }
+            return false;
+        }
+
+        // a -= b, discarding the borrow
+        static void sub(Number& a, const Number& b) {
+            uint64_t borrow{0};
+            for (size_t i{0}; i < N; ++i) {
+                borrow = sub_borrow(a[i], b[i], borrow, a[i]);
+            }
+        }
+
+        // x = 2x mod m, given x < m
+        void double_mod(Number& x) const {
+            const uint64_t carry{x[N - 1] >> 63};
+            for (size_t i{N - 1}; i > 0; --i) {
+                x[i] = (x[i] << 1) | (x[i - 1] >> 63);
+            }
+            x[0] <<= 1;
+            if (carry || !less(x, m_)) {
+                sub(x, m_);
+            }
+        }
+
+        // a = a + b mod m, given a, b < m
+        void add_mod(Number& a, const Number& b) const {
+            uint64_t carry{0};
+            for (size_t i{0}; i < N; ++i) {
+                carry = add_carry(a[i], b[i], carry, a[i]);
+            }
+            if (carry || !less(a, m_)) {
+                sub(a, m_);
+            }
+        }
+
+        Number m_;
+        uint64_t m_inv_;  // -m^-1 mod 2^64
+        Number one_;      // R mod m
+        Number r2_;       // R^2 mod m
+    };
+
+    // Bits of a big-endian number, 0 being the least significant
+    class ExponentBits {
+      public:
+        explicit ExponentBits(ByteView be) : be_{be} {
+            while (!be_.empty() && be_[0] == 0) {
+                be_.remove_prefix(1);
+            }
+            size_ = be_.empty() ? 0 : 8 * be_.length() - intx::clz(static_cast<uint32_t>(be_[0])) + 24;
+        }
+
+        size_t size() const { return size_; }
+
+        unsigned operator[](size_t i) const { return (be_[be_.length() - 1 - i / 8] >> (i % 8)) & 1; }
+
+      private:
+        ByteView be_;
+        size_t size_{0};
+    };
+
+    // Window widths by exponent length as in OpenSSL's BN_window_bits_for_exponent_size
+    unsigned window_bits(size_t exponent_bits) {
+        if (exponent_bits > 671) {
+            return 6;
+        } else if (exponent_bits > 239) {
+            return 5;
+        } else if (exponent_bits > 79) {
+            return 4;
+        } else if (exponent_bits > 23) {
+            return 3;
+        } else {
+            return 1;
+        }
+    }
+
+    template <size_t N>
+    Bytes montgomery_modexp(ByteView base, ByteView exponent, ByteView modulus) {
+        using Number = typename Montgomery<N>::Number;
+
+        Number m;
+        load_limbs(m, modulus);
+        const Montgomery<N> mont{m};
+
+        const ExponentBits e{exponent};
+        Number acc{mont.one()};
+
+        if (e.size() > 0) {
+            // Odd powers base^1, base^3, ..., base^(2^w - 1)
+            const unsigned w{window_bits(e.size())};
+            std::vector<Number> powers(size_t{1} << (w - 1));
+            powers[0] = mont.reduce(base);
+            if (powers.size() > 1) {
+                const Number square{mont.mul(powers[0], powers[0])};
+                for (size_t i{1}; i < powers.size(); ++i) {
+                    powers[i] = mont.mul(powers[i - 1], square);
+                }
+            }
+
+            // Left to right sliding window, with windows ending in a set bit
+            bool started{false};
+            for (size_t i{e.size()}; i-- > 0;) {
+                if (!e[i]) {
+                    acc = mont.mul(acc, acc);
+                    continue;
+                }
+                size_t j{i + 1 >= w ? i + 1 - w : 0};
+                while (!e[j]) {
+                    ++j;
+                }
+                size_t window{0};
+                for (size_t k{i + 1}; k-- > j;) {
+                    window = (window << 1) | e[k];
+                }
+                if (started) {
+                    for (size_t k{j}; k <= i; ++k) {
+                        acc = mont.mul(acc, acc);
+                    }
+                    acc = mont.mul(acc, powers[window >> 1]);
+                } else {
+                    acc = powers[window >> 1];
+                    started = true;
+                }
+                i = j;
+            }
+        }
+
+        const Number res{mont.from_montgomery(acc)};
+        Bytes out(modulus.length(), '\0');
+        for (size_t i{0}; i < std::min(modulus.length(), 8 * N); ++i) {
+            out[out.length() - 1 - i] = static_cast<uint8_t>(res[i / 8] >> (8 * (i % 8)));
+        }
+        return out;
+    }
+
+}  // namespace
+
+Bytes modexp_generic(ByteView base, ByteView exponent, ByteView modulus) {
+    boost::multiprecision::cpp_int b{};
+    if (!base.empty()) {
+        import_bits(b, base.begin(), base.end());
+    }
+
+    boost::multiprecision::cpp_int e{};
+    if (!exponent.empty()) {
+        import_bits(e, exponent.begin(), exponent.end());
+    }
+
+    boost::multiprecision::cpp_int m{};
+    if (!modulus.empty()) {
+        import_bits(m, modulus.begin(), modulus.end());
+    }
+
+    if (m == 0) {
+        return Bytes(modulus.length(), '\0');
+    }
+
+    boost::multiprecision::cpp_int result{boost::multiprecision::powm(b, e, m)};
+
+    Bytes out{};
+    export_bits(result, std::back_inserter(out), 8);
+    assert(out.size() <= modulus.length());
+    out.insert(0, modulus.length() - out.size(), '\0');
+
+    return out;
+}
+
+Bytes modexp(ByteView base, ByteView exponent, ByteView modulus) {
+    size_t modulus_start{0};
+    while (modulus_start < modulus.length() && modulus[modulus_start] == 0) {
+        ++modulus_start;
+    }
+    const ByteView significant{modulus.substr(modulus_start)};
+
+    if (significant.empty() || (significant.back() & 1) == 0) {
+        return modexp_generic(base, exponent, modulus);
+    }
+
+    // Sizes of common moduli are served exactly; others are padded up to the next one
+    const size_t limbs{(significant.length() + 7) / 8};
+    Bytes out;
+    if (limbs <= 1) {
+        out = montgomery_modexp<1>(base, exponent, significant);
+    } else if (limbs <= 2) {
+        out = montgomery_modexp<2>(base, exponent, significant);
+    } else if (limbs <= 4) {
+        out = montgomery_modexp<4>(base, exponent, significant);
+    } else if (limbs <= 8) {
+        out = montgomery_modexp<8>(base, exponent, significant);
+    } else if (limbs <= 12) {
+        out = montgomery_modexp<12>(base, exponent, significant);
+    } else if (limbs <= 16) {
+        out = montgomery_modexp<16>(base, exponent, significant);
+    } else if (limbs <= 24) {
+        out = montgomery_modexp<24>(base, exponent, significant);
+    } else if (limbs <= 32) {
+        out = montgomery_modexp<32>(base, exponent, significant);
+    } else if (limbs <= 48) {
+        out = montgomery_modexp<48>(base, exponent, significant);
+    } else if (limbs <= 64) {
+        out = montgomery_modexp<64>(base, exponent, significant);
+    } else {
+        return modexp_generic(base, exponent, modulus);
+    }
+
+    out.insert(0, modulus_start, '\0');
+    return out;
+}
+
+}  // namespace silkworm
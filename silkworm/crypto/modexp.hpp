@@ -0,0 +1,39 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_CRYPTO_MODEXP_H_
+#define SILKWORM_CRYPTO_MODEXP_H_
+
+#include <silkworm/common/base.hpp>
+
+// Modular exponentiation of arbitrary-length big-endian numbers for the MODEXP precompiled contract.
+// See https://eips.ethereum.org/EIPS/eip-198
+
+namespace silkworm {
+
+/** @brief base ^ exponent % modulus, left-padded with zeros to the length of modulus; all zeros if modulus is 0.
+ *
+ * Odd moduli of up to 4096 bits, RSA ones among them, are handled by Montgomery multiplication over fixed-width limbs
+ * with sliding-window exponentiation. Even or longer moduli fall back to boost::multiprecision::powm.
+ */
+Bytes modexp(ByteView base, ByteView exponent, ByteView modulus);
+
+// Same as modexp but always through boost::multiprecision::powm, for reference
+Bytes modexp_generic(ByteView base, ByteView exponent, ByteView modulus);
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_CRYPTO_MODEXP_H_
@@ -0,0 +1,77 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "modexp.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <silkworm/common/util.hpp>
+
+namespace silkworm {
+
+static Bytes random_bytes(std::mt19937_64& rng, size_t length) {
+    Bytes bytes(length, '\0');
+    for (uint8_t& b : bytes) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return bytes;
+}
+
+TEST_CASE("Modexp") {
+    CHECK(to_hex(modexp(from_hex("03"), from_hex("05"), from_hex("0b"))) == "01");  // 243 = 22 * 11 + 1
+    CHECK(to_hex(modexp(from_hex("03"), {}, from_hex("0005"))) == "0001");
+    CHECK(to_hex(modexp(from_hex("07"), from_hex("00"), from_hex("01"))) == "00");
+    CHECK(to_hex(modexp({}, from_hex("03"), from_hex("0007"))) == "0000");
+    CHECK(to_hex(modexp(from_hex("07"), from_hex("03"), {})).empty());
+    CHECK(to_hex(modexp(from_hex("07"), from_hex("03"), from_hex("0000"))) == "0000");
+
+    // Fermat's little theorem
+    Bytes p{from_hex("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f")};
+    Bytes p_minus_1{from_hex("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2e")};
+    CHECK(to_hex(modexp(from_hex("2a"), p_minus_1, p)) ==
+          "0000000000000000000000000000000000000000000000000000000000000001");
+}
+
+TEST_CASE("Modexp against powm") {
+    std::mt19937_64 rng{1};
+
+    // Byte lengths around each limb count served, plus sizes over 4096 bits;
+    // exponent lengths run every window width
+    for (size_t modulus_length : {1, 7, 8, 9, 31, 32, 33, 64, 96, 100, 128, 192, 256, 384, 512, 513}) {
+        for (bool odd : {true, false}) {
+            for (size_t base_length : {size_t{0}, modulus_length / 2, modulus_length, 2 * modulus_length + 3}) {
+                for (size_t exponent_length : {1, 3, 16, 32, 70, 256}) {
+                    Bytes base{random_bytes(rng, base_length)};
+                    Bytes exponent{random_bytes(rng, exponent_length)};
+                    Bytes modulus{random_bytes(rng, modulus_length)};
+                    if (odd) {
+                        modulus.back() |= 1;
+                    } else {
+                        modulus.back() &= 0xfe;
+                    }
+                    if (modulus_length > 2 && rng() % 4 == 0) {
+                        modulus[0] = 0;  // leading zeros
+                    }
+
+                    CHECK(to_hex(modexp(base, exponent, modulus)) ==
+                          to_hex(modexp_generic(base, exponent, modulus)));
+                }
+            }
+        }
+    }
+}
+
+}  // namespace silkworm
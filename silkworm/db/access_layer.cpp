@@ -78,6 +78,48 @@ std::optional<BlockWithHash> read_block(lmdb::Transaction& txn, uint64_t block_n
     return bh;
 }
 
+std::optional<evmc::bytes32> read_block(lmdb::Transaction& txn, uint64_t block_number, bool read_senders,
+                                        BlockView& out) {
+    auto header_table{txn.open(table::kBlockHeaders)};
+    std::optional<ByteView> hash_val{header_table->get(header_hash_key(block_number))};
+    if (!hash_val) {
+        return std::nullopt;
+    }
+
+    evmc::bytes32 hash;
+    assert(hash_val->size() == kHashLength);
+    std::memcpy(hash.bytes, hash_val->data(), kHashLength);
+
+    Bytes key{block_key(block_number, hash.bytes)};
+    std::optional<ByteView> header_rlp{header_table->get(key)};
+    if (!header_rlp) {
+        return std::nullopt;
+    }
+
+    rlp::decode(*header_rlp, out.header);
+
+    auto body_table{txn.open(table::kBlockBodies)};
+    std::optional<ByteView> body_rlp{body_table->get(key)};
+    if (!body_rlp) {
+        return std::nullopt;
+    }
+
+    rlp::decode_body(*body_rlp, out);
+
+    if (read_senders) {
+        auto sender_table{txn.open(table::kSenders)};
+        ByteView senders{sender_table->get(key).value_or(ByteView{})};
+        if (senders.length() != out.transactions.size() * kAddressLength) {
+            throw MissingSenders("senders count does not match transactions count");
+        }
+        for (size_t i{0}; i < out.transactions.size(); ++i) {
+            std::memcpy(out.transactions[i].from.emplace().bytes, &senders[i * kAddressLength], kAddressLength);
+        }
+    }
+
+    return hash;
+}
+
 std::vector<evmc::address> read_senders(lmdb::Transaction& txn, int64_t block_number, const evmc::bytes32& block_hash) {
     std::vector<evmc::address> senders{};
     auto table{txn.open(table::kSenders)};
@@ -102,7 +144,11 @@ std::optional<Bytes> read_code(lmdb::Transaction& txn, const evmc::bytes32& code
 }
 
 static std::optional<ByteView> find_in_history(lmdb::Transaction& txn, bool storage, ByteView key,
-                                               uint64_t block_number) {
+                                               uint64_t block_number, HistoryCache* cache) {
+    if (cache) {
+        return cache->find(txn, storage, key, block_number);
+    }
+
     auto history_name{storage ? table::kStorageHistory : table::kAccountHistory};
     auto history_table{txn.open(history_name)};
     std::optional<Entry> entry{history_table->seek(history_index_key(key, block_number))};
@@ -145,23 +191,12 @@ static std::optional<ByteView> find_in_history(lmdb::Transaction& txn, bool stor
     }
 }
 
-std::optional<Account> read_account(lmdb::Transaction& txn, const evmc::address& address,
-                                    std::optional<uint64_t> block_num) {
-    auto key{full_view(address)};
-
-    std::optional<ByteView> encoded{};
-    if (block_num) {
-        encoded = find_in_history(txn, /*storage=*/false, key, *block_num);
-    }
-    if (!encoded) {
-        auto state_table{txn.open(table::kPlainState)};
-        encoded = state_table->get(key);
-    }
-    if (!encoded || encoded->empty()) {
+std::optional<Account> decode_account(lmdb::Transaction& txn, const evmc::address& address, ByteView encoded) {
+    if (encoded.empty()) {
         return {};
     }
 
-    std::optional<Account> acc{decode_account_from_storage(*encoded)};
+    std::optional<Account> acc{decode_account_from_storage(encoded)};
 
     if (acc && acc->incarnation > 0 && acc->code_hash == kEmptyHash) {
         // restore code hash
@@ -175,12 +210,31 @@ std::optional<Account> read_account(lmdb::Transaction& txn, const evmc::address&
     return acc;
 }
 
+std::optional<Account> read_account(lmdb::Transaction& txn, const evmc::address& address,
+                                    std::optional<uint64_t> block_num, HistoryCache* history_cache) {
+    auto key{full_view(address)};
+
+    std::optional<ByteView> encoded{};
+    if (block_num) {
+        encoded = find_in_history(txn, /*storage=*/false, key, *block_num, history_cache);
+    }
+    if (!encoded) {
+        auto state_table{txn.open(table::kPlainState)};
+        encoded = state_table->get(key);
+    }
+    if (!encoded) {
+        return {};
+    }
+    return decode_account(txn, address, *encoded);
+}
+
 evmc::bytes32 read_storage(lmdb::Transaction& txn, const evmc::address& address, uint64_t incarnation,
-                           const evmc::bytes32& key, std::optional<uint64_t> block_num) {
+                           const evmc::bytes32& key, std::optional<uint64_t> block_num,
+                           HistoryCache* history_cache) {
     std::optional<ByteView> val{};
     if (block_num) {
         auto composite_key{storage_key(address, incarnation, key)};
-        val = find_in_history(txn, /*storage=*/true, composite_key, *block_num);
+        val = find_in_history(txn, /*storage=*/true, composite_key, *block_num, history_cache);
     }
     if (!val) {
         auto table{txn.open(table::kPlainState)};
@@ -269,22 +323,29 @@ Bytes read_storage_changes(lmdb::Transaction& txn, uint64_t block_number) {
     return Bytes{*val};
 }
 
+std::optional<uint64_t> read_stage_progress(lmdb::Transaction& txn, const char* stage_name) {
+    auto table{txn.open(table::kSyncStageProgress)};
+    std::optional<ByteView> val{table->get(byte_view_of_c_str(stage_name))};
+    if (!val) {
+        return {};
+    }
+    if (val->length() != 8) {
+        throw DecodingError("unexpected stage progress length");
+    }
+    return boost::endian::load_big_u64(val->data());
+}
+
+void write_stage_progress(lmdb::Transaction& txn, const char* stage_name, uint64_t block_number) {
+    auto table{txn.open(table::kSyncStageProgress)};
+    Bytes val(8, '\0');
+    boost::endian::store_big_u64(&val[0], block_number);
+    table->put(byte_view_of_c_str(stage_name), val);
+}
+
 bool read_storage_mode_receipts(lmdb::Transaction& txn) {
     auto table{txn.open(table::kDatabaseInfo)};
     std::optional<ByteView> val{table->get(byte_view_of_c_str(kStorageModeReceipts))};
     return val && val->length() == 1 && (*val)[0] == 1;
 }
 
-void append_receipts(lmdb::Transaction& txn, uint64_t block_number, const std::vector<Receipt>& receipts) {
-    auto log_table{txn.open(table::kLogs)};
-    for (uint32_t i{0}; i < receipts.size(); ++i) {
-        if (!receipts[i].logs.empty()) {
-            log_table->put(log_key(block_number, i), cbor_encode(receipts[i].logs), MDB_APPEND);
-        }
-    }
-
-    auto receipt_table{txn.open(table::kBlockReceipts)};
-    receipt_table->put(receipt_key(block_number), cbor_encode(receipts), MDB_APPEND);
-}
-
 }  // namespace silkworm::db
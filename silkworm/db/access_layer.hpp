@@ -22,8 +22,10 @@
 #include <optional>
 #include <silkworm/db/chaindb.hpp>
 #include <silkworm/db/change.hpp>
+#include <silkworm/db/history_cache.hpp>
 #include <silkworm/types/account.hpp>
 #include <silkworm/types/block.hpp>
+#include <silkworm/types/block_view.hpp>
 #include <silkworm/types/receipt.hpp>
 #include <vector>
 
@@ -45,17 +47,34 @@ std::optional<BlockHeader> read_header(lmdb::Transaction& txn, uint64_t block_nu
 // might throw MissingSenders
 std::optional<BlockWithHash> read_block(lmdb::Transaction& txn, uint64_t block_number, bool read_senders);
 
+/** @brief Decodes a block in place into out, reusing its capacity; see BlockView.
+ *
+ * The views of out point into the DB pages of kBlockBodies, so they are valid until the end of txn
+ * as long as kBlockBodies isn't modified.
+ * Might throw MissingSenders.
+ * @return The block hash, or nothing if the block isn't found.
+ */
+std::optional<evmc::bytes32> read_block(lmdb::Transaction& txn, uint64_t block_number, bool read_senders,
+                                        BlockView& out);
+
 std::vector<evmc::address> read_senders(lmdb::Transaction& txn, int64_t block_number, const evmc::bytes32& block_hash);
 
 std::optional<Bytes> read_code(lmdb::Transaction& txn, const evmc::bytes32& code_hash);
 
 // Reads current or historical (if block_number is specified) account.
+// Historical reads go through history_cache if one is provided.
 std::optional<Account> read_account(lmdb::Transaction& txn, const evmc::address& address,
-                                    std::optional<uint64_t> block_number = {});
+                                    std::optional<uint64_t> block_number = {}, HistoryCache* history_cache = nullptr);
+
+// Decodes an account as stored in PlainState or change sets, restoring its code hash if omitted.
+// An empty encoding stands for a non-existent account.
+std::optional<Account> decode_account(lmdb::Transaction& txn, const evmc::address& address, ByteView encoded);
 
 // Reads current or historical (if block_number is specified) storage.
+// Historical reads go through history_cache if one is provided.
 evmc::bytes32 read_storage(lmdb::Transaction& txn, const evmc::address& address, uint64_t incarnation,
-                           const evmc::bytes32& key, std::optional<uint64_t> block_number = {});
+                           const evmc::bytes32& key, std::optional<uint64_t> block_number = {},
+                           HistoryCache* history_cache = nullptr);
 
 // Reads current or historical (if block_number is specified) previous incarnation.
 std::optional<uint64_t> read_previous_incarnation(lmdb::Transaction& txn, const evmc::address& address,
@@ -65,8 +84,17 @@ std::optional<AccountChanges> read_account_changes(lmdb::Transaction& txn, uint6
 
 Bytes read_storage_changes(lmdb::Transaction& txn, uint64_t block_number);
 
-// See TG AppendReceipts in core/rawdb/accessors_chain.go
-void append_receipts(lmdb::Transaction& txn, uint64_t block_number, const std::vector<Receipt>& receipts);
+// TG names of the sync stages; see TG eth/stagedsync/stages
+constexpr const char* kExecutionStage{"Execution"};
+constexpr const char* kAccountHistoryIndexStage{"AccountHistoryIndex"};
+constexpr const char* kStorageHistoryIndexStage{"StorageHistoryIndex"};
+constexpr const char* kLogIndexStage{"LogIndex"};
+
+// See TG stages.GetStageProgress
+std::optional<uint64_t> read_stage_progress(lmdb::Transaction& txn, const char* stage_name);
+
+// See TG stages.SaveStageProgress
+void write_stage_progress(lmdb::Transaction& txn, const char* stage_name, uint64_t block_number);
 
 }  // namespace silkworm::db
 
@@ -0,0 +1,401 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "bitmap.hpp"
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <cassert>
+#include <functional>
+#include <iterator>
+
+namespace silkworm::db::bitmap {
+
+constexpr uint32_t kSerialCookieNoRunContainer{12346};
+constexpr uint32_t kSerialCookie{12347};
+
+// Run bitmaps with fewer containers have no offset header
+constexpr size_t kNoOffsetThreshold{4};
+
+constexpr size_t kBitsetWords{(1 << 16) / 64};
+
+static uint32_t popcount(const std::vector<uint64_t>& words) {
+    uint32_t n{0};
+    for (uint64_t word : words) {
+        n += static_cast<uint32_t>(__builtin_popcountll(word));
+    }
+    return n;
+}
+
+bool Bitmap::Container::contains(uint16_t v) const noexcept {
+    if (is_bitset()) {
+        return (bitset[v / 64] >> (v % 64)) & 1;
+    }
+    return std::binary_search(array.begin(), array.end(), v);
+}
+
+void Bitmap::Container::add(uint16_t v) {
+    if (is_bitset()) {
+        uint64_t& word{bitset[v / 64]};
+        const uint64_t mask{uint64_t{1} << (v % 64)};
+        if (!(word & mask)) {
+            word |= mask;
+            ++cardinality;
+        }
+        return;
+    }
+
+    if (array.empty() || array.back() < v) {
+        array.push_back(v);
+    } else {
+        auto it{std::lower_bound(array.begin(), array.end(), v)};
+        if (*it == v) {
+            return;
+        }
+        array.insert(it, v);
+    }
+    ++cardinality;
+    if (cardinality > kMaxArrayLength) {
+        to_bitset();
+    }
+}
+
+void Bitmap::Container::to_bitset() {
+    bitset.assign(kBitsetWords, 0);
+    for (uint16_t v : array) {
+        bitset[v / 64] |= uint64_t{1} << (v % 64);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void Bitmap::Container::to_array() {
+    array.clear();
+    array.reserve(cardinality);
+    for (size_t i{0}; i < kBitsetWords; ++i) {
+        for (uint64_t word{bitset[i]}; word; word &= word - 1) {
+            array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+        }
+    }
+    bitset.clear();
+    bitset.shrink_to_fit();
+}
+
+size_t Bitmap::Container::serialized_size() const noexcept {
+    return is_bitset() ? kBitsetWords * 8 : array.size() * 2;
+}
+
+Bitmap::Container& Bitmap::container(uint16_t key) {
+    if (containers_.empty() || containers_.back().key < key) {
+        Container& c{containers_.emplace_back()};
+        c.key = key;
+        return c;
+    }
+    auto it{std::lower_bound(containers_.begin(), containers_.end(), key,
+                             [](const Container& c, uint16_t k) { return c.key < k; })};
+    if (it->key != key) {
+        it = containers_.insert(it, Container{});
+        it->key = key;
+    }
+    return *it;
+}
+
+void Bitmap::add(uint32_t v) { container(static_cast<uint16_t>(v >> 16)).add(static_cast<uint16_t>(v)); }
+
+bool Bitmap::contains(uint32_t v) const noexcept {
+    const auto key{static_cast<uint16_t>(v >> 16)};
+    auto it{std::lower_bound(containers_.begin(), containers_.end(), key,
+                             [](const Container& c, uint16_t k) { return c.key < k; })};
+    return it != containers_.end() && it->key == key && it->contains(static_cast<uint16_t>(v));
+}
+
+uint64_t Bitmap::cardinality() const noexcept {
+    uint64_t n{0};
+    for (const Container& c : containers_) {
+        n += c.cardinality;
+    }
+    return n;
+}
+
+uint32_t Bitmap::minimum() const noexcept {
+    assert(!empty());
+    const Container& c{containers_.front()};
+    uint32_t low{0};
+    if (c.is_bitset()) {
+        size_t i{0};
+        while (c.bitset[i] == 0) {
+            ++i;
+        }
+        low = static_cast<uint32_t>(i * 64 + __builtin_ctzll(c.bitset[i]));
+    } else {
+        low = c.array.front();
+    }
+    return (uint32_t{c.key} << 16) | low;
+}
+
+uint32_t Bitmap::maximum() const noexcept {
+    assert(!empty());
+    const Container& c{containers_.back()};
+    uint32_t low{0};
+    if (c.is_bitset()) {
+        size_t i{kBitsetWords - 1};
+        while (c.bitset[i] == 0) {
+            --i;
+        }
+        low = static_cast<uint32_t>(i * 64 + 63 - __builtin_clzll(c.bitset[i]));
+    } else {
+        low = c.array.back();
+    }
+    return (uint32_t{c.key} << 16) | low;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+    std::vector<Container> res;
+    auto a{containers_.begin()};
+    auto b{other.containers_.begin()};
+    while (a != containers_.end() && b != other.containers_.end()) {
+        if (a->key < b->key) {
+            ++a;
+            continue;
+        }
+        if (b->key < a->key) {
+            ++b;
+            continue;
+        }
+
+        Container c{};
+        c.key = a->key;
+        if (a->is_bitset() && b->is_bitset()) {
+            c.bitset.resize(kBitsetWords);
+            for (size_t i{0}; i < kBitsetWords; ++i) {
+                c.bitset[i] = a->bitset[i] & b->bitset[i];
+            }
+            c.cardinality = popcount(c.bitset);
+            if (c.cardinality <= kMaxArrayLength) {
+                c.to_array();
+            }
+        } else if (a->is_bitset() || b->is_bitset()) {
+            const Container& bits{a->is_bitset() ? *a : *b};
+            const Container& arr{a->is_bitset() ? *b : *a};
+            for (uint16_t v : arr.array) {
+                if (bits.contains(v)) {
+                    c.array.push_back(v);
+                }
+            }
+            c.cardinality = static_cast<uint32_t>(c.array.size());
+        } else {
+            std::set_intersection(a->array.begin(), a->array.end(), b->array.begin(), b->array.end(),
+                                  std::back_inserter(c.array));
+            c.cardinality = static_cast<uint32_t>(c.array.size());
+        }
+        if (c.cardinality > 0) {
+            res.push_back(std::move(c));
+        }
+        ++a;
+        ++b;
+    }
+    containers_ = std::move(res);
+    return *this;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap& other) {
+    for (const Container& b : other.containers_) {
+        Container& a{container(b.key)};
+        if (b.is_bitset()) {
+            if (!a.is_bitset()) {
+                a.to_bitset();
+            }
+            for (size_t i{0}; i < kBitsetWords; ++i) {
+                a.bitset[i] |= b.bitset[i];
+            }
+            a.cardinality = popcount(a.bitset);
+        } else if (a.is_bitset()) {
+            for (uint16_t v : b.array) {
+                a.add(v);
+            }
+        } else {
+            std::vector<uint16_t> merged;
+            merged.reserve(a.array.size() + b.array.size());
+            std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                           std::back_inserter(merged));
+            a.array = std::move(merged);
+            a.cardinality = static_cast<uint32_t>(a.array.size());
+            if (a.cardinality > kMaxArrayLength) {
+                a.to_bitset();
+            }
+        }
+    }
+    return *this;
+}
+
+void Bitmap::for_each(const std::function<void(uint32_t)>& f) const {
+    for (const Container& c : containers_) {
+        const uint32_t high{uint32_t{c.key} << 16};
+        if (c.is_bitset()) {
+            for (size_t i{0}; i < kBitsetWords; ++i) {
+                for (uint64_t word{c.bitset[i]}; word; word &= word - 1) {
+                    f(high | static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+                }
+            }
+        } else {
+            for (uint16_t v : c.array) {
+                f(high | v);
+            }
+        }
+    }
+}
+
+std::vector<uint32_t> Bitmap::values() const {
+    std::vector<uint32_t> res;
+    res.reserve(cardinality());
+    for_each([&res](uint32_t v) { res.push_back(v); });
+    return res;
+}
+
+size_t Bitmap::serialized_size() const noexcept {
+    // Cookie and number of containers, then key, cardinality - 1 and offset of every container
+    size_t size{8 + 8 * containers_.size()};
+    for (const Container& c : containers_) {
+        size += c.serialized_size();
+    }
+    return size;
+}
+
+Bytes Bitmap::serialize() const {
+    using boost::endian::store_little_u16;
+    using boost::endian::store_little_u32;
+    using boost::endian::store_little_u64;
+
+    Bytes out(serialized_size(), '\0');
+    store_little_u32(&out[0], kSerialCookieNoRunContainer);
+    store_little_u32(&out[4], static_cast<uint32_t>(containers_.size()));
+
+    uint8_t* header{&out[8]};
+    uint8_t* offsets{header + 4 * containers_.size()};
+    size_t pos{8 + 8 * containers_.size()};
+    for (const Container& c : containers_) {
+        store_little_u16(header, c.key);
+        store_little_u16(header + 2, static_cast<uint16_t>(c.cardinality - 1));
+        header += 4;
+        store_little_u32(offsets, static_cast<uint32_t>(pos));
+        offsets += 4;
+        if (c.is_bitset()) {
+            for (uint64_t word : c.bitset) {
+                store_little_u64(&out[pos], word);
+                pos += 8;
+            }
+        } else {
+            for (uint16_t v : c.array) {
+                store_little_u16(&out[pos], v);
+                pos += 2;
+            }
+        }
+    }
+    return out;
+}
+
+Bitmap::Bitmap(ByteView serialized) {
+    using boost::endian::load_little_u16;
+    using boost::endian::load_little_u32;
+    using boost::endian::load_little_u64;
+
+    ByteView in{serialized};
+    auto take{[&in](size_t n) {
+        if (in.length() < n) {
+            throw DecodingError("bitmap: input too short");
+        }
+        const uint8_t* p{in.data()};
+        in.remove_prefix(n);
+        return p;
+    }};
+
+    const uint32_t cookie{load_little_u32(take(4))};
+    size_t n{0};
+    ByteView run_flags{};
+    if ((cookie & 0xFFFF) == kSerialCookie) {
+        n = (cookie >> 16) + 1;
+        run_flags = {take((n + 7) / 8), (n + 7) / 8};
+    } else if (cookie == kSerialCookieNoRunContainer) {
+        n = load_little_u32(take(4));
+    } else {
+        throw DecodingError("bitmap: unknown cookie");
+    }
+    auto is_run{[&run_flags](size_t i) { return !run_flags.empty() && (run_flags[i / 8] >> (i % 8)) & 1; }};
+
+    const uint8_t* header{take(4 * n)};
+    if (run_flags.empty() || n >= kNoOffsetThreshold) {
+        take(4 * n);  // offsets; containers are read in order anyway
+    }
+
+    containers_.resize(n);
+    for (size_t i{0}; i < n; ++i) {
+        Container& c{containers_[i]};
+        c.key = load_little_u16(header + 4 * i);
+        c.cardinality = load_little_u16(header + 4 * i + 2) + 1u;
+        if (i > 0 && c.key <= containers_[i - 1].key) {
+            throw DecodingError("bitmap: unsorted containers");
+        }
+
+        if (is_run(i)) {
+            const size_t num_of_runs{load_little_u16(take(2))};
+            const uint8_t* runs{take(4 * num_of_runs)};
+            if (c.cardinality > kMaxArrayLength) {
+                c.bitset.resize(kBitsetWords);
+            }
+            uint32_t cardinality{0};
+            uint32_t next_start{0};
+            for (size_t r{0}; r < num_of_runs; ++r) {
+                const uint32_t start{load_little_u16(runs + 4 * r)};
+                const uint32_t end{start + load_little_u16(runs + 4 * r + 2)};  // inclusive
+                if (start < next_start || end > 0xFFFF) {
+                    throw DecodingError("bitmap: invalid run");
+                }
+                next_start = end + 1;
+                for (uint32_t v{start}; v <= end; ++v) {
+                    if (c.is_bitset()) {
+                        c.bitset[v / 64] |= uint64_t{1} << (v % 64);
+                    } else {
+                        c.array.push_back(static_cast<uint16_t>(v));
+                    }
+                }
+                cardinality += end - start + 1;
+            }
+            if (cardinality != c.cardinality) {
+                throw DecodingError("bitmap: run cardinality mismatch");
+            }
+        } else if (c.cardinality > kMaxArrayLength) {
+            c.bitset.resize(kBitsetWords);
+            const uint8_t* words{take(kBitsetWords * 8)};
+            for (size_t w{0}; w < kBitsetWords; ++w) {
+                c.bitset[w] = load_little_u64(words + 8 * w);
+            }
+            if (popcount(c.bitset) != c.cardinality) {
+                throw DecodingError("bitmap: bitset cardinality mismatch");
+            }
+        } else {
+            const uint8_t* values{take(2 * c.cardinality)};
+            c.array.resize(c.cardinality);
+            for (size_t v{0}; v < c.cardinality; ++v) {
+                c.array[v] = load_little_u16(values + 2 * v);
+            }
+            if (std::adjacent_find(c.array.begin(), c.array.end(), std::greater_equal<uint16_t>{}) != c.array.end()) {
+                throw DecodingError("bitmap: unsorted array");
+            }
+        }
+    }
+}
+
+}  // namespace silkworm::db::bitmap
@@ -0,0 +1,95 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_BITMAP_H_
+#define SILKWORM_DB_BITMAP_H_
+
+/*
+Compressed bitmaps of 32-bit integers in the portable serialization format of Roaring,
+which Turbo-Geth uses for its log & call indices; see github.com/RoaringBitmap/RoaringFormatSpec
+and Turbo-Geth ethdb/bitmapdb.
+
+Values are split by their upper 16 bits into containers holding the lower 16 bits,
+either as a sorted array (up to kMaxArrayLength values) or as a 2^16 bit bitset.
+Run containers are read, but not written.
+*/
+
+#include <functional>
+#include <silkworm/common/base.hpp>
+#include <vector>
+
+namespace silkworm::db::bitmap {
+
+// Containers with more values are held as bitsets
+constexpr size_t kMaxArrayLength{4096};
+
+class Bitmap {
+  public:
+    Bitmap() = default;
+
+    // Throws DecodingError
+    explicit Bitmap(ByteView serialized);
+
+    Bytes serialize() const;
+
+    // Length of serialize(), without serializing
+    size_t serialized_size() const noexcept;
+
+    bool empty() const noexcept { return containers_.empty(); }
+    uint64_t cardinality() const noexcept;
+
+    // Both require a non-empty bitmap
+    uint32_t minimum() const noexcept;
+    uint32_t maximum() const noexcept;
+
+    bool contains(uint32_t v) const noexcept;
+
+    // Cheapest when values are added in ascending order
+    void add(uint32_t v);
+
+    Bitmap& operator&=(const Bitmap& other);
+    Bitmap& operator|=(const Bitmap& other);
+
+    // Calls f for all the values in ascending order
+    void for_each(const std::function<void(uint32_t)>& f) const;
+
+    std::vector<uint32_t> values() const;
+
+    friend bool operator==(const Bitmap& a, const Bitmap& b) { return a.values() == b.values(); }
+
+  private:
+    struct Container {
+        uint16_t key{0};  // upper 16 bits of the values
+        uint32_t cardinality{0};
+        std::vector<uint16_t> array;   // sorted lower 16 bits, unless a bitset
+        std::vector<uint64_t> bitset;  // 1024 words if a bitset
+
+        bool is_bitset() const noexcept { return !bitset.empty(); }
+        bool contains(uint16_t v) const noexcept;
+        void add(uint16_t v);
+        void to_bitset();
+        void to_array();
+        size_t serialized_size() const noexcept;
+    };
+
+    Container& container(uint16_t key);
+
+    std::vector<Container> containers_;  // sorted by key
+};
+
+}  // namespace silkworm::db::bitmap
+
+#endif  // SILKWORM_DB_BITMAP_H_
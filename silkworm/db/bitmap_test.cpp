@@ -0,0 +1,98 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "bitmap.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkworm::db::bitmap {
+
+TEST_CASE("Roaring bitmap serialization") {
+    Bitmap bitmap;
+    CHECK(to_hex(bitmap.serialize()) == "3a30000000000000");
+    CHECK(Bitmap{bitmap.serialize()}.empty());
+
+    for (uint32_t v : {3u, 1u, 2u, 2u}) {
+        bitmap.add(v);
+    }
+    CHECK(bitmap.cardinality() == 3);
+    CHECK(bitmap.minimum() == 1);
+    CHECK(bitmap.maximum() == 3);
+    CHECK(to_hex(bitmap.serialize()) == "3a300000010000000000020010000000010002000300");
+    CHECK(bitmap.serialized_size() == bitmap.serialize().length());
+
+    // The same values in a run container
+    CHECK(Bitmap{from_hex("3b3000000100000200010001000200")} == bitmap);
+
+    CHECK_THROWS_AS(Bitmap{from_hex("3a300000010000000000020010000000010002")}, DecodingError);
+    CHECK_THROWS_AS(Bitmap{from_hex("3a300000010000000000020010000000010003000200")}, DecodingError);
+    CHECK_THROWS_AS(Bitmap{from_hex("3c30000000000000")}, DecodingError);
+
+    SECTION("bitset containers") {
+        Bitmap large;
+        for (uint32_t v{0}; v < 3 * kMaxArrayLength; v += 2) {
+            large.add(0x10000 + v);
+        }
+        large.add(7);
+        CHECK(large.cardinality() == 3 * kMaxArrayLength / 2 + 1);
+        CHECK(large.minimum() == 7);
+        CHECK(large.maximum() == 0x10000 + 3 * kMaxArrayLength - 2);
+        CHECK(large.contains(0x10002));
+        CHECK(!large.contains(0x10003));
+
+        Bytes serialized{large.serialize()};
+        CHECK(serialized.length() == large.serialized_size());
+        CHECK(Bitmap{serialized} == large);
+    }
+}
+
+TEST_CASE("Roaring bitmap operations") {
+    Bitmap evens, threes;
+    for (uint32_t v{0}; v < 200'000; v += 2) {
+        evens.add(v);
+    }
+    for (uint32_t v{0}; v < 200'000; v += 3) {
+        threes.add(v);
+    }
+    threes.add(1'000'000);
+
+    Bitmap sixes{evens};
+    sixes &= threes;
+    CHECK(sixes.cardinality() == (200'000 + 5) / 6);
+    CHECK(sixes.contains(6));
+    CHECK(!sixes.contains(4));
+    CHECK(!sixes.contains(1'000'000));
+
+    Bitmap any{evens};
+    any |= threes;
+    CHECK(any.cardinality() == evens.cardinality() + threes.cardinality() - sixes.cardinality());
+    CHECK(any.contains(9));
+    CHECK(any.contains(1'000'000));
+    CHECK(!any.contains(7));
+
+    Bitmap sparse;
+    sparse.add(12);
+    sparse.add(13);
+    sparse &= evens;
+    CHECK(sparse.values() == std::vector<uint32_t>{12});
+    sparse |= Bitmap{};
+    CHECK(sparse.values() == std::vector<uint32_t>{12});
+    sparse &= Bitmap{};
+    CHECK(sparse.empty());
+}
+
+}  // namespace silkworm::db::bitmap
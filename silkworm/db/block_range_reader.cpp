@@ -0,0 +1,141 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "block_range_reader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <silkworm/common/util.hpp>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+void BlockRangeReader::Cursor::advance_to(ByteView target) {
+    if (!positioned) {
+        key = to_mdb_val(target);
+        rc = table->seek(&key, &data);
+        if (rc != MDB_NOTFOUND) {
+            lmdb::err_handler(rc);
+        }
+        positioned = true;
+        return;
+    }
+    // Blocks are read in order, so the target is at most a few entries (those of other forks) away
+    while (rc == MDB_SUCCESS && current_key() < target) {
+        next();
+    }
+}
+
+ByteView BlockRangeReader::Cursor::current_key() const { return from_mdb_val(key); }
+
+void BlockRangeReader::Cursor::next() {
+    rc = table->get_next(&key, &data);
+    if (rc != MDB_NOTFOUND) {
+        lmdb::err_handler(rc);
+    }
+}
+
+std::optional<ByteView> BlockRangeReader::find(Cursor& cursor, ByteView key) {
+    cursor.advance_to(key);
+    if (cursor.rc != MDB_SUCCESS || cursor.current_key() != key) {
+        return std::nullopt;
+    }
+    return from_mdb_val(cursor.data);
+}
+
+BlockRangeReader::BlockRangeReader(lmdb::Transaction& txn, uint64_t from, uint64_t to, bool read_senders)
+    : block_number_{from}, to_{to}, read_senders_{read_senders} {
+    headers_.table = txn.open(table::kBlockHeaders);
+    bodies_.table = txn.open(table::kBlockBodies);
+    if (read_senders) {
+        senders_.table = txn.open(table::kSenders);
+    }
+}
+
+std::optional<evmc::bytes32> BlockRangeReader::next(BlockView& out) {
+    if (exhausted_ || block_number_ > to_) {
+        exhausted_ = true;
+        return std::nullopt;
+    }
+    exhausted_ = true;  // in case read throws
+    std::optional<evmc::bytes32> hash{read(out)};
+    if (hash) {
+        exhausted_ = false;
+        ++block_number_;
+    }
+    return hash;
+}
+
+std::optional<evmc::bytes32> BlockRangeReader::read(BlockView& out) {
+    // All the entries of a height are adjacent, with the canonical hash sorting anywhere among the headers
+    const Bytes hash_key{header_hash_key(block_number_)};
+    const ByteView height{hash_key.data(), sizeof(uint64_t)};
+    std::optional<ByteView> canonical_hash{};
+    headers_at_height_.clear();
+    for (headers_.advance_to(height); headers_.rc == MDB_SUCCESS; headers_.next()) {
+        ByteView key{headers_.current_key()};
+        if (!has_prefix(key, height)) {
+            break;
+        }
+        if (key == hash_key) {
+            canonical_hash = from_mdb_val(headers_.data);
+        } else if (key.length() == sizeof(uint64_t) + kHashLength) {
+            headers_at_height_.emplace_back(key.substr(sizeof(uint64_t)), from_mdb_val(headers_.data));
+        }
+    }
+    if (!canonical_hash) {
+        return std::nullopt;
+    }
+
+    auto it{std::find_if(headers_at_height_.begin(), headers_at_height_.end(),
+                         [&canonical_hash](const auto& header) { return header.first == *canonical_hash; })};
+    if (it == headers_at_height_.end()) {
+        return std::nullopt;
+    }
+
+    evmc::bytes32 hash;
+    assert(canonical_hash->size() == kHashLength);
+    std::memcpy(hash.bytes, canonical_hash->data(), kHashLength);
+
+    ByteView header_rlp{it->second};
+    rlp::decode(header_rlp, out.header);
+
+    const Bytes key{block_key(block_number_, hash.bytes)};
+    std::optional<ByteView> body_rlp{find(bodies_, key)};
+    if (!body_rlp) {
+        return std::nullopt;
+    }
+
+    rlp::decode_body(*body_rlp, out);
+
+    if (read_senders_) {
+        ByteView senders{find(senders_, key).value_or(ByteView{})};
+        if (senders.length() != out.transactions.size() * kAddressLength) {
+            throw MissingSenders("senders count does not match transactions count");
+        }
+        for (size_t i{0}; i < out.transactions.size(); ++i) {
+            std::memcpy(out.transactions[i].from.emplace().bytes, &senders[i * kAddressLength], kAddressLength);
+        }
+    }
+
+    return hash;
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,94 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_BLOCK_RANGE_READER_H_
+#define SILKWORM_DB_BLOCK_RANGE_READER_H_
+
+#include <evmc/evmc.hpp>
+#include <memory>
+#include <optional>
+#include <silkworm/common/base.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/types/block_view.hpp>
+#include <vector>
+
+namespace silkworm::db {
+
+/** @brief Reads the canonical blocks of a range in order through forward cursors.
+ *
+ * Same as calling read_block for each block of [from; to], but rather than three or four point lookups per block,
+ * kBlockHeaders, kBlockBodies and kSenders are each walked with a single cursor, merged on the block key.
+ * Headers and bodies of non-canonical blocks are stepped over, as only the header whose hash is stored
+ * under the canonical hash key of its number is returned.
+ * The views of the blocks read are only valid for the lifetime of the transaction.
+ */
+class BlockRangeReader {
+  public:
+    BlockRangeReader(lmdb::Transaction& txn, uint64_t from, uint64_t to, bool read_senders);
+
+    BlockRangeReader(const BlockRangeReader&) = delete;
+    BlockRangeReader& operator=(const BlockRangeReader&) = delete;
+
+    /** @brief Decodes the next block into out, reusing its capacity; see read_block.
+     *
+     * Might throw MissingSenders.
+     * @return The block hash, or nothing past the end of the range or of the canonical chain,
+     * in which case the reader stays exhausted.
+     */
+    std::optional<evmc::bytes32> next(BlockView& out);
+
+    // Number of the block to be read by the next call
+    uint64_t block_number() const { return block_number_; }
+
+  private:
+    // Forward cursor over a table, positioned lazily
+    struct Cursor {
+        std::unique_ptr<lmdb::Table> table;
+        MDB_val key{};
+        MDB_val data{};
+        int rc{MDB_NOTFOUND};
+        bool positioned{false};
+
+        // Moves to the first entry with a key >= target, which must not be before the current one
+        void advance_to(ByteView target);
+
+        ByteView current_key() const;
+
+        void next();
+    };
+
+    // Reads block block_number_
+    std::optional<evmc::bytes32> read(BlockView& out);
+
+    // Value of key in cursor's table, moving it forward
+    static std::optional<ByteView> find(Cursor& cursor, ByteView key);
+
+    uint64_t block_number_;
+    uint64_t to_;
+    bool read_senders_;
+    bool exhausted_{false};
+
+    Cursor headers_;
+    Cursor bodies_;
+    Cursor senders_;
+
+    // Keys & values of all the headers at the current height, canonical or not
+    std::vector<std::pair<ByteView, ByteView>> headers_at_height_;
+};
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_BLOCK_RANGE_READER_H_
@@ -0,0 +1,175 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "block_range_reader.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/block.hpp>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+// Hashes of the three headers at every height. The header hash key ('n') sorts between them.
+static evmc::bytes32 fork_hash(uint64_t block_number, unsigned fork) {
+    evmc::bytes32 hash{};
+    hash.bytes[0] = static_cast<uint8_t>(0x10 + fork * 0x70);  // 0x10, 0x80 & 0xf0
+    hash.bytes[31] = static_cast<uint8_t>(block_number);
+    return hash;
+}
+
+// Writes the header, TD, body & senders of a fork of a block.
+// The hash isn't the actual hash of the header, which the reader doesn't check.
+static void write_fork(lmdb::Transaction& txn, uint64_t block_number, unsigned fork) {
+    const evmc::bytes32 hash{fork_hash(block_number, fork)};
+    const Bytes key{block_key(block_number, hash.bytes)};
+
+    BlockHeader header;
+    header.number = block_number;
+    header.gas_limit = 1'000 + fork;
+    Bytes encoded_header;
+    rlp::encode(encoded_header, header);
+    txn.open(table::kBlockHeaders)->put(key, encoded_header);
+
+    Bytes td_key{key};
+    td_key.push_back('t');
+    txn.open(table::kBlockHeaders)->put(td_key, from_hex("01"));
+
+    BlockBody body;
+    body.transactions.resize((block_number + fork) % 4);
+    for (size_t i{0}; i < body.transactions.size(); ++i) {
+        body.transactions[i].nonce = block_number * 10 + fork * 100 + i;
+        body.transactions[i].data = Bytes(i, '\xab');
+        body.transactions[i].v = 27;
+        body.transactions[i].r = 1;
+        body.transactions[i].s = 2;
+    }
+    body.ommers.resize(block_number % 3 == 0 ? 1 : 0);
+    Bytes encoded_body;
+    rlp::encode(encoded_body, body);
+    txn.open(table::kBlockBodies)->put(key, encoded_body);
+
+    if (!body.transactions.empty()) {
+        Bytes senders(body.transactions.size() * kAddressLength, static_cast<uint8_t>(block_number + fork));
+        txn.open(table::kSenders)->put(key, senders);
+    }
+}
+
+// Checks that the reader returns the same as read_block for every block of [from; to], then nothing
+static void check_blocks(lmdb::Transaction& txn, BlockRangeReader& reader, uint64_t from, uint64_t to,
+                         bool read_senders) {
+    BlockView view;
+    for (uint64_t block_number{from}; block_number <= to; ++block_number) {
+        REQUIRE(reader.block_number() == block_number);
+        std::optional<evmc::bytes32> hash{reader.next(view)};
+        std::optional<BlockWithHash> expected{read_block(txn, block_number, read_senders)};
+        REQUIRE(hash);
+        REQUIRE(expected);
+
+        CHECK(*hash == expected->hash);
+        CHECK(*hash == fork_hash(block_number, block_number % 3));
+        CHECK(view.header == expected->block.header);
+        REQUIRE(view.transactions.size() == expected->block.transactions.size());
+        for (size_t i{0}; i < view.transactions.size(); ++i) {
+            CHECK(view.transactions[i].nonce == expected->block.transactions[i].nonce);
+            CHECK(view.transactions[i].data == ByteView{expected->block.transactions[i].data});
+            CHECK(view.transactions[i].from == expected->block.transactions[i].from);
+        }
+        CHECK(view.ommers == expected->block.ommers);
+    }
+    CHECK(!reader.next(view));
+    CHECK(!reader.next(view));
+}
+
+TEST_CASE("Block range reader") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    // The canonical fork rotates, so that non-canonical headers sort both before and after the header hash key
+    const uint64_t last_block{9};
+    for (uint64_t block_number{0}; block_number <= last_block; ++block_number) {
+        for (unsigned fork{0}; fork < 3; ++fork) {
+            write_fork(*txn, block_number, fork);
+        }
+        const evmc::bytes32 canonical_hash{fork_hash(block_number, block_number % 3)};
+        txn->open(table::kBlockHeaders)->put(header_hash_key(block_number), full_view(canonical_hash));
+    }
+
+    const Bytes key5{block_key(5, fork_hash(5, 5 % 3).bytes)};
+
+    SECTION("whole chain") {
+        BlockRangeReader reader{*txn, 0, last_block, /*read_senders=*/true};
+        check_blocks(*txn, reader, 0, last_block, true);
+    }
+
+    SECTION("without senders") {
+        BlockRangeReader reader{*txn, 4, 6, /*read_senders=*/false};
+        check_blocks(*txn, reader, 4, 6, false);
+    }
+
+    SECTION("past the chain") {
+        BlockRangeReader reader{*txn, 7, 1'000, /*read_senders=*/true};
+        check_blocks(*txn, reader, 7, last_block, true);
+        CHECK(reader.block_number() == last_block + 1);
+    }
+
+    SECTION("missing canonical header") {
+        txn->open(table::kBlockHeaders)->del(key5);
+        CHECK(!read_block(*txn, 5, true));
+        BlockRangeReader reader{*txn, 2, last_block, /*read_senders=*/true};
+        check_blocks(*txn, reader, 2, 4, true);
+    }
+
+    SECTION("missing canonical hash") {
+        txn->open(table::kBlockHeaders)->del(header_hash_key(5));
+        CHECK(!read_block(*txn, 5, true));
+        BlockRangeReader reader{*txn, 2, last_block, /*read_senders=*/true};
+        check_blocks(*txn, reader, 2, 4, true);
+    }
+
+    SECTION("missing body") {
+        txn->open(table::kBlockBodies)->del(key5);
+        CHECK(!read_block(*txn, 5, true));
+        BlockRangeReader reader{*txn, 2, last_block, /*read_senders=*/true};
+        check_blocks(*txn, reader, 2, 4, true);
+    }
+
+    SECTION("missing senders") {
+        // Block 5 has (5 + 2) % 4 = 3 transactions
+        txn->open(table::kSenders)->put(key5, Bytes(2 * kAddressLength, '\0'));
+        CHECK_THROWS_AS(read_block(*txn, 5, true), MissingSenders);
+
+        BlockRangeReader reader{*txn, 4, last_block, /*read_senders=*/true};
+        BlockView view;
+        CHECK(reader.next(view));
+        CHECK_THROWS_AS(reader.next(view), MissingSenders);
+        CHECK(!reader.next(view));
+
+        BlockRangeReader without_senders{*txn, 4, last_block, /*read_senders=*/false};
+        check_blocks(*txn, without_senders, 4, last_block, false);
+    }
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,368 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "bloom_bits.hpp"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <array>
+#include <boost/endian/conversion.hpp>
+#include <cassert>
+#include <cstring>
+#include <optional>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/decode.hpp>
+#include <silkworm/types/block.hpp>
+#include <string>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db::bloom_bits {
+
+constexpr const char* kCountKey{"count"};
+constexpr const char* kSectionHeadPrefix{"shead"};
+
+constexpr size_t kVectorLength{kSectionSize / 8};
+
+static void bitset_encode(ByteView data, Bytes& out) {
+    if (data.empty()) {
+        return;
+    }
+    if (data.length() == 1) {
+        if (data[0] != 0) {
+            out.push_back(data[0]);
+        }
+        return;
+    }
+
+    Bytes non_zero_bitset((data.length() + 7) / 8, '\0');
+    Bytes non_zero_bytes{};
+    for (size_t i{0}; i < data.length(); ++i) {
+        if (data[i] != 0) {
+            non_zero_bytes.push_back(data[i]);
+            non_zero_bitset[i / 8] |= 1 << (7 - i % 8);
+        }
+    }
+    if (non_zero_bytes.empty()) {
+        return;
+    }
+    bitset_encode(non_zero_bitset, out);
+    out.append(non_zero_bytes);
+}
+
+Bytes compress(ByteView data) {
+    Bytes out{};
+    bitset_encode(data, out);
+    if (out.length() < data.length()) {
+        return out;
+    }
+    return Bytes{data};
+}
+
+// Decodes the prefix of data that makes up target bytes, returning the length of the prefix
+static size_t bitset_decode(ByteView data, uint8_t* out, size_t target) {
+    if (target == 0 || data.empty()) {
+        return 0;
+    }
+    if (target == 1) {
+        out[0] = data[0];
+        return data[0] != 0 ? 1 : 0;
+    }
+
+    Bytes non_zero_bitset((target + 7) / 8, '\0');
+    size_t ptr{bitset_decode(data, non_zero_bitset.data(), non_zero_bitset.length())};
+    for (size_t i{0}; i < 8 * non_zero_bitset.length(); ++i) {
+        if (non_zero_bitset[i / 8] & (1 << (7 - i % 8))) {
+            if (ptr >= data.length()) {
+                throw DecodingError("bloom bits: missing data");
+            }
+            if (i >= target) {
+                throw DecodingError("bloom bits: target exceeded");
+            }
+            if (data[ptr] == 0) {
+                throw DecodingError("bloom bits: zero content");
+            }
+            out[i] = data[ptr++];
+        }
+    }
+    return ptr;
+}
+
+Bytes decompress(ByteView data, size_t target_length) {
+    if (data.length() > target_length) {
+        throw DecodingError("bloom bits: target exceeded");
+    }
+    if (data.length() == target_length) {
+        return Bytes{data};
+    }
+    Bytes out(target_length, '\0');
+    if (bitset_decode(data, out.data(), target_length) != data.length()) {
+        throw DecodingError("bloom bits: unreferenced data");
+    }
+    return out;
+}
+
+Generator::Generator() : vectors_{new uint8_t[kNumOfBits * kVectorLength]{}} {}
+
+void Generator::add_bloom(uint64_t index, const Bloom& bloom) {
+    assert(index < kSectionSize);
+    const size_t byte_index{index / 8};
+    const auto bit_mask{static_cast<uint8_t>(1 << (7 - index % 8))};
+    for (size_t bit{0}; bit < kNumOfBits; ++bit) {
+        // Bits are numbered from the end of the bloom, as in m3_2048
+        if (bloom[kBloomByteLength - 1 - bit / 8] & (1 << (bit % 8))) {
+            vectors_[bit * kVectorLength + byte_index] |= bit_mask;
+        }
+    }
+}
+
+ByteView Generator::bit_vector(size_t bit) const { return {&vectors_[bit * kVectorLength], kVectorLength}; }
+
+static Bytes section_head_key(uint64_t section) {
+    Bytes key{byte_view_of_c_str(kSectionHeadPrefix)};
+    key.resize(key.length() + 8);
+    boost::endian::store_big_u64(&key[key.length() - 8], section);
+    return key;
+}
+
+static Bytes bit_vector_key(size_t bit, uint64_t section, ByteView head) {
+    Bytes key(2 + 8, '\0');
+    boost::endian::store_big_u16(&key[0], static_cast<uint16_t>(bit));
+    boost::endian::store_big_u64(&key[2], section);
+    key.append(head);
+    return key;
+}
+
+uint64_t num_of_sections(lmdb::Transaction& txn) {
+    auto index_table{txn.open(table::kBloomBitsIndex, MDB_CREATE)};
+    std::optional<ByteView> count{index_table->get(byte_view_of_c_str(kCountKey))};
+    if (!count) {
+        return 0;
+    }
+    if (count->length() != 8) {
+        throw DecodingError("unexpected bloom bits section count length");
+    }
+    return boost::endian::load_big_u64(count->data());
+}
+
+// Canonical header with its hash
+static std::optional<std::pair<BlockHeader, evmc::bytes32>> read_canonical_header(lmdb::Table& header_table,
+                                                                                  uint64_t block_number) {
+    std::optional<ByteView> hash{header_table.get(header_hash_key(block_number))};
+    if (!hash) {
+        return std::nullopt;
+    }
+    assert(hash->length() == kHashLength);
+    std::pair<BlockHeader, evmc::bytes32> res{};
+    std::memcpy(res.second.bytes, hash->data(), kHashLength);
+
+    std::optional<ByteView> rlp{header_table.get(block_key(block_number, res.second.bytes))};
+    if (!rlp) {
+        return std::nullopt;
+    }
+    rlp::decode(*rlp, res.first);
+    return res;
+}
+
+uint64_t build(lmdb::Transaction& txn, uint64_t to) {
+    uint64_t section{num_of_sections(txn)};
+
+    auto header_table{txn.open(table::kBlockHeaders)};
+    auto bits_table{txn.open(table::kBloomBits, MDB_CREATE)};
+    auto index_table{txn.open(table::kBloomBitsIndex, MDB_CREATE)};
+
+    for (; (section + 1) * kSectionSize - 1 <= to; ++section) {
+        Generator generator;
+        evmc::bytes32 head{};
+        for (uint64_t i{0}; i < kSectionSize; ++i) {
+            auto header{read_canonical_header(*header_table, section * kSectionSize + i)};
+            if (!header) {
+                return section;
+            }
+            generator.add_bloom(i, header->first.logs_bloom);
+            head = header->second;
+        }
+
+        for (size_t bit{0}; bit < kNumOfBits; ++bit) {
+            bits_table->put(bit_vector_key(bit, section, full_view(head)), compress(generator.bit_vector(bit)));
+        }
+        index_table->put(section_head_key(section), full_view(head));
+
+        Bytes count(8, '\0');
+        boost::endian::store_big_u64(&count[0], section + 1);
+        index_table->put(byte_view_of_c_str(kCountKey), count);
+    }
+
+    return section;
+}
+
+namespace {
+
+    // Bit vector of a section held in words, so that vectors are combined a word (or SIMD register) at a time
+    using BitVector = std::array<uint64_t, kVectorLength / sizeof(uint64_t)>;
+
+    // Bloom bits of an address or topic
+    using BloomBits = std::array<uint16_t, 3>;
+
+    // The filter as bloom bits: for every group (the addresses, then every topic position constrained)
+    // a block must match one of its values, i.e. have all the bits of the value set
+    using BloomFilter = std::vector<std::vector<BloomBits>>;
+
+}  // namespace
+
+static BloomBits bloom_bits(ByteView value) {
+    ethash::hash256 hash{keccak256(value)};
+    BloomBits res;
+    for (size_t i{0}; i < 3; ++i) {
+        res[i] = ((hash.bytes[2 * i] << 8) | hash.bytes[2 * i + 1]) & (kNumOfBits - 1);
+    }
+    return res;
+}
+
+static BloomFilter to_bloom_filter(const LogFilter& filter) {
+    BloomFilter res;
+    if (!filter.addresses.empty()) {
+        std::vector<BloomBits>& group{res.emplace_back()};
+        for (const evmc::address& address : filter.addresses) {
+            group.push_back(bloom_bits(full_view(address)));
+        }
+    }
+    for (const std::vector<evmc::bytes32>& topics : filter.topics) {
+        if (topics.empty()) {
+            continue;
+        }
+        std::vector<BloomBits>& group{res.emplace_back()};
+        for (const evmc::bytes32& topic : topics) {
+            group.push_back(bloom_bits(full_view(topic)));
+        }
+    }
+    return res;
+}
+
+// Plain loops over whole words, which compilers turn into SIMD instructions
+static void and_into(BitVector& to, const BitVector& v) {
+    for (size_t i{0}; i < to.size(); ++i) {
+        to[i] &= v[i];
+    }
+}
+
+static void or_into(BitVector& to, const BitVector& v) {
+    for (size_t i{0}; i < to.size(); ++i) {
+        to[i] |= v[i];
+    }
+}
+
+static bool is_zero(const BitVector& v) {
+    uint64_t acc{0};
+    for (uint64_t word : v) {
+        acc |= word;
+    }
+    return acc == 0;
+}
+
+// Blocks of a section whose blooms may match
+static BitVector match_section(lmdb::Table& bits_table, uint64_t section, ByteView head, const BloomFilter& filter) {
+    absl::flat_hash_map<uint16_t, BitVector> vectors;
+    auto vector{[&](uint16_t bit) -> const BitVector& {
+        auto [it, inserted]{vectors.try_emplace(bit)};
+        if (inserted) {
+            std::optional<ByteView> compressed{bits_table.get(bit_vector_key(bit, section, head))};
+            if (!compressed) {
+                throw DecodingError("missing bloom bits of section " + std::to_string(section));
+            }
+            Bytes bytes{decompress(*compressed, kVectorLength)};
+            std::memcpy(it->second.data(), bytes.data(), kVectorLength);
+        }
+        return it->second;
+    }};
+
+    BitVector res;
+    res.fill(~uint64_t{0});
+    for (const std::vector<BloomBits>& group : filter) {
+        BitVector group_res{};
+        for (const BloomBits& bits : group) {
+            BitVector value_res{vector(bits[0])};
+            and_into(value_res, vector(bits[1]));
+            and_into(value_res, vector(bits[2]));
+            or_into(group_res, value_res);
+        }
+        and_into(res, group_res);
+        if (is_zero(res)) {
+            break;
+        }
+    }
+    return res;
+}
+
+std::vector<uint64_t> match(lmdb::Transaction& txn, const LogFilter& filter, uint64_t from, uint64_t to) {
+    std::vector<uint64_t> res;
+    if (from > to) {
+        return res;
+    }
+
+    const BloomFilter bloom_filter{to_bloom_filter(filter)};
+    const uint64_t num_of_sections{bloom_bits::num_of_sections(txn)};
+
+    auto bits_table{txn.open(table::kBloomBits, MDB_CREATE)};
+    auto index_table{txn.open(table::kBloomBitsIndex, MDB_CREATE)};
+
+    uint64_t block_number{from};
+    for (uint64_t section{from / kSectionSize}; section < num_of_sections && block_number <= to; ++section) {
+        const uint64_t section_end{(section + 1) * kSectionSize};  // exclusive
+        if (bloom_filter.empty()) {
+            for (; block_number < section_end && block_number <= to; ++block_number) {
+                res.push_back(block_number);
+            }
+            continue;
+        }
+
+        std::optional<ByteView> head{index_table->get(section_head_key(section))};
+        if (!head) {
+            throw DecodingError("missing head of bloom bits section " + std::to_string(section));
+        }
+        const BitVector candidates{match_section(*bits_table, section, *head, bloom_filter)};
+        if (is_zero(candidates)) {
+            block_number = section_end;
+            continue;
+        }
+
+        // Words hold the bytes of the vector in memory order
+        const auto* bytes{reinterpret_cast<const uint8_t*>(candidates.data())};
+        for (; block_number < section_end && block_number <= to; ++block_number) {
+            const uint64_t index{block_number - section * kSectionSize};
+            if (bytes[index / 8] & (1 << (7 - index % 8))) {
+                res.push_back(block_number);
+            }
+        }
+    }
+
+    // Past the indexed sections
+    auto header_table{txn.open(table::kBlockHeaders)};
+    for (; block_number <= to; ++block_number) {
+        auto header{read_canonical_header(*header_table, block_number)};
+        if (!header) {
+            break;
+        }
+        if (filter.may_match(header->first.logs_bloom)) {
+            res.push_back(block_number);
+        }
+    }
+
+    return res;
+}
+
+}  // namespace silkworm::db::bloom_bits
@@ -0,0 +1,84 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_BLOOM_BITS_H_
+#define SILKWORM_DB_BLOOM_BITS_H_
+
+/*
+Part of the compatibility layer with the Turbo-Geth DB format;
+see core/bloombits, core/chain_indexer.go & common/bitutil of go-ethereum.
+
+Headers are indexed in sections of kSectionSize blocks. For every one of the 2048 bits of the logs bloom
+and every section, kBloomBits holds a bit vector telling which headers of the section have the bloom bit set,
+one bit per block, the first block being the most significant bit of the first byte:
+    bit (uint16 BE) + section (uint64 BE) + section head hash -> compressed bit vector
+The section head is its last block.
+kBloomBitsIndex holds the number of sections indexed under "count" (uint64 BE)
+and the head hash of every section under "shead" + section (uint64 BE).
+*/
+
+#include <memory>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/log_filter.hpp>
+#include <silkworm/types/bloom.hpp>
+#include <vector>
+
+namespace silkworm::db::bloom_bits {
+
+constexpr uint64_t kSectionSize{4096};
+constexpr size_t kNumOfBits{kBloomByteLength * 8};
+
+// Sparse bitset compression of go-ethereum bitutil.CompressBytes
+Bytes compress(ByteView data);
+
+// Inverse of compress. Throws DecodingError.
+Bytes decompress(ByteView data, size_t target_length);
+
+// Rotates the blooms of a section into bit vectors; see go-ethereum bloombits.Generator
+class Generator {
+  public:
+    Generator();
+
+    // index is the position of the block within the section
+    void add_bloom(uint64_t index, const Bloom& bloom);
+
+    // Uncompressed bit vector of a bloom bit
+    ByteView bit_vector(size_t bit) const;
+
+  private:
+    std::unique_ptr<uint8_t[]> vectors_;
+};
+
+/** @brief Indexes the complete sections of headers [0; to] not indexed yet.
+ *
+ * Stops early at a missing canonical header.
+ * @return The number of sections indexed in total.
+ */
+uint64_t build(lmdb::Transaction& txn, uint64_t to);
+
+// Number of sections indexed, as kept in kBloomBitsIndex
+uint64_t num_of_sections(lmdb::Transaction& txn);
+
+/** @brief Blocks in [from; to] whose logs bloom may match the filter, in ascending order.
+ *
+ * The bit vectors of indexed sections are combined section by section, blocks past them are checked
+ * against the blooms of their headers.
+ */
+std::vector<uint64_t> match(lmdb::Transaction& txn, const LogFilter& filter, uint64_t from, uint64_t to);
+
+}  // namespace silkworm::db::bloom_bits
+
+#endif  // SILKWORM_DB_BLOOM_BITS_H_
@@ -0,0 +1,211 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "bloom_bits.hpp"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <silkworm/common/base.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/block.hpp>
+#include <tuple>
+#include <vector>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db::bloom_bits {
+
+TEST_CASE("Bloom bits compression") {
+    // go-ethereum common/bitutil TestCompression
+    Bytes in{from_hex("4912385c0e7b64000000")};
+    Bytes out{from_hex("80fe4912385c0e7b64")};
+    CHECK(compress(in) == out);
+    CHECK(decompress(out, in.length()) == in);
+
+    // Left as is when the encoding isn't shorter
+    Bytes dense{from_hex("df7070533534333636313639343638373532313536346c1bc33339343837313070706336343035336336346c")};
+    CHECK(compress(dense) == dense);
+    CHECK(decompress(dense, dense.length()) == dense);
+
+    CHECK(compress(Bytes(kSectionSize / 8, '\0')).empty());
+    CHECK(decompress({}, kSectionSize / 8) == Bytes(kSectionSize / 8, '\0'));
+
+    Bytes sparse(kSectionSize / 8, '\0');
+    sparse[0] = 0x80;
+    sparse[100] = 0x11;
+    sparse[511] = 0x01;
+    CHECK(decompress(compress(sparse), sparse.length()) == sparse);
+
+    CHECK_THROWS_AS(decompress(from_hex("80"), 9), DecodingError);        // missing data
+    CHECK_THROWS_AS(decompress(from_hex("8080ff01"), 9), DecodingError);  // unreferenced data
+    CHECK_THROWS_AS(decompress(out, 2), DecodingError);                    // target exceeded
+}
+
+TEST_CASE("Bloom bits generator") {
+    Generator generator;
+    Bloom bloom{};
+    bloom[kBloomByteLength - 1] = 0x01;  // bit 0
+    generator.add_bloom(0, bloom);
+    bloom = {};
+    bloom[0] = 0x80;  // bit 2047
+    generator.add_bloom(9, bloom);
+    generator.add_bloom(kSectionSize - 1, bloom);
+
+    CHECK(to_hex(generator.bit_vector(0).substr(0, 2)) == "8000");
+    CHECK(to_hex(generator.bit_vector(2047).substr(0, 2)) == "0040");
+    CHECK(generator.bit_vector(2047).back() == 0x01);
+    CHECK(generator.bit_vector(1) == Bytes(kSectionSize / 8, '\0'));
+}
+
+TEST_CASE("Log filter against blooms") {
+    Log log{0x22341ae42d6dd7384bc8584e50419ea3ac75b83f_address,
+            {0x04491edcd115127caedbd478e2e7895ed80c7847e903431f94f9cfa579cad47f_bytes32}};
+    Bloom bloom{logs_bloom({log})};
+
+    LogFilter filter;
+    CHECK(filter.matches(log));
+    CHECK(filter.may_match(bloom));
+
+    filter.addresses = {0x0000000000000000000000000000000000000001_address, log.address};
+    CHECK(filter.matches(log));
+    CHECK(filter.may_match(bloom));
+
+    filter.topics = {{}, {log.topics[0]}};
+    CHECK(!filter.matches(log));  // fewer topics than positions
+
+    filter.topics = {{log.topics[0]}};
+    CHECK(filter.matches(log));
+    CHECK(filter.may_match(bloom));
+
+    filter.addresses = {0x0000000000000000000000000000000000000001_address};
+    CHECK(!filter.matches(log));
+    CHECK(!filter.may_match(bloom));
+}
+
+// Writes the canonical header of a block and the logs of its transactions
+static void write_block(lmdb::Transaction& txn, uint64_t block_number,
+                        const std::map<uint32_t, std::vector<Log>>& logs_by_transaction) {
+    std::vector<Log> all_logs;
+    for (const auto& [transaction_index, logs] : logs_by_transaction) {
+        txn.open(table::kLogs)->put(log_key(block_number, transaction_index), cbor_encode(logs));
+        all_logs.insert(all_logs.end(), logs.begin(), logs.end());
+    }
+
+    BlockHeader header;
+    header.number = block_number;
+    header.logs_bloom = logs_bloom(all_logs);
+    Bytes encoded_header;
+    rlp::encode(encoded_header, header);
+    ethash::hash256 hash{keccak256(encoded_header)};
+    txn.open(table::kBlockHeaders)->put(header_hash_key(block_number), full_view(hash.bytes));
+    txn.open(table::kBlockHeaders)->put(block_key(block_number, hash.bytes), encoded_header);
+}
+
+TEST_CASE("Bloom bits index") {
+    using namespace evmc::literals;
+
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const auto a{0x000000000000000000000000000000000000000a_address};
+    const auto b{0x000000000000000000000000000000000000000b_address};
+    const auto c{0x000000000000000000000000000000000000000c_address};
+    const auto t{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto u{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+
+    // A full section and a partial one
+    const uint64_t last_block{kSectionSize + 103};
+    const std::map<uint64_t, std::map<uint32_t, std::vector<Log>>> logs{
+        {5, {{0, {{a, {t}}}}}},
+        {2000, {{0, {{b, {}}}}, {1, {{b, {t}}}}}},
+        {kSectionSize - 1, {{0, {{a, {}}}}}},
+        {kSectionSize, {{0, {{a, {u}}}}}},
+        {kSectionSize + 54, {{2, {{c, {}}, {b, {t, u}}}}}},
+    };
+    for (uint64_t block_number{0}; block_number <= last_block; ++block_number) {
+        auto it{logs.find(block_number)};
+        write_block(*txn, block_number, it != logs.end() ? it->second : std::map<uint32_t, std::vector<Log>>{});
+    }
+
+    CHECK(num_of_sections(*txn) == 0);
+    CHECK(build(*txn, kSectionSize - 2) == 0);
+    CHECK(build(*txn, last_block) == 1);
+    CHECK(num_of_sections(*txn) == 1);
+    CHECK(build(*txn, last_block) == 1);
+
+    LogFilter filter;
+
+    SECTION("match") {
+        // Everything up to the last header
+        std::vector<uint64_t> blocks{match(*txn, filter, kSectionSize - 2, last_block + 10)};
+        REQUIRE(blocks.size() == 106);
+        CHECK(blocks.front() == kSectionSize - 2);
+        CHECK(blocks.back() == last_block);
+
+        filter.addresses = {a};
+        CHECK(match(*txn, filter, 0, last_block) == std::vector<uint64_t>{5, kSectionSize - 1, kSectionSize});
+        CHECK(match(*txn, filter, 6, kSectionSize) == std::vector<uint64_t>{kSectionSize - 1, kSectionSize});
+        CHECK(match(*txn, filter, kSectionSize, kSectionSize - 1).empty());
+
+        filter.addresses = {a, c};
+        CHECK(match(*txn, filter, 6, last_block) ==
+              std::vector<uint64_t>{kSectionSize - 1, kSectionSize, kSectionSize + 54});
+
+        filter.addresses = {};
+        filter.topics = {{t}};
+        CHECK(match(*txn, filter, 0, last_block) == std::vector<uint64_t>{5, 2000, kSectionSize + 54});
+
+        filter.addresses = {b};
+        filter.topics = {{}, {u}};
+        CHECK(match(*txn, filter, 0, last_block) == std::vector<uint64_t>{kSectionSize + 54});
+    }
+
+    SECTION("get_logs") {
+        const auto positions{[](const std::vector<FilteredLog>& filtered) {
+            std::vector<std::tuple<uint64_t, uint32_t, uint32_t>> res;
+            for (const FilteredLog& log : filtered) {
+                res.emplace_back(log.block_number, log.transaction_index, log.log_index);
+            }
+            return res;
+        }};
+
+        filter.addresses = {b};
+        filter.topics = {{t}};
+        std::vector<FilteredLog> filtered{get_logs(*txn, filter, 0, last_block)};
+        CHECK(positions(filtered) ==
+              std::vector<std::tuple<uint64_t, uint32_t, uint32_t>>{{2000, 1, 1}, {kSectionSize + 54, 2, 1}});
+        CHECK(filtered[1].log.topics == std::vector<evmc::bytes32>{t, u});
+
+        filter.addresses = {a};
+        filter.topics = {};
+        CHECK(positions(get_logs(*txn, filter, 5, kSectionSize - 1)) ==
+              std::vector<std::tuple<uint64_t, uint32_t, uint32_t>>{{5, 0, 0}, {kSectionSize - 1, 0, 0}});
+
+        filter.addresses = {};
+        filter.topics = {{t, u}, {u}};
+        CHECK(positions(get_logs(*txn, filter, 0, last_block)) ==
+              std::vector<std::tuple<uint64_t, uint32_t, uint32_t>>{{kSectionSize + 54, 2, 1}});
+    }
+}
+
+}  // namespace silkworm::db::bloom_bits
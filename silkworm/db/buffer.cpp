@@ -20,6 +20,7 @@
 
 #include <boost/endian/conversion.hpp>
 #include <silkworm/common/util.hpp>
+#include <silkworm/crypto/keccak.hpp>
 
 #include "access_layer.hpp"
 #include "tables.hpp"
@@ -45,11 +46,13 @@ void Buffer::end_block() {
     Bytes block_key{encode_timestamp(current_block_number_)};
 
     auto account_change_table{txn_->open(table::kPlainAccountChangeSet)};
-    account_change_table->put(block_key, account_changes_.encode());
+    account_changes_.encode(encoded_changes_);
+    account_change_table->put(block_key, encoded_changes_);
 
     if (!storage_changes_.empty()) {
         auto storage_change_table{txn_->open(table::kPlainStorageChangeSet)};
-        storage_change_table->put(block_key, storage_changes_.encode());
+        storage_changes_.encode(encoded_changes_);
+        storage_change_table->put(block_key, encoded_changes_);
     }
 }
 
@@ -64,12 +67,8 @@ void Buffer::update_account(const evmc::address& address, std::optional<Account>
         return;
     }
 
-    Bytes encoded_initial{};
-    if (initial) {
-        bool omit_code_hash{!account_deleted};
-        encoded_initial = initial->encode_for_storage(omit_code_hash);
-    }
-    account_changes_[address] = encoded_initial;
+    bool omit_code_hash{!account_deleted};
+    account_changes_.insert(address, initial, omit_code_hash);
 
     if (equal) {
         return;
@@ -105,8 +104,7 @@ void Buffer::update_storage(const evmc::address& address, uint64_t incarnation,
         return;
     }
     changed_storage_.insert(address);
-    Bytes full_key{storage_key(address, incarnation, key)};
-    storage_changes_[full_key] = zeroless_view(initial);
+    storage_changes_.insert(address, incarnation, key, zeroless_view(initial));
 
     auto& storage_map{storage_[address][incarnation]};
     if (storage_map.empty()) {
@@ -183,12 +181,62 @@ void Buffer::write_to_db() {
     for (const auto& entry : storage_prefix_to_code_hash_) {
         code_hash_table->put(entry.first, full_view(entry.second));
     }
+
+    write_receipts();
+}
+
+void Buffer::insert_receipts(uint64_t block_number, std::vector<Receipt> receipts) {
+    for (const Receipt& receipt : receipts) {
+        if (!receipt.logs.empty()) {
+            batch_size_ += kEntryOverhead + 8 + 4;
+            for (const Log& log : receipt.logs) {
+                batch_size_ += kAddressLength + kHashLength * log.topics.size() + log.data.length();
+            }
+        }
+    }
+    batch_size_ += kEntryOverhead + 8 + receipts.size() * 16;
+    receipts_[block_number] = std::move(receipts);
+}
+
+// Writes a value of known length encoded straight into the space reserved for it.
+// Keys must come in ascending order; those past the last one of the table are appended.
+template <class Encode>
+static void put_encoded(lmdb::Table& table, ByteView key, size_t length, const Encode& encode) {
+    MDB_val key_val{to_mdb_val(key)};
+    MDB_val data_val{};
+    data_val.mv_size = length;
+    lmdb::err_handler(table.put(&key_val, &data_val, MDB_RESERVE | table.append_flag(key)));
+    encode(static_cast<uint8_t*>(data_val.mv_data), length);
+}
+
+void Buffer::write_receipts() {
+    if (receipts_.empty()) {
+        return;
+    }
+
+    // Blocks are in key order, as are the transactions of a block
+    auto receipt_table{txn_->open(table::kBlockReceipts)};
+    for (const auto& [block_number, receipts] : receipts_) {
+        put_encoded(*receipt_table, receipt_key(block_number), cbor_length(receipts),
+                    [&receipts = receipts](uint8_t* to, size_t length) { cbor_encode(to, length, receipts); });
+    }
+
+    auto log_table{txn_->open(table::kLogs)};
+    for (const auto& [block_number, receipts] : receipts_) {
+        for (uint32_t i{0}; i < receipts.size(); ++i) {
+            const std::vector<Log>& logs{receipts[i].logs};
+            if (!logs.empty()) {
+                put_encoded(*log_table, log_key(block_number, i), cbor_length(logs),
+                            [&logs](uint8_t* to, size_t length) { cbor_encode(to, length, logs); });
+            }
+        }
+    }
 }
 
 void Buffer::insert_header(const BlockHeader& block_header) {
-    Bytes rlp{};
-    rlp::encode(rlp, block_header);
-    ethash::hash256 hash{keccak256(rlp)};
+    KeccakHasher hasher;
+    rlp::encode(hasher, block_header);
+    ethash::hash256 hash{hasher.finalize()};
     Bytes key{block_key(block_header.number, hash.bytes)};
     headers_[key] = block_header;
 }
@@ -211,7 +259,10 @@ std::optional<Account> Buffer::read_account(const evmc::address& address) const
     if (!txn_) {
         return std::nullopt;
     }
-    return db::read_account(*txn_, address, historical_block_);
+    if (historical_state_) {
+        return historical_state_->read_account(*txn_, address);
+    }
+    return db::read_account(*txn_, address, historical_block_, history_cache_);
 }
 
 Bytes Buffer::read_code(const evmc::bytes32& code_hash) const noexcept {
@@ -242,7 +293,10 @@ evmc::bytes32 Buffer::read_storage(const evmc::address& address, uint64_t incarn
     if (!txn_) {
         return {};
     }
-    return db::read_storage(*txn_, address, incarnation, key, historical_block_);
+    if (historical_state_) {
+        return historical_state_->read_storage(*txn_, address, incarnation, key);
+    }
+    return db::read_storage(*txn_, address, incarnation, key, historical_block_, history_cache_);
 }
 
 uint64_t Buffer::previous_incarnation(const evmc::address& address) const noexcept {
@@ -252,6 +306,9 @@ uint64_t Buffer::previous_incarnation(const evmc::address& address) const noexce
     if (!txn_) {
         return 0;
     }
+    if (historical_state_) {
+        return historical_state_->previous_incarnation(*txn_, address);
+    }
     std::optional<uint64_t> incarnation{db::read_previous_incarnation(*txn_, address, historical_block_)};
     return incarnation ? *incarnation : 0;
 }
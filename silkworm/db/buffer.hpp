@@ -25,9 +25,12 @@
 #include <optional>
 #include <silkworm/db/chaindb.hpp>
 #include <silkworm/db/change.hpp>
+#include <silkworm/db/historical_state.hpp>
+#include <silkworm/db/history_cache.hpp>
 #include <silkworm/db/state_buffer.hpp>
 #include <silkworm/types/account.hpp>
 #include <silkworm/types/block.hpp>
+#include <silkworm/types/receipt.hpp>
 #include <vector>
 
 namespace silkworm::db {
@@ -37,8 +40,14 @@ class Buffer : public StateBuffer {
     Buffer(const Buffer&) = delete;
     Buffer& operator=(const Buffer&) = delete;
 
-    explicit Buffer(lmdb::Transaction* txn, std::optional<uint64_t> historical_block = std::nullopt)
-        : txn_{txn}, historical_block_{historical_block} {}
+    /** A history cache, if provided, serves reads of a historical buffer and may be shared among buffers.*/
+    explicit Buffer(lmdb::Transaction* txn, std::optional<uint64_t> historical_block = std::nullopt,
+                    HistoryCache* history_cache = nullptr)
+        : txn_{txn}, historical_block_{historical_block}, history_cache_{history_cache} {}
+
+    /** Reads state from historical_state, which is expected to stay at the same block while the buffer is used.*/
+    Buffer(lmdb::Transaction* txn, HistoricalState& historical_state)
+        : txn_{txn}, historical_block_{historical_state.block_number()}, historical_state_{&historical_state} {}
 
     /** @name Readers */
     ///@{
@@ -58,6 +67,9 @@ class Buffer : public StateBuffer {
 
     void insert_header(const BlockHeader& block_header) override;
 
+    /** Buffers the receipts of a block, to be written into kBlockReceipts and kLogs by write_to_db. */
+    void insert_receipts(uint64_t block_number, std::vector<Receipt> receipts);
+
     /** @name State changes
      *  Change sets are backward changes of the state, i.e. account/storage values <em>at the beginning of a block</em>.
      */
@@ -82,10 +94,10 @@ class Buffer : public StateBuffer {
     void end_block() override;
 
     /** Account (backward) changes for the current block.*/
-    const AccountChanges& account_changes() const { return account_changes_; }
+    AccountChanges account_changes() const { return account_changes_.to_changes(); }
 
     /** Storage (backward) changes for the current block.*/
-    const StorageChanges& storage_changes() const { return storage_changes_; }
+    StorageChanges storage_changes() const { return storage_changes_.to_changes(); }
     ///@}
 
     /** Approximate size of accumulated DB changes in bytes.*/
@@ -96,8 +108,12 @@ class Buffer : public StateBuffer {
   private:
     void write_to_state_table();
 
+    void write_receipts();
+
     lmdb::Transaction* txn_{nullptr};
     std::optional<uint64_t> historical_block_{};
+    HistoryCache* history_cache_{nullptr};
+    HistoricalState* historical_state_{nullptr};
 
     absl::btree_map<Bytes, BlockHeader> headers_{};
     absl::flat_hash_map<evmc::address, std::optional<Account>> accounts_;
@@ -109,14 +125,16 @@ class Buffer : public StateBuffer {
     absl::btree_map<evmc::address, uint64_t> incarnations_;
     absl::btree_map<evmc::bytes32, Bytes> hash_to_code_;
     absl::btree_map<Bytes, evmc::bytes32> storage_prefix_to_code_hash_;
+    absl::btree_map<uint64_t, std::vector<Receipt>> receipts_;
 
     size_t batch_size_{0};
 
     // Current block stuff
     uint64_t current_block_number_{0};
     absl::flat_hash_set<evmc::address> changed_storage_;
-    AccountChanges account_changes_;
-    StorageChanges storage_changes_;
+    AccountChangeSetBuilder account_changes_;
+    StorageChangeSetBuilder storage_changes_;
+    Bytes encoded_changes_;  // reused for encoding of change sets
 };
 
 }  // namespace silkworm::db
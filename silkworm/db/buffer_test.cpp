@@ -0,0 +1,95 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "buffer.hpp"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <vector>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static std::map<Bytes, Bytes> read_table(lmdb::Transaction& txn, const lmdb::TableConfig& config) {
+    std::map<Bytes, Bytes> res;
+    auto table{txn.open(config)};
+    MDB_val key, data;
+    for (int rc{table->get_first(&key, &data)}; rc == MDB_SUCCESS; rc = table->get_next(&key, &data)) {
+        res.emplace(from_mdb_val(key), from_mdb_val(data));
+    }
+    return res;
+}
+
+TEST_CASE("Buffer receipts") {
+    using namespace evmc::literals;
+
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    std::map<Bytes, Bytes> expected_receipts;
+    std::map<Bytes, Bytes> expected_logs;
+
+    // Block n has n % 4 transactions, with (n + i) % 3 logs for transaction i
+    const auto insert_receipts{[&](Buffer& buffer, uint64_t block_number) {
+        std::vector<Receipt> receipts(block_number % 4);
+        for (uint32_t i{0}; i < receipts.size(); ++i) {
+            receipts[i].success = i % 2 == 0;
+            receipts[i].cumulative_gas_used = 21'000 * (i + 1);
+            for (uint64_t j{0}; j < (block_number + i) % 3; ++j) {
+                Log log{0x22341ae42d6dd7384bc8584e50419ea3ac75b83f_address, {}, Bytes(block_number, '\x2a')};
+                log.topics.resize(j);
+                receipts[i].logs.push_back(log);
+            }
+            if (!receipts[i].logs.empty()) {
+                expected_logs[log_key(block_number, i)] = cbor_encode(receipts[i].logs);
+            }
+        }
+        expected_receipts[receipt_key(block_number)] = cbor_encode(receipts);
+        buffer.insert_receipts(block_number, receipts);
+    }};
+
+    {
+        Buffer buffer{txn.get()};
+        for (uint64_t block_number{10}; block_number < 20; ++block_number) {
+            insert_receipts(buffer, block_number);
+        }
+        buffer.write_to_db();
+    }
+    CHECK(read_table(*txn, table::kBlockReceipts) == expected_receipts);
+    CHECK(read_table(*txn, table::kLogs) == expected_logs);
+
+    // Keys before, among and past those already in the tables
+    {
+        Buffer buffer{txn.get()};
+        for (uint64_t block_number : {3u, 13u, 14u, 23u, 24u}) {
+            insert_receipts(buffer, block_number);
+        }
+        buffer.write_to_db();
+    }
+    CHECK(read_table(*txn, table::kBlockReceipts) == expected_receipts);
+    CHECK(read_table(*txn, table::kLogs) == expected_logs);
+    CHECK(expected_receipts.size() == 13);
+}
+
+}  // namespace silkworm::db
@@ -16,8 +16,10 @@
 
 #include "chaindb.hpp"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/interprocess/mapped_region.hpp>
+#include <numeric>
 
 namespace silkworm::lmdb {
 
@@ -304,7 +306,9 @@ std::unique_ptr<Table> Transaction::open(MDB_dbi dbi) {
 void Transaction::abort(void) {
     if (handle_) {
         mdb_txn_abort(handle_);
-        if (is_ro()) {
+        if (!parent_env_) {
+            // Not accounted for
+        } else if (is_ro()) {
             parent_env_->touch_ro_txns(-1);
         } else {
             parent_env_->touch_rw_txns(-1);
@@ -317,7 +321,9 @@ int Transaction::commit(void) {
     if (!handle_) return MDB_BAD_TXN;
     int rc{mdb_txn_commit(handle_)};
     if (rc == MDB_SUCCESS) {
-        if (is_ro()) {
+        if (!parent_env_) {
+            // Not accounted for
+        } else if (is_ro()) {
             parent_env_->touch_ro_txns(-1);
         } else {
             parent_env_->touch_rw_txns(-1);
@@ -327,6 +333,25 @@ int Transaction::commit(void) {
     return rc;
 }
 
+void Transaction::reset(void) {
+    if (!is_ro()) {
+        throw std::runtime_error("Only readonly transactions can be reset");
+    }
+    if (handle_) {
+        mdb_txn_reset(handle_);
+    }
+}
+
+void Transaction::renew(void) {
+    if (!is_ro()) {
+        throw std::runtime_error("Only readonly transactions can be renewed");
+    }
+    if (!handle_) {
+        throw std::runtime_error("Database or transaction closed");
+    }
+    err_handler(mdb_txn_renew(handle_));
+}
+
 /*
  * Tables
  */
@@ -421,6 +446,67 @@ std::optional<ByteView> Table::get(ByteView key, ByteView sub_key) {
     }
 }
 
+// Returns the permutation of indices which visits items in ascending order
+template <class T>
+static std::vector<size_t> sorted_order(gsl::span<const T> items) {
+    std::vector<size_t> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&items](size_t a, size_t b) { return items[a] < items[b]; });
+    return order;
+}
+
+std::vector<std::optional<ByteView>> Table::multi_get(gsl::span<const ByteView> keys) {
+    std::vector<std::optional<ByteView>> values(keys.size());
+    const std::vector<size_t> order{sorted_order(keys)};
+
+    for (size_t i{0}; i < order.size(); ++i) {
+        const size_t idx{order[i]};
+        if (i > 0 && keys[order[i - 1]] == keys[idx]) {
+            values[idx] = values[order[i - 1]];
+            continue;
+        }
+        MDB_val key_val{db::to_mdb_val(keys[idx])};
+        MDB_val data;
+        int rc{get(&key_val, &data, MDB_SET)};
+        if (rc == MDB_NOTFOUND) {
+            continue;
+        }
+        err_handler(rc);
+        values[idx] = db::from_mdb_val(data);
+    }
+
+    return values;
+}
+
+std::vector<std::optional<ByteView>> Table::multi_get(gsl::span<const std::pair<ByteView, ByteView>> keys) {
+    std::vector<std::optional<ByteView>> values(keys.size());
+    const std::vector<size_t> order{sorted_order(keys)};
+
+    for (size_t i{0}; i < order.size(); ++i) {
+        const size_t idx{order[i]};
+        if (i > 0 && keys[order[i - 1]] == keys[idx]) {
+            values[idx] = values[order[i - 1]];
+            continue;
+        }
+        const auto& [key, sub_key]{keys[idx]};
+        MDB_val key_val{db::to_mdb_val(key)};
+        MDB_val data{db::to_mdb_val(sub_key)};
+        int rc{get(&key_val, &data, MDB_GET_BOTH_RANGE)};
+        if (rc == MDB_NOTFOUND) {
+            continue;
+        }
+        err_handler(rc);
+
+        ByteView x{db::from_mdb_val(data)};
+        if (has_prefix(x, sub_key)) {
+            x.remove_prefix(sub_key.length());
+            values[idx] = x;
+        }
+    }
+
+    return values;
+}
+
 void Table::del(ByteView key) {
     if (get(key)) {
         err_handler(del_current());
@@ -451,6 +537,7 @@ std::optional<db::Entry> Table::seek(ByteView prefix) {
 
 int Table::seek(MDB_val* key, MDB_val* data) { return get(key, data, MDB_SET_RANGE); }
 int Table::seek_exact(MDB_val* key, MDB_val* data) { return get(key, data, MDB_SET); }
+int Table::seek_dup(MDB_val* key, MDB_val* data) { return get(key, data, MDB_GET_BOTH_RANGE); }
 int Table::get_current(MDB_val* key, MDB_val* data) { return get(key, data, MDB_GET_CURRENT); }
 int Table::del_current(bool alldupkeys) {
     if (alldupkeys) {
@@ -481,6 +568,21 @@ void Table::put(ByteView key, ByteView data, unsigned flags) {
     err_handler(put(&key_val, &data_val, flags));
 }
 
+unsigned Table::append_flag(ByteView key, bool first_of_key) {
+    if (!last_key_cached_) {
+        MDB_val last_key, last_value;
+        if (int rc{get_last(&last_key, &last_value)}; rc != MDB_NOTFOUND) {
+            err_handler(rc);
+            last_key_ = db::from_mdb_val(last_key);
+        }
+        last_key_cached_ = true;
+    }
+    if (last_key_ && key <= ByteView{*last_key_}) {
+        return 0;
+    }
+    return first_of_key ? MDB_APPEND : MDB_APPENDDUP;
+}
+
 int Table::put_current(MDB_val* key, MDB_val* data) { return put(key, data, MDB_CURRENT); }
 int Table::put_nodup(MDB_val* key, MDB_val* data) { return put(key, data, MDB_NODUPDATA); }
 int Table::put_noovrw(MDB_val* key, MDB_val* data) { return put(key, data, MDB_NOOVERWRITE); }
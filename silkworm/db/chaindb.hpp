@@ -26,6 +26,7 @@
 
 #include <boost/filesystem.hpp>
 #include <exception>
+#include <gsl/span>
 #include <map>
 #include <mutex>
 #include <optional>
@@ -34,6 +35,7 @@
 #include <silkworm/db/util.hpp>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 static_assert(sizeof(size_t) == 8, "32 bit environment limits LMDB size");
@@ -196,6 +198,9 @@ class Transaction {
 
   public:
     explicit Transaction(Environment* parent, unsigned int flags = 0);
+
+    // Wraps an already begun MDB_txn. A null parent means the transaction is not
+    // accounted for in the environment's per-thread transaction counters.
     Transaction(Environment* parent, MDB_txn* txn, unsigned int flags);
     ~Transaction();
 
@@ -219,6 +224,13 @@ class Transaction {
 
     void abort(void);
     int commit(void);
+
+    // Releases the snapshot of a readonly transaction while keeping its reader slot (see mdb_txn_reset).
+    // Tables opened on this transaction become unusable.
+    void reset(void);
+
+    // Acquires a fresh snapshot for a previously reset readonly transaction (see mdb_txn_renew).
+    void renew(void);
 };
 
 /**
@@ -259,6 +271,21 @@ class Table {
      */
     std::optional<ByteView> get(ByteView key, ByteView sub_key);
 
+    /** @brief Gets the values of many keys at once.
+     *
+     * Keys are looked up in lexicographic order by the table cursor, so that keys falling onto the
+     * leaf page the cursor already sits on are found without a root-to-leaf descent.
+     * Results are returned in input order; std::nullopt marks a key that is not found.
+     * The cursor is left positioned at the last key visited.
+     *
+     * See the memory warning above.
+     */
+    std::vector<std::optional<ByteView>> multi_get(gsl::span<const ByteView> keys);
+
+    /* Same as the above, but for MDB_DUPSORT (key, sub_key) pairs. See get(key, sub_key).
+     */
+    std::vector<std::optional<ByteView>> multi_get(gsl::span<const std::pair<ByteView, ByteView>> keys);
+
     /** @brief Deletes an entry.
      * Doesn't do anything if the item is not present.
      */
@@ -276,6 +303,8 @@ class Table {
     std::optional<db::Entry> seek(ByteView prefix);  // Position cursor to first key >= of given prefix
     int seek(MDB_val* key, MDB_val* data);           // Position cursor to first key >= of given key
     int seek_exact(MDB_val* key, MDB_val* data);     // Position cursor to key == of given key
+    int seek_dup(MDB_val* key, MDB_val* data);  // Position cursor to first data item >= of given data within given key
+                                                // (only MDB_DUPSORT)
     int get_current(MDB_val* key, MDB_val* data);    // Gets data from current cursor position
     int del_current(bool alldupkeys = false);  // Delete key/data pair at current cursor position. alldupkeys may be set
                                                // true only for tables opened MDB_DUPSORT flag and in that case all
@@ -300,6 +329,14 @@ class Table {
     int put(MDB_val* key, MDB_val* data, unsigned int flag);
     void put(ByteView key, ByteView data, unsigned flags = 0);
 
+    /** @brief Flag to put a key with when loading keys in ascending order.
+     *
+     * Keys past the last key the table held on the first call on this instance can be appended:
+     * MDB_APPEND is returned for them, or MDB_APPENDDUP for further data items of the same key
+     * (only MDB_DUPSORT), and 0 for the others. The last key is looked up once and then cached.
+     */
+    unsigned append_flag(ByteView key, bool first_of_key = true);
+
     /** @brief Replace the k/d pair at current cursor position
      *
      * The key parameter must be provided and must match the one at current cursor position
@@ -378,6 +415,10 @@ class Table {
     std::string name_;         // The name of the dbi
     bool dbi_dropped_{false};  // Whether or not this table has been dropped
     MDB_cursor* handle_;       // The underlying MDB_cursor for this instance
+
+    // Last key of the table as looked up by append_flag; std::nullopt if the table was empty
+    bool last_key_cached_{false};
+    std::optional<Bytes> last_key_{std::nullopt};
 };
 
 std::shared_ptr<Environment> get_env(DatabaseConfig config);
@@ -0,0 +1,153 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "chaindb.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <utility>
+#include <vector>
+
+namespace silkworm::lmdb {
+
+TEST_CASE("Table multi_get") {
+    TemporaryDirectory tmp_dir{};
+    DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<Environment> env{get_env(db_config)};
+    std::unique_ptr<Transaction> txn{env->begin_rw_transaction()};
+
+    SECTION("plain") {
+        auto table{txn->open({"Plain"}, MDB_CREATE)};
+        for (const char* key : {"02", "04", "06", "08"}) {
+            table->put(from_hex(key), from_hex(std::string{"aa"} + key));
+        }
+
+        // Unsorted, with duplicates and missing keys
+        const std::vector<Bytes> keys{from_hex("06"), from_hex("02"), from_hex("05"), from_hex("06"),
+                                      from_hex("09"), from_hex("08"), from_hex("00"), from_hex("02")};
+        const std::vector<ByteView> views(keys.begin(), keys.end());
+        const std::vector<std::optional<ByteView>> values{table->multi_get(views)};
+        REQUIRE(values.size() == keys.size());
+        CHECK(values[0] == ByteView{from_hex("aa06")});
+        CHECK(values[1] == ByteView{from_hex("aa02")});
+        CHECK(!values[2]);
+        CHECK(values[3] == ByteView{from_hex("aa06")});
+        CHECK(!values[4]);
+        CHECK(values[5] == ByteView{from_hex("aa08")});
+        CHECK(!values[6]);
+        CHECK(values[7] == ByteView{from_hex("aa02")});
+
+        // Same as single gets
+        for (size_t i{0}; i < keys.size(); ++i) {
+            CHECK(values[i] == table->get(keys[i]));
+        }
+
+        CHECK(table->multi_get(gsl::span<const ByteView>{}).empty());
+    }
+
+    SECTION("dupsort") {
+        auto table{txn->open({"DupSort", MDB_DUPSORT}, MDB_CREATE)};
+        // Values are sub_key + value
+        table->put(from_hex("01"), from_hex("0a11"));
+        table->put(from_hex("01"), from_hex("0b22"));
+        table->put(from_hex("01"), from_hex("0d44"));
+        table->put(from_hex("03"), from_hex("0a55"));
+
+        const Bytes k1{from_hex("01")}, k2{from_hex("02")}, k3{from_hex("03")};
+        const Bytes a{from_hex("0a")}, b{from_hex("0b")}, c{from_hex("0c")}, d{from_hex("0d")}, e{from_hex("0e")};
+        const std::vector<std::pair<ByteView, ByteView>> keys{
+            {k3, a},  // in another key
+            {k1, d},  //
+            {k1, c},  // missing, between 0b and 0d
+            {k1, a},  //
+            {k2, a},  // missing key
+            {k1, e},  // missing, past the last sub_key
+            {k1, d},  // duplicate
+            {k1, b},  //
+        };
+        const std::vector<std::optional<ByteView>> values{table->multi_get(keys)};
+        REQUIRE(values.size() == keys.size());
+        CHECK(values[0] == ByteView{from_hex("55")});
+        CHECK(values[1] == ByteView{from_hex("44")});
+        CHECK(!values[2]);
+        CHECK(values[3] == ByteView{from_hex("11")});
+        CHECK(!values[4]);
+        CHECK(!values[5]);
+        CHECK(values[6] == ByteView{from_hex("44")});
+        CHECK(values[7] == ByteView{from_hex("22")});
+
+        for (size_t i{0}; i < keys.size(); ++i) {
+            CHECK(values[i] == table->get(keys[i].first, keys[i].second));
+        }
+    }
+}
+
+TEST_CASE("Table append_flag") {
+    TemporaryDirectory tmp_dir{};
+    DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<Environment> env{get_env(db_config)};
+    std::unique_ptr<Transaction> txn{env->begin_rw_transaction()};
+
+    SECTION("plain") {
+        auto table{txn->open({"Plain"}, MDB_CREATE)};
+        CHECK(table->append_flag(from_hex("00")) == MDB_APPEND);  // empty table
+
+        for (const char* key : {"02", "04"}) {
+            table->put(from_hex(key), from_hex("aa"));
+        }
+        // The last key was cached while the table was empty
+        CHECK(table->append_flag(from_hex("03")) == MDB_APPEND);
+
+        table = txn->open({"Plain"});
+        CHECK(table->append_flag(from_hex("01")) == 0);
+        CHECK(table->append_flag(from_hex("04")) == 0);
+        CHECK(table->append_flag(from_hex("0400")) == MDB_APPEND);
+        for (const char* key : {"03", "05", "06"}) {
+            const Bytes k{from_hex(key)};
+            table->put(k, from_hex("bb"), table->append_flag(k));
+        }
+        // Still compared against the key that was last on the first call
+        CHECK(table->append_flag(from_hex("05")) == MDB_APPEND);
+
+        auto other{txn->open({"Plain"})};
+        CHECK(other->append_flag(from_hex("06")) == 0);
+        CHECK(other->append_flag(from_hex("07")) == MDB_APPEND);
+
+        size_t count{0};
+        REQUIRE(table->get_rcount(&count) == MDB_SUCCESS);
+        CHECK(count == 5);
+    }
+
+    SECTION("dupsort") {
+        auto table{txn->open({"DupSort", MDB_DUPSORT}, MDB_CREATE)};
+        table->put(from_hex("02"), from_hex("aa"));
+
+        table = txn->open({"DupSort", MDB_DUPSORT});
+        CHECK(table->append_flag(from_hex("02"), /*first_of_key=*/false) == 0);
+        const Bytes key{from_hex("03")};
+        for (const char* value : {"aa", "bb", "cc"}) {
+            const bool first_of_key{std::string{value} == "aa"};
+            CHECK(table->append_flag(key, first_of_key) == (first_of_key ? MDB_APPEND : MDB_APPENDDUP));
+            table->put(key, from_hex(value), table->append_flag(key, first_of_key));
+        }
+        CHECK(table->get(key, from_hex("cc")));
+    }
+}
+
+}  // namespace silkworm::lmdb
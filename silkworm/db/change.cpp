@@ -22,7 +22,6 @@
 #include <cassert>
 #include <cstring>
 #include <silkworm/common/util.hpp>
-#include <tuple>
 #include <vector>
 
 #include "util.hpp"
@@ -34,169 +33,52 @@ using namespace silkworm;
 constexpr uint32_t kAddressLen{kAddressLength};
 constexpr uint32_t kHashLen{kHashLength};
 
-std::tuple<uint32_t, uint32_t> decode_account_meta(ByteView b) {
-    using boost::endian::load_big_u32;
-
-    if (b.length() < 4) {
-        throw DecodingError("input too short");
-    }
-
-    uint32_t n{load_big_u32(&b[0])};
-
-    uint32_t val_pos{4 + n * kAddressLen + 4 * n};
-    if (b.length() < val_pos) {
-        throw DecodingError("input too short");
-    }
-
-    uint32_t total_val_len{load_big_u32(&b[val_pos - 4])};
-    if (b.length() < val_pos + total_val_len) {
-        throw DecodingError("input too short");
-    }
-
-    return {n, val_pos};
-}
-
-std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t> decode_storage_meta(ByteView b) {
-    using boost::endian::load_big_u32;
-
-    if (b.length() < 4) {
-        throw DecodingError("input too short");
-    }
-
-    uint32_t num_of_contracts{load_big_u32(&b[0])};
-    uint32_t pos{num_of_contracts * (kAddressLen + 4)};
-    uint32_t num_of_entries{load_big_u32(&b[pos])};
-    pos += 4;
-    uint32_t num_of_non_default_incarnations{load_big_u32(&b[pos])};
-    uint32_t incarnation_pos{pos + 4};
-    uint32_t key_pos{incarnation_pos + num_of_non_default_incarnations * 12};
-    uint32_t val_pos{key_pos + num_of_entries * kHashLen};
-
-    return {num_of_contracts, num_of_non_default_incarnations, incarnation_pos, key_pos, val_pos};
-}
-
-ByteView account_address(ByteView b, uint32_t i) { return b.substr(4 + i * kAddressLen, kAddressLen); };
-
-ByteView storage_address(ByteView b, uint32_t i) { return b.substr(4 + i * (4 + kAddressLen), kAddressLen); };
-
-std::pair<uint32_t, uint32_t> account_indices(ByteView lengths, uint32_t i) {
-    using boost::endian::load_big_u32;
-
-    uint32_t idx0{0};
-    if (i > 0) {
-        idx0 = load_big_u32(&lengths[4 * (i - 1)]);
-    }
-    uint32_t idx1 = load_big_u32(&lengths[4 * i]);
-
-    return {idx0, idx1};
-}
-
-ByteView find_value(ByteView b, uint32_t i) {
-    using boost::endian::load_big_u16;
-    using boost::endian::load_big_u32;
-
-    uint32_t num_of_uint8{load_big_u32(&b[0])};
-    uint32_t num_of_uint16{load_big_u32(&b[4])};
-    uint32_t num_of_uint32{load_big_u32(&b[8])};
-    b = b.substr(12);
-    uint32_t val_pos{num_of_uint8 + num_of_uint16 * 2 + num_of_uint32 * 4};
-
-    auto val_index{[=](uint32_t i) -> uint32_t {
-        if (i < num_of_uint8) {
-            return b[i];
-        } else if (i < num_of_uint8 + num_of_uint16) {
-            uint32_t pos{num_of_uint8 + (i - num_of_uint8) * 2};
-            return load_big_u16(&b[pos]);
-        } else {
-            uint32_t pos{num_of_uint8 + num_of_uint16 * 2 + (i - num_of_uint8 - num_of_uint16) * 4};
-            return load_big_u32(&b[pos]);
+// Sorts records by key and then by order of insertion, keeping only the last inserted record of each key
+template <class Record, class Less>
+void sort_keeping_last(std::vector<Record>& records, Less less_key) {
+    std::sort(records.begin(), records.end(), [less_key](const Record& a, const Record& b) {
+        if (less_key(a, b)) {
+            return true;
+        } else if (less_key(b, a)) {
+            return false;
         }
-    }};
-
-    uint32_t start{i > 0 ? val_index(i - 1) : 0};
-    uint32_t end{val_index(i)};
+        return a.seq < b.seq;
+    });
 
-    return b.substr(val_pos + start, end - start);
+    size_t n{0};
+    for (size_t i{0}; i < records.size(); ++i) {
+        if (i + 1 < records.size() && !less_key(records[i], records[i + 1])) {
+            continue;  // superseded
+        }
+        records[n++] = records[i];
+    }
+    records.resize(n);
 }
-
-struct Contract {
-    ByteView address;
-    uint64_t incarnation{0};
-    std::vector<ByteView> keys;
-    std::vector<ByteView> vals;
-};
 }  // namespace
 
 namespace silkworm::db {
 
 Bytes AccountChanges::encode() const {
-    auto n{size()};
-    Bytes out(4 + kAddressLen * n + 4 * n, '\0');
-    boost::endian::store_big_u32(&out[0], n);
-    size_t pos{4};
-
+    AccountChangeSetBuilder builder;
     for (const auto& e : *this) {
-        std::memcpy(&out[pos], e.first.bytes, kAddressLen);
-        pos += kAddressLen;
+        builder.insert(e.first, e.second);
     }
-
-    uint32_t len_of_vals{0};
-    for (const auto& e : *this) {
-        len_of_vals += e.second.size();
-        boost::endian::store_big_u32(&out[pos], len_of_vals);
-        pos += 4;
-    }
-
-    assert(pos == out.size());
-    out.resize(pos + len_of_vals);
-
-    for (const auto& e : *this) {
-        std::memcpy(&out[pos], e.second.data(), e.second.size());
-        pos += e.second.size();
-    }
-
+    Bytes out{};
+    builder.encode(out);
     return out;
 }
 
 AccountChanges AccountChanges::decode(ByteView b) {
-    if (b.empty()) {
-        return {};
-    }
-
-    auto [n, val_pos]{decode_account_meta(b)};
-    ByteView lengths{b.substr(4 + n * kAddressLen)};
-
     AccountChanges changes;
-    for (uint32_t i{0}; i < n; ++i) {
-        evmc::address key;
-        std::memcpy(key.bytes, &b[4 + i * kAddressLen], kAddressLen);
-        auto [idx0, idx1]{account_indices(lengths, i)};
-        changes[key] = b.substr(val_pos + idx0, idx1 - idx0);
+    for (const AccountChangeSetView::Entry& entry : AccountChangeSetView{b}) {
+        changes[to_address(entry.address)] = entry.value;
     }
     return changes;
 }
 
 std::optional<ByteView> AccountChanges::find(ByteView b, ByteView key) {
-    using CI = boost::counting_iterator<uint32_t>;
-
     assert(key.length() == kAddressLen);
-
-    if (b.empty()) {
-        return {};
-    }
-
-    auto [n, val_pos]{decode_account_meta(b)};
-
-    uint32_t i{*std::lower_bound(CI(0), CI(n), key,
-                                 [b](uint32_t i, ByteView address) { return account_address(b, i) < address; })};
-
-    if (i >= n || account_address(b, i) != key) {
-        return {};
-    }
-
-    auto [idx0, idx1]{account_indices(b.substr(4 + n * kAddressLen), i)};
-
-    return b.substr(val_pos + idx0, idx1 - idx0);
+    return AccountChangeSetView{b}.find(key);
 }
 
 /*
@@ -224,181 +106,443 @@ followed by the values themselves.
 All integers are stored as big-endian.
 */
 Bytes StorageChanges::encode() const {
-    using namespace boost::endian;
+    using boost::endian::load_big_u64;
 
-    uint32_t num_of_non_default_incarnations{0};
-    Bytes non_default_incarnations{};
+    StorageChangeSetBuilder builder;
+    for (const auto& entry : *this) {
+        ByteView key{entry.first};
+        builder.insert(to_address(key.substr(0, kAddressLen)), load_big_u64(&key[kAddressLen]),
+                       to_bytes32(key.substr(kStoragePrefixLength, kHashLen)), entry.second);
+    }
+    Bytes out{};
+    builder.encode(out);
+    return out;
+}
 
-    uint32_t num_of_uint8_val_lens{0};
-    uint32_t num_of_uint16_val_lens{0};
-    uint32_t num_of_uint32_val_lens{0};
-    uint32_t len_of_vals{0};
-    Bytes val_lens{};
+StorageChanges StorageChanges::decode(ByteView b) {
+    StorageChanges changes;
+    Bytes composite_key(kStoragePrefixLength + kHashLen, '\0');
+    for (const StorageChangeSetView::Entry& entry : StorageChangeSetView{b}) {
+        std::memcpy(&composite_key[0], entry.address.data(), kAddressLen);
+        boost::endian::store_big_u64(&composite_key[kAddressLen], entry.incarnation);
+        std::memcpy(&composite_key[kStoragePrefixLength], entry.location.data(), kHashLen);
+        changes[composite_key] = entry.value;
+    }
+    return changes;
+}
 
-    std::vector<Contract> contracts{};
+std::optional<ByteView> StorageChanges::find(ByteView b, ByteView composite_key) {
+    assert(composite_key.length() == kStoragePrefixLength + kHashLen);
+    return StorageChangeSetView{b}.find(composite_key);
+}
 
-    ByteView prev{};
-    for (const auto& entry : *this) {
-        ByteView contract_key{entry.first.data(), kStoragePrefixLength};
-        if (contract_key != prev) {
-            uint64_t incarnation{load_big_u64(&contract_key[kAddressLen])};
-            if (incarnation != kDefaultIncarnation) {
-                size_t pos{non_default_incarnations.size()};
-                non_default_incarnations.resize(pos + kIncarnationLength + 4);
-                store_big_u32(&non_default_incarnations[pos], static_cast<uint32_t>(contracts.size()));
-                store_big_u64(&non_default_incarnations[pos + 4], incarnation);
-                ++num_of_non_default_incarnations;
-            }
-            contracts.push_back({contract_key.substr(0, kAddressLen), incarnation, {}, {}});
-            prev = contract_key;
-        }
-        contracts.back().keys.emplace_back(&entry.first[kStoragePrefixLength], kHashLen);
-        contracts.back().vals.emplace_back(entry.second);
+AccountChangeSetView::AccountChangeSetView(ByteView encoded) : encoded_{encoded} {
+    using boost::endian::load_big_u32;
 
-        len_of_vals += static_cast<uint32_t>(entry.second.length());
-        if (len_of_vals < 0x100) {
-            val_lens.push_back(static_cast<uint8_t>(len_of_vals));
-            ++num_of_uint8_val_lens;
-        } else if (len_of_vals < 0x10000) {
-            size_t pos{val_lens.size()};
-            val_lens.resize(pos + 2);
-            store_big_u16(&val_lens[pos], static_cast<uint16_t>(len_of_vals));
-            ++num_of_uint16_val_lens;
-        } else {
-            size_t pos{val_lens.size()};
-            val_lens.resize(pos + 4);
-            store_big_u32(&val_lens[pos], len_of_vals);
-            ++num_of_uint32_val_lens;
-        }
+    if (encoded.empty()) {
+        return;
+    }
+    if (encoded.length() < 4) {
+        throw DecodingError("input too short");
     }
 
-    Bytes out(4 + contracts.size() * (kAddressLen + 4) + 4 + non_default_incarnations.length() + size() * kHashLen +
-                  3 * 4 + val_lens.length() + len_of_vals,
-              '\0');
-
-    store_big_u32(&out[0], static_cast<uint32_t>(contracts.size()));
+    uint32_t n{load_big_u32(&encoded[0])};
 
-    size_t pos{4};
-    uint32_t num_of_keys{0};
+    uint64_t val_pos{4 + static_cast<uint64_t>(n) * (kAddressLen + 4)};
+    if (encoded.length() < val_pos) {
+        throw DecodingError("input too short");
+    }
 
-    for (const auto& entry : contracts) {
-        std::memcpy(&out[pos], &entry.address[0], kAddressLen);
-        pos += kAddressLen;
-        num_of_keys += static_cast<uint32_t>(entry.keys.size());
-        store_big_u32(&out[pos], num_of_keys);
-        pos += 4;
+    uint32_t total_val_len{n > 0 ? load_big_u32(&encoded[val_pos - 4]) : 0};
+    if (encoded.length() < val_pos + total_val_len) {
+        throw DecodingError("input too short");
     }
 
-    assert(num_of_keys == size());
+    size_ = n;
+    val_pos_ = static_cast<uint32_t>(val_pos);
+}
 
-    store_big_u32(&out[pos], num_of_non_default_incarnations);
-    pos += 4;
+AccountChangeSetView::Entry AccountChangeSetView::operator[](size_t i) const noexcept {
+    using boost::endian::load_big_u32;
 
-    std::memcpy(&out[pos], &non_default_incarnations[0], non_default_incarnations.length());
-    pos += non_default_incarnations.length();
+    assert(i < size_);
 
-    for (const auto& contract : contracts) {
-        for (const auto& key : contract.keys) {
-            std::memcpy(&out[pos], &key[0], kHashLen);
-            pos += kHashLen;
-        }
+    const uint8_t* lengths{&encoded_[4 + size_ * kAddressLen]};
+    uint32_t from{i > 0 ? load_big_u32(lengths + 4 * (i - 1)) : 0};
+    uint32_t to{load_big_u32(lengths + 4 * i)};
+
+    return {encoded_.substr(4 + i * kAddressLen, kAddressLen), encoded_.substr(val_pos_ + from, to - from)};
+}
+
+std::optional<ByteView> AccountChangeSetView::find(ByteView address) const noexcept {
+    using CI = boost::counting_iterator<uint32_t>;
+
+    auto address_at{[this](uint32_t i) { return encoded_.substr(4 + i * kAddressLen, kAddressLen); }};
+
+    uint32_t i{*std::lower_bound(CI(0), CI(size_), address,
+                                 [&address_at](uint32_t i, ByteView address) { return address_at(i) < address; })};
+    if (i == size_ || address_at(i) != address) {
+        return std::nullopt;
     }
+    return (*this)[i].value;
+}
 
-    store_big_u32(&out[pos], num_of_uint8_val_lens);
-    pos += 4;
-    store_big_u32(&out[pos], num_of_uint16_val_lens);
-    pos += 4;
-    store_big_u32(&out[pos], num_of_uint32_val_lens);
-    pos += 4;
+StorageChangeSetView::StorageChangeSetView(ByteView encoded) : encoded_{encoded} {
+    using boost::endian::load_big_u32;
 
-    std::memcpy(&out[pos], &val_lens[0], val_lens.length());
-    pos += val_lens.length();
+    if (encoded.empty()) {
+        return;
+    }
 
-    for (const auto& contract : contracts) {
-        for (const auto& val : contract.vals) {
-            std::memcpy(&out[pos], val.data(), val.length());
-            pos += val.length();
+    auto load_u32{[encoded](uint64_t pos) {
+        if (encoded.length() < pos + 4) {
+            throw DecodingError("input too short");
         }
+        return load_big_u32(&encoded[pos]);
+    }};
+
+    uint32_t num_of_contracts{load_u32(0)};
+    uint64_t pos{4 + static_cast<uint64_t>(num_of_contracts) * (kAddressLen + 4)};
+    uint32_t num_of_entries{num_of_contracts > 0 ? load_u32(pos - 4) : 0};
+    uint32_t num_of_non_default_incarnations{load_u32(pos)};
+    pos += 4;
+    uint64_t incarnation_pos{pos};
+    pos += static_cast<uint64_t>(num_of_non_default_incarnations) * 12;
+    uint64_t key_pos{pos};
+    pos += static_cast<uint64_t>(num_of_entries) * kHashLen;
+
+    uint32_t num_of_uint8{load_u32(pos)};
+    uint32_t num_of_uint16{load_u32(pos + 4)};
+    uint32_t num_of_uint32{load_u32(pos + 8)};
+    pos += 12;
+    if (static_cast<uint64_t>(num_of_uint8) + num_of_uint16 + num_of_uint32 != num_of_entries) {
+        throw DecodingError("inconsistent number of values");
+    }
+    uint64_t val_len_pos{pos};
+    pos += num_of_uint8 + static_cast<uint64_t>(num_of_uint16) * 2 + static_cast<uint64_t>(num_of_uint32) * 4;
+    if (encoded.length() < pos) {
+        throw DecodingError("input too short");
     }
 
-    return out;
+    num_of_contracts_ = num_of_contracts;
+    num_of_entries_ = num_of_entries;
+    num_of_non_default_incarnations_ = num_of_non_default_incarnations;
+    incarnation_pos_ = static_cast<uint32_t>(incarnation_pos);
+    key_pos_ = static_cast<uint32_t>(key_pos);
+    num_of_uint8_val_lens_ = num_of_uint8;
+    num_of_uint16_val_lens_ = num_of_uint16;
+    val_len_pos_ = static_cast<uint32_t>(val_len_pos);
+    val_pos_ = static_cast<uint32_t>(pos);
+
+    if (num_of_entries > 0 && encoded.length() < val_pos_ + value_end(num_of_entries - 1)) {
+        throw DecodingError("input too short");
+    }
 }
 
-std::optional<ByteView> StorageChanges::find(ByteView b, ByteView composite_key) {
+ByteView StorageChangeSetView::contract_address(uint32_t contract_idx) const noexcept {
+    return encoded_.substr(4 + contract_idx * (kAddressLen + 4), kAddressLen);
+}
+
+uint32_t StorageChangeSetView::contract_end(uint32_t contract_idx) const noexcept {
+    return boost::endian::load_big_u32(&encoded_[(contract_idx + 1) * (kAddressLen + 4)]);
+}
+
+uint64_t StorageChangeSetView::incarnation(uint32_t contract_idx) const noexcept {
     using CI = boost::counting_iterator<uint32_t>;
     using boost::endian::load_big_u32;
-    using boost::endian::load_big_u64;
 
-    assert(composite_key.length() == kStoragePrefixLength + kHashLen);
+    const uint8_t* incarnations{&encoded_[incarnation_pos_]};
+    uint32_t i{*std::lower_bound(CI(0), CI(num_of_non_default_incarnations_), contract_idx,
+                                 [incarnations](uint32_t i, uint32_t contract_idx) {
+                                     return load_big_u32(incarnations + 12 * i) < contract_idx;
+                                 })};
+    if (i == num_of_non_default_incarnations_ || load_big_u32(incarnations + 12 * i) != contract_idx) {
+        return kDefaultIncarnation;
+    }
+    return boost::endian::load_big_u64(incarnations + 12 * i + 4);
+}
+
+uint32_t StorageChangeSetView::value_end(uint32_t i) const noexcept {
+    using boost::endian::load_big_u16;
+    using boost::endian::load_big_u32;
 
-    if (b.empty()) {
-        return {};
+    const uint8_t* lengths{&encoded_[val_len_pos_]};
+    if (i < num_of_uint8_val_lens_) {
+        return lengths[i];
     }
+    i -= num_of_uint8_val_lens_;
+    lengths += num_of_uint8_val_lens_;
+    if (i < num_of_uint16_val_lens_) {
+        return load_big_u16(lengths + i * 2);
+    }
+    i -= num_of_uint16_val_lens_;
+    lengths += num_of_uint16_val_lens_ * 2;
+    return load_big_u32(lengths + i * 4);
+}
 
-    ByteView address{composite_key.substr(0, kAddressLen)};
-    uint64_t incarnation{load_big_u64(&composite_key[kAddressLen])};
-    ByteView key{composite_key.substr(kStoragePrefixLength)};
+ByteView StorageChangeSetView::value(uint32_t i) const noexcept {
+    uint32_t from{i > 0 ? value_end(i - 1) : 0};
+    return encoded_.substr(val_pos_ + from, value_end(i) - from);
+}
 
-    auto [num_of_contracts, num_of_non_default_incarnations, incarnation_pos, key_pos, val_pos]{decode_storage_meta(b)};
+StorageChangeSetView::Entry StorageChangeSetView::entry(uint32_t i, uint32_t contract_idx) const noexcept {
+    return {contract_address(contract_idx), incarnation(contract_idx),
+            encoded_.substr(key_pos_ + i * kHashLen, kHashLen), value(i)};
+}
+
+StorageChangeSetView::Entry StorageChangeSetView::operator[](size_t i) const noexcept {
+    using CI = boost::counting_iterator<uint32_t>;
 
-    uint32_t contract_idx{*std::lower_bound(CI(0), CI(num_of_contracts), address, [b](uint32_t i, ByteView address) {
-        return storage_address(b, i) < address;
-    })};
+    assert(i < num_of_entries_);
 
-    if (contract_idx >= num_of_contracts || storage_address(b, contract_idx) != address) {
-        return {};
+    uint32_t contract_idx{*std::upper_bound(CI(0), CI(num_of_contracts_), static_cast<uint32_t>(i),
+                                            [this](uint32_t i, uint32_t contract_idx) {
+                                                return i < contract_end(contract_idx);
+                                            })};
+    return entry(static_cast<uint32_t>(i), contract_idx);
+}
+
+StorageChangeSetView::Iterator& StorageChangeSetView::Iterator::operator++() {
+    ++i_;
+    while (contract_idx_ < view_->num_of_contracts_ && i_ >= view_->contract_end(contract_idx_)) {
+        ++contract_idx_;
     }
+    return *this;
+}
 
-    uint32_t num_of_incarnations{1};
-    while (contract_idx + num_of_incarnations < num_of_contracts &&
-           storage_address(b, contract_idx + num_of_incarnations) == address) {
-        ++num_of_incarnations;
+std::optional<ByteView> StorageChangeSetView::find(ByteView composite_key) const noexcept {
+    using CI = boost::counting_iterator<uint32_t>;
+
+    ByteView address{composite_key.substr(0, kAddressLen)};
+    uint64_t incarnation{boost::endian::load_big_u64(&composite_key[kAddressLen])};
+    ByteView location{composite_key.substr(kStoragePrefixLength)};
+
+    uint32_t contract_idx{*std::lower_bound(CI(0), CI(num_of_contracts_), address,
+                                            [this](uint32_t i, ByteView address) {
+                                                return contract_address(i) < address;
+                                            })};
+    if (contract_idx == num_of_contracts_ || contract_address(contract_idx) != address) {
+        return std::nullopt;
     }
 
     if (incarnation > 0) {
-        bool found{false};
+        // Several incarnations of the same contract may be present
+        while (this->incarnation(contract_idx) != incarnation) {
+            ++contract_idx;
+            if (contract_idx == num_of_contracts_ || contract_address(contract_idx) != address) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    uint32_t from{contract_idx > 0 ? contract_end(contract_idx - 1) : 0};
+    uint32_t to{contract_end(contract_idx)};
 
-        ByteView inc_view{b.substr(incarnation_pos)};
-        auto incarnation_contract_idx{[inc_view](uint32_t i) { return load_big_u32(&inc_view[12 * i]); }};
+    auto location_at{[this](uint32_t i) { return encoded_.substr(key_pos_ + i * kHashLen, kHashLen); }};
+
+    uint32_t i{*std::lower_bound(CI(from), CI(to), location,
+                                 [&location_at](uint32_t i, ByteView location) { return location_at(i) < location; })};
+    if (i == to || location_at(i) != location) {
+        return std::nullopt;
+    }
+    return value(i);
+}
 
-        for (uint32_t i{0}; i < num_of_incarnations; ++i) {
-            uint32_t incarnation_idx{*std::lower_bound(
-                CI(0), CI(num_of_non_default_incarnations), contract_idx,
-                [&](uint32_t i, uint32_t contract_idx) { return incarnation_contract_idx(i) < contract_idx; })};
+void AccountChangeSetBuilder::clear() noexcept {
+    records_.clear();
+    values_.clear();
+    sorted_ = true;
+}
+
+void AccountChangeSetBuilder::insert(const evmc::address& address, ByteView encoded_value) {
+    uint32_t offset{static_cast<uint32_t>(values_.length())};
+    values_.append(encoded_value);
+    records_.push_back({address, offset, static_cast<uint32_t>(encoded_value.length()),
+                        static_cast<uint32_t>(records_.size())});
+    sorted_ = false;
+}
+
+void AccountChangeSetBuilder::insert(const evmc::address& address, const std::optional<Account>& account,
+                                     bool omit_code_hash) {
+    uint32_t offset{static_cast<uint32_t>(values_.length())};
+    if (account) {
+        account->encode_for_storage(values_, omit_code_hash);
+    }
+    records_.push_back({address, offset, static_cast<uint32_t>(values_.length() - offset),
+                        static_cast<uint32_t>(records_.size())});
+    sorted_ = false;
+}
 
-            uint64_t found_incarnation{kDefaultIncarnation};
-            if (incarnation_idx < num_of_non_default_incarnations &&
-                incarnation_contract_idx(incarnation_idx) == contract_idx) {
-                found_incarnation = load_big_u64(&inc_view[12 * incarnation_idx + 4]);
+void AccountChangeSetBuilder::sort() {
+    if (!sorted_) {
+        sort_keeping_last(records_, [](const Record& a, const Record& b) { return a.address < b.address; });
+        sorted_ = true;
+    }
+}
+
+void AccountChangeSetBuilder::encode(Bytes& out) {
+    using boost::endian::store_big_u32;
+
+    sort();
+
+    const size_t n{records_.size()};
+    size_t len_of_vals{0};
+    for (const Record& record : records_) {
+        len_of_vals += record.value_length;
+    }
+    out.resize(4 + n * (kAddressLen + 4) + len_of_vals);
+
+    uint8_t* addresses{&out[4]};
+    uint8_t* lengths{addresses + n * kAddressLen};
+    uint8_t* vals{lengths + n * 4};
+
+    store_big_u32(&out[0], static_cast<uint32_t>(n));
+    uint32_t cumulative_len{0};
+    for (const Record& record : records_) {
+        std::memcpy(addresses, record.address.bytes, kAddressLen);
+        addresses += kAddressLen;
+        cumulative_len += record.value_length;
+        store_big_u32(lengths, cumulative_len);
+        lengths += 4;
+        std::memcpy(vals, &values_[record.value_offset], record.value_length);
+        vals += record.value_length;
+    }
+}
+
+AccountChanges AccountChangeSetBuilder::to_changes() const {
+    AccountChanges changes;
+    for (const Record& record : records_) {
+        changes[record.address] = values_.substr(record.value_offset, record.value_length);
+    }
+    return changes;
+}
+
+void StorageChangeSetBuilder::clear() noexcept {
+    records_.clear();
+    sorted_ = true;
+}
+
+void StorageChangeSetBuilder::insert(const evmc::address& address, uint64_t incarnation,
+                                     const evmc::bytes32& location, ByteView value) {
+    assert(value.length() <= kHashLen);
+    Record& record{records_.emplace_back()};
+    record.address = address;
+    record.incarnation = incarnation;
+    record.location = location;
+    record.seq = static_cast<uint32_t>(records_.size() - 1);
+    record.value_length = static_cast<uint8_t>(value.length());
+    std::memcpy(record.value, value.data(), value.length());
+    sorted_ = false;
+}
+
+void StorageChangeSetBuilder::sort() {
+    if (!sorted_) {
+        sort_keeping_last(records_, [](const Record& a, const Record& b) {
+            if (a.address != b.address) {
+                return a.address < b.address;
+            } else if (a.incarnation != b.incarnation) {
+                return a.incarnation < b.incarnation;
+            }
+            return a.location < b.location;
+        });
+        sorted_ = true;
+    }
+}
+
+void StorageChangeSetBuilder::encode(Bytes& out) {
+    using boost::endian::store_big_u16;
+    using boost::endian::store_big_u32;
+    using boost::endian::store_big_u64;
+
+    sort();
+
+    auto same_contract{[](const Record& a, const Record& b) {
+        return a.address == b.address && a.incarnation == b.incarnation;
+    }};
+
+    // Sizes of the sections first
+    uint32_t num_of_contracts{0};
+    uint32_t num_of_non_default_incarnations{0};
+    uint32_t num_of_uint8_val_lens{0};
+    uint32_t num_of_uint16_val_lens{0};
+    uint32_t num_of_uint32_val_lens{0};
+    uint32_t len_of_vals{0};
+    for (size_t i{0}; i < records_.size(); ++i) {
+        if (i == 0 || !same_contract(records_[i - 1], records_[i])) {
+            ++num_of_contracts;
+            if (records_[i].incarnation != kDefaultIncarnation) {
+                ++num_of_non_default_incarnations;
             }
+        }
+        len_of_vals += records_[i].value_length;
+        if (len_of_vals < 0x100) {
+            ++num_of_uint8_val_lens;
+        } else if (len_of_vals < 0x10000) {
+            ++num_of_uint16_val_lens;
+        } else {
+            ++num_of_uint32_val_lens;
+        }
+    }
 
-            if (found_incarnation == incarnation) {
-                found = true;
-                break;
-            } else {
-                ++contract_idx;
+    size_t contract_pos{4};
+    size_t incarnation_pos{contract_pos + num_of_contracts * (kAddressLen + 4) + 4};
+    size_t key_pos{incarnation_pos + num_of_non_default_incarnations * 12};
+    size_t val_len_pos{key_pos + records_.size() * kHashLen + 3 * 4};
+    size_t val_pos{val_len_pos + num_of_uint8_val_lens + num_of_uint16_val_lens * 2 + num_of_uint32_val_lens * 4};
+    out.resize(val_pos + len_of_vals);
+
+    store_big_u32(&out[0], num_of_contracts);
+    store_big_u32(&out[incarnation_pos - 4], num_of_non_default_incarnations);
+    store_big_u32(&out[val_len_pos - 12], num_of_uint8_val_lens);
+    store_big_u32(&out[val_len_pos - 8], num_of_uint16_val_lens);
+    store_big_u32(&out[val_len_pos - 4], num_of_uint32_val_lens);
+
+    // Then everything in a single pass
+    uint32_t contract_idx{0};
+    len_of_vals = 0;
+    for (size_t i{0}; i < records_.size(); ++i) {
+        const Record& record{records_[i]};
+        if (i > 0 && !same_contract(records_[i - 1], record)) {
+            contract_pos += kAddressLen + 4;
+            ++contract_idx;
+        }
+        if (i == 0 || !same_contract(records_[i - 1], record)) {
+            std::memcpy(&out[contract_pos], record.address.bytes, kAddressLen);
+            if (record.incarnation != kDefaultIncarnation) {
+                store_big_u32(&out[incarnation_pos], contract_idx);
+                store_big_u64(&out[incarnation_pos + 4], record.incarnation);
+                incarnation_pos += 12;
             }
         }
+        store_big_u32(&out[contract_pos + kAddressLen], static_cast<uint32_t>(i + 1));
+
+        std::memcpy(&out[key_pos], record.location.bytes, kHashLen);
+        key_pos += kHashLen;
 
-        if (!found) {
-            return {};
+        len_of_vals += record.value_length;
+        if (len_of_vals < 0x100) {
+            out[val_len_pos] = static_cast<uint8_t>(len_of_vals);
+            val_len_pos += 1;
+        } else if (len_of_vals < 0x10000) {
+            store_big_u16(&out[val_len_pos], static_cast<uint16_t>(len_of_vals));
+            val_len_pos += 2;
+        } else {
+            store_big_u32(&out[val_len_pos], len_of_vals);
+            val_len_pos += 4;
         }
-    }
 
-    uint32_t from{0};
-    if (contract_idx > 0) {
-        from = load_big_u32(&b[contract_idx * (kAddressLen + 4)]);
-    }
-    uint32_t to{load_big_u32(&b[(contract_idx + 1) * (kAddressLen + 4)])};
-
-    ByteView key_view{b.substr(key_pos)};
-    uint32_t key_idx{*std::lower_bound(CI(from), CI(to), key, [key_view](uint32_t i, ByteView key) {
-        return key_view.substr(i * kHashLen, kHashLen) < key;
-    })};
-    if (key_idx == to || key_view.substr(key_idx * kHashLen, kHashLen) != key) {
-        return {};
+        std::memcpy(&out[val_pos], record.value, record.value_length);
+        val_pos += record.value_length;
     }
+}
 
-    return find_value(b.substr(val_pos), key_idx);
+StorageChanges StorageChangeSetBuilder::to_changes() const {
+    StorageChanges changes;
+    for (const Record& record : records_) {
+        changes[storage_key(record.address, record.incarnation, record.location)] =
+            Bytes{record.value, record.value_length};
+    }
+    return changes;
 }
+
 }  // namespace silkworm::db
@@ -24,9 +24,13 @@ see its package changeset.
 
 #include <absl/container/btree_map.h>
 
+#include <cstddef>
 #include <evmc/evmc.hpp>
+#include <iterator>
 #include <optional>
 #include <silkworm/common/base.hpp>
+#include <silkworm/types/account.hpp>
+#include <vector>
 
 namespace silkworm::db {
 
@@ -47,10 +51,223 @@ class StorageChanges : public absl::btree_map<Bytes, Bytes> {
     // Turbo-Geth EncodeStoragePlain
     Bytes encode() const;
 
+    // Turbo-Geth DecodeStoragePlain
+    static StorageChanges decode(ByteView encoded);
+
     // Turbo-Geth (StorageChangeSetPlainBytes)FindWithIncarnation
     static std::optional<ByteView> find(ByteView encoded, ByteView key);
 };
 
+/** @brief Read-only view of an account change set in the Turbo-Geth plain format.
+ *
+ * Parses the metadata once on construction; iteration, access by index and lookup by address
+ * neither copy nor allocate. Returned views point into the encoded change set.
+ */
+class AccountChangeSetView {
+  public:
+    struct Entry {
+        ByteView address;
+        ByteView value;
+    };
+
+    class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Entry;
+
+        Iterator(const AccountChangeSetView* view, uint32_t i) : view_{view}, i_{i} {}
+
+        Entry operator*() const { return (*view_)[i_]; }
+
+        Iterator& operator++() {
+            ++i_;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return i_ == other.i_; }
+        bool operator!=(const Iterator& other) const { return i_ != other.i_; }
+
+      private:
+        const AccountChangeSetView* view_;
+        uint32_t i_;
+    };
+
+    AccountChangeSetView() = default;
+
+    // Throws DecodingError
+    explicit AccountChangeSetView(ByteView encoded);
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    Entry operator[](size_t i) const noexcept;
+
+    // Binary search by address
+    std::optional<ByteView> find(ByteView address) const noexcept;
+
+    Iterator begin() const { return {this, 0}; }
+    Iterator end() const { return {this, size_}; }
+
+  private:
+    ByteView encoded_{};
+    uint32_t size_{0};
+    uint32_t val_pos_{0};
+};
+
+/** @brief Read-only view of a storage change set in the Turbo-Geth plain format.
+ * See AccountChangeSetView.
+ */
+class StorageChangeSetView {
+  public:
+    struct Entry {
+        ByteView address;
+        uint64_t incarnation{0};
+        ByteView location;
+        ByteView value;
+    };
+
+    class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Entry;
+
+        Iterator(const StorageChangeSetView* view, uint32_t i, uint32_t contract_idx)
+            : view_{view}, i_{i}, contract_idx_{contract_idx} {}
+
+        Entry operator*() const { return view_->entry(i_, contract_idx_); }
+
+        Iterator& operator++();
+
+        bool operator==(const Iterator& other) const { return i_ == other.i_; }
+        bool operator!=(const Iterator& other) const { return i_ != other.i_; }
+
+      private:
+        const StorageChangeSetView* view_;
+        uint32_t i_;
+        uint32_t contract_idx_;  // contract of the i-th entry
+    };
+
+    StorageChangeSetView() = default;
+
+    // Throws DecodingError
+    explicit StorageChangeSetView(ByteView encoded);
+
+    size_t size() const noexcept { return num_of_entries_; }
+    bool empty() const noexcept { return num_of_entries_ == 0; }
+
+    Entry operator[](size_t i) const noexcept;
+
+    // Lookup by address + incarnation + location; see StorageChanges::find
+    std::optional<ByteView> find(ByteView composite_key) const noexcept;
+
+    Iterator begin() const { return {this, 0, 0}; }
+    Iterator end() const { return {this, num_of_entries_, num_of_contracts_}; }
+
+  private:
+    ByteView contract_address(uint32_t contract_idx) const noexcept;
+
+    // Cumulative number of entries up to and including the contract
+    uint32_t contract_end(uint32_t contract_idx) const noexcept;
+
+    uint64_t incarnation(uint32_t contract_idx) const noexcept;
+
+    // Cumulative length of values up to and including the i-th entry
+    uint32_t value_end(uint32_t i) const noexcept;
+
+    ByteView value(uint32_t i) const noexcept;
+
+    Entry entry(uint32_t i, uint32_t contract_idx) const noexcept;
+
+    ByteView encoded_{};
+    uint32_t num_of_contracts_{0};
+    uint32_t num_of_entries_{0};
+    uint32_t num_of_non_default_incarnations_{0};
+    uint32_t incarnation_pos_{0};
+    uint32_t key_pos_{0};
+    uint32_t num_of_uint8_val_lens_{0};
+    uint32_t num_of_uint16_val_lens_{0};
+    uint32_t val_len_pos_{0};
+    uint32_t val_pos_{0};
+};
+
+/** @brief Accumulates account changes of a block and encodes them in the Turbo-Geth plain format.
+ *
+ * Records are fixed-size and kept in a contiguous array with values in a single arena;
+ * they are sorted once on encoding. Buffers are retained by clear(), so a builder reused
+ * block after block stops allocating once it has seen its largest block.
+ */
+class AccountChangeSetBuilder {
+  public:
+    void clear() noexcept;
+
+    bool empty() const noexcept { return records_.empty(); }
+
+    // A later insertion for the same address supersedes an earlier one
+    void insert(const evmc::address& address, ByteView encoded_value);
+
+    // Inserts the storage encoding of the account or an empty value if there's none
+    void insert(const evmc::address& address, const std::optional<Account>& account, bool omit_code_hash);
+
+    // Turbo-Geth EncodeAccountsPlain; out is resized to the exact encoding length
+    void encode(Bytes& out);
+
+    AccountChanges to_changes() const;
+
+  private:
+    struct Record {
+        evmc::address address;
+        uint32_t value_offset{0};
+        uint32_t value_length{0};
+        uint32_t seq{0};  // order of insertion
+    };
+
+    void sort();
+
+    std::vector<Record> records_;
+    Bytes values_;
+    bool sorted_{true};
+};
+
+/** @brief Accumulates storage changes of a block and encodes them in the Turbo-Geth plain format.
+ * See AccountChangeSetBuilder.
+ */
+class StorageChangeSetBuilder {
+  public:
+    void clear() noexcept;
+
+    bool empty() const noexcept { return records_.empty(); }
+
+    // A later insertion for the same address, incarnation & location supersedes an earlier one.
+    // Values are at most 32 bytes long.
+    void insert(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location, ByteView value);
+
+    // Turbo-Geth EncodeStoragePlain; out is resized to the exact encoding length
+    void encode(Bytes& out);
+
+    StorageChanges to_changes() const;
+
+  private:
+    struct Record {
+        evmc::address address;
+        uint64_t incarnation{0};
+        evmc::bytes32 location;
+        uint32_t seq{0};  // order of insertion
+        uint8_t value_length{0};
+        uint8_t value[kHashLength];
+    };
+
+    void sort();
+
+    std::vector<Record> records_;
+    bool sorted_{true};
+};
+
 }  // namespace silkworm::db
 
 #endif  // SILKWORM_DB_CHANGE_H_
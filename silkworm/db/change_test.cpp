@@ -63,6 +63,8 @@ TEST_CASE("Storage change") {
     sc[storage_key(contract_a, 2, key6)] = zeroless_view(val6);
 
     CHECK(to_hex(sc.encode()) == to_hex(encoded));
+    CHECK(StorageChanges::decode(encoded) == sc);
+    CHECK(StorageChanges::decode({}).empty());
 
     CHECK(StorageChanges::find(encoded, storage_key(contract_a, 2, key1)) == zeroless_view(val1));
     CHECK(StorageChanges::find(encoded, storage_key(contract_b, 1, key2)) == zeroless_view(val2));
@@ -75,4 +77,165 @@ TEST_CASE("Storage change") {
     CHECK(!StorageChanges::find(encoded, storage_key(contract_d, 2, key1)));
     CHECK(!StorageChanges::find(encoded, storage_key(contract_b, 1, {})));
 }
+
+TEST_CASE("Account change set builder") {
+    auto address_a{0x6f0e0cdac6c716a00bd8db4d0eee4f2bfccf8e6a_address};
+    auto address_b{0xc5acb79c258108f288288bc26f7820d06f45f08c_address};
+
+    Account account{};
+    account.nonce = 5;
+    account.balance = 1'000'000;
+
+    AccountChangeSetBuilder builder;
+    Bytes encoded{};
+    builder.encode(encoded);
+    CHECK(to_hex(encoded) == "00000000");
+
+    builder.insert(address_b, from_hex("0102"));
+    builder.insert(address_a, std::nullopt, /*omit_code_hash=*/false);
+    builder.insert(address_b, account, /*omit_code_hash=*/true);  // supersedes
+
+    AccountChanges expected{};
+    expected[address_a] = {};
+    expected[address_b] = account.encode_for_storage(/*omit_code_hash=*/true);
+    CHECK(builder.to_changes() == expected);
+
+    builder.encode(encoded);
+    CHECK(to_hex(encoded) == to_hex(expected.encode()));
+    CHECK(AccountChanges::decode(encoded) == expected);
+
+    builder.clear();
+    CHECK(builder.empty());
+    builder.encode(encoded);
+    CHECK(to_hex(encoded) == "00000000");
+}
+
+TEST_CASE("Storage change set builder") {
+    auto contract_a{0x6f0e0cdac6c716a00bd8db4d0eee4f2bfccf8e6a_address};
+    auto contract_b{0xc5acb79c258108f288288bc26f7820d06f45f08c_address};
+
+    auto key1{0xa4e69cebbf4f8f3a1c6e493a6983d8a5879d22057a7c73b00e105d7c7e21efbc_bytes32};
+    auto key2{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+
+    StorageChangeSetBuilder builder;
+    StorageChanges expected{};
+
+    // enough values to need uint16 cumulative lengths
+    for (uint8_t i{0}; i < 20; ++i) {
+        evmc::bytes32 location{key2};
+        location.bytes[0] = i;
+        Bytes value(kHashLength, i);
+        builder.insert(contract_b, 3, location, value);
+        expected[storage_key(contract_b, 3, location)] = value;
+    }
+    builder.insert(contract_a, kDefaultIncarnation, key1, from_hex("01"));
+    builder.insert(contract_a, 2, key1, {});
+    builder.insert(contract_a, kDefaultIncarnation, key1, from_hex("2a"));  // supersedes
+    expected[storage_key(contract_a, kDefaultIncarnation, key1)] = from_hex("2a");
+    expected[storage_key(contract_a, 2, key1)] = {};
+
+    CHECK(builder.to_changes() == expected);
+
+    Bytes encoded{};
+    builder.encode(encoded);
+    CHECK(StorageChanges::decode(encoded) == expected);
+    CHECK(StorageChanges::find(encoded, storage_key(contract_a, kDefaultIncarnation, key1)) == from_hex("2a"));
+    CHECK(StorageChanges::find(encoded, storage_key(contract_b, 3, key2)) == Bytes(kHashLength, 0));
+}
+
+TEST_CASE("Account change set view") {
+    auto address_a{0x6f0e0cdac6c716a00bd8db4d0eee4f2bfccf8e6a_address};
+    auto address_b{0xc5acb79c258108f288288bc26f7820d06f45f08c_address};
+    auto address_c{0x1cbdd8336800dc3fe27daf5fb5188f0502ac1fc7_address};
+
+    CHECK(AccountChangeSetView{}.empty());
+    CHECK(AccountChangeSetView{ByteView{}}.empty());
+    CHECK(AccountChangeSetView{from_hex("00000000")}.empty());
+    CHECK_THROWS_AS(AccountChangeSetView{from_hex("000000")}, DecodingError);
+    CHECK_THROWS_AS(AccountChangeSetView{from_hex("00000001")}, DecodingError);
+
+    AccountChanges changes{};
+    changes[address_a] = from_hex("0102");
+    changes[address_b] = {};
+    Bytes encoded{changes.encode()};
+
+    AccountChangeSetView view{encoded};
+    REQUIRE(view.size() == 2);
+    CHECK(view[0].address == full_view(address_a));
+    CHECK(view[0].value == from_hex("0102"));
+    CHECK(view[1].address == full_view(address_b));
+    CHECK(view[1].value.empty());
+
+    AccountChanges iterated{};
+    for (const AccountChangeSetView::Entry& entry : view) {
+        iterated[to_address(entry.address)] = entry.value;
+    }
+    CHECK(iterated == changes);
+
+    CHECK(view.find(full_view(address_a)) == from_hex("0102"));
+    CHECK(view.find(full_view(address_b)) == ByteView{});
+    CHECK(!view.find(full_view(address_c)));
+
+    CHECK_THROWS_AS(AccountChangeSetView{ByteView{encoded}.substr(0, encoded.length() - 1)}, DecodingError);
+}
+
+TEST_CASE("Storage change set view") {
+    auto contract_a{0x6f0e0cdac6c716a00bd8db4d0eee4f2bfccf8e6a_address};
+    auto contract_b{0xc5acb79c258108f288288bc26f7820d06f45f08c_address};
+
+    auto key1{0xa4e69cebbf4f8f3a1c6e493a6983d8a5879d22057a7c73b00e105d7c7e21efbc_bytes32};
+    auto key2{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+
+    CHECK(StorageChangeSetView{}.empty());
+    CHECK(StorageChangeSetView{ByteView{}}.empty());
+    CHECK_THROWS_AS(StorageChangeSetView{from_hex("00000001")}, DecodingError);
+
+    StorageChangeSetBuilder builder;
+    builder.insert(contract_a, kDefaultIncarnation, key1, from_hex("01"));
+    builder.insert(contract_a, 2, key1, {});
+    builder.insert(contract_a, 2, key2, from_hex("0203"));
+    for (uint8_t i{0}; i < 20; ++i) {
+        evmc::bytes32 location{key2};
+        location.bytes[0] = i;
+        builder.insert(contract_b, 3, location, Bytes(kHashLength, i));
+    }
+    Bytes encoded{};
+    builder.encode(encoded);
+
+    StorageChangeSetView view{encoded};
+    REQUIRE(view.size() == 23);
+
+    CHECK(view[0].address == full_view(contract_a));
+    CHECK(view[0].incarnation == kDefaultIncarnation);
+    CHECK(view[0].location == full_view(key1));
+    CHECK(view[0].value == from_hex("01"));
+    CHECK(view[2].incarnation == 2);
+    CHECK(view[2].location == full_view(key1));
+    CHECK(view[2].value.empty());
+    CHECK(view[22].address == full_view(contract_b));
+    CHECK(view[22].incarnation == 3);
+    CHECK(view[22].value == Bytes(kHashLength, 19));
+
+    StorageChanges iterated{};
+    size_t i{0};
+    for (const StorageChangeSetView::Entry& entry : view) {
+        const StorageChangeSetView::Entry expected{view[i++]};
+        CHECK(entry.address == expected.address);
+        CHECK(entry.incarnation == expected.incarnation);
+        CHECK(entry.location == expected.location);
+        CHECK(entry.value == expected.value);
+        iterated[storage_key(to_address(entry.address), entry.incarnation, to_bytes32(entry.location))] = entry.value;
+    }
+    CHECK(i == view.size());
+    CHECK(iterated == builder.to_changes());
+
+    CHECK(view.find(storage_key(contract_a, kDefaultIncarnation, key1)) == from_hex("01"));
+    CHECK(view.find(storage_key(contract_a, 2, key1)) == ByteView{});
+    CHECK(view.find(storage_key(contract_a, 2, key2)) == from_hex("0203"));
+    CHECK(view.find(storage_key(contract_b, 3, key2)) == Bytes(kHashLength, 0));
+    CHECK(!view.find(storage_key(contract_a, 3, key1)));
+    CHECK(!view.find(storage_key(contract_b, 1, key2)));
+    CHECK(!view.find(storage_key(contract_a, kDefaultIncarnation, key2)));
+}
+
 }  // namespace silkworm::db
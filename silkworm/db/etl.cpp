@@ -0,0 +1,231 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "etl.hpp"
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+
+
+namespace silkworm::db::etl {
+
+constexpr size_t kEntryHeaderLength{8};
+
+// Sorted entries spilled into a file, read back sequentially
+class Collector::Run {
+  public:
+    explicit Run(const std::string& path) : read_buffer_(kReadBufferSize) {
+        in_.rdbuf()->pubsetbuf(read_buffer_.data(), read_buffer_.size());
+        in_.open(path, std::ios::binary);
+        if (!in_) {
+            throw std::runtime_error("failed to open " + path);
+        }
+        next();
+    }
+
+    bool empty() const noexcept { return empty_; }
+
+    ByteView key() const noexcept { return ByteView{entry_}.substr(0, key_length_); }
+    ByteView value() const noexcept { return ByteView{entry_}.substr(key_length_); }
+
+    void next() {
+        uint8_t header[kEntryHeaderLength];
+        if (!in_.read(reinterpret_cast<char*>(header), kEntryHeaderLength)) {
+            empty_ = true;
+            return;
+        }
+        key_length_ = boost::endian::load_big_u32(&header[0]);
+        entry_.resize(key_length_ + boost::endian::load_big_u32(&header[4]));
+        if (!in_.read(reinterpret_cast<char*>(entry_.data()), entry_.length())) {
+            throw std::runtime_error("truncated ETL run");
+        }
+    }
+
+  private:
+    static constexpr size_t kReadBufferSize{1 << 20};
+
+    std::vector<char> read_buffer_;
+    std::ifstream in_;
+    Bytes entry_{};
+    uint32_t key_length_{0};
+    bool empty_{false};
+};
+
+Collector::Collector(size_t memory_budget) : memory_budget_{memory_budget} {}
+
+ByteView Collector::key_at(uint64_t offset) const noexcept {
+    uint32_t key_length{boost::endian::load_big_u32(&buffer_[offset])};
+    return {&buffer_[offset + kEntryHeaderLength], key_length};
+}
+
+ByteView Collector::value_at(uint64_t offset) const noexcept {
+    uint32_t key_length{boost::endian::load_big_u32(&buffer_[offset])};
+    uint32_t value_length{boost::endian::load_big_u32(&buffer_[offset + 4])};
+    return {&buffer_[offset + kEntryHeaderLength + key_length], value_length};
+}
+
+void Collector::collect(ByteView key, ByteView value) {
+    offsets_.push_back(buffer_.length());
+    uint8_t header[kEntryHeaderLength];
+    boost::endian::store_big_u32(&header[0], static_cast<uint32_t>(key.length()));
+    boost::endian::store_big_u32(&header[4], static_cast<uint32_t>(value.length()));
+    buffer_.append(header, kEntryHeaderLength);
+    buffer_.append(key);
+    buffer_.append(value);
+    ++size_;
+
+    if (buffer_.length() + offsets_.size() * sizeof(uint64_t) >= memory_budget_) {
+        spill();
+    }
+}
+
+void Collector::sort_buffer() {
+    std::sort(offsets_.begin(), offsets_.end(), [this](uint64_t a, uint64_t b) {
+        ByteView key_a{key_at(a)};
+        ByteView key_b{key_at(b)};
+        return key_a < key_b || (key_a == key_b && value_at(a) < value_at(b));
+    });
+}
+
+void Collector::spill() {
+    sort_buffer();
+
+    if (!tmp_dir_) {
+        tmp_dir_ = std::make_unique<TemporaryDirectory>();
+    }
+    std::string path{std::string{tmp_dir_->path()} + "/run" + std::to_string(runs_.size())};
+    std::ofstream out{path, std::ios::binary};
+    for (uint64_t offset : offsets_) {
+        size_t length{kEntryHeaderLength + key_at(offset).length() + value_at(offset).length()};
+        out.write(reinterpret_cast<const char*>(&buffer_[offset]), length);
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("failed to write " + path);
+    }
+    runs_.push_back(path);
+
+    buffer_.clear();
+    offsets_.clear();
+}
+
+void Collector::load(const std::function<void(ByteView key, ByteView value)>& f) {
+    if (runs_.empty()) {
+        sort_buffer();
+        for (uint64_t offset : offsets_) {
+            f(key_at(offset), value_at(offset));
+        }
+        clear();
+        return;
+    }
+
+    if (!offsets_.empty()) {
+        spill();
+    }
+
+    std::vector<Run> runs;
+    runs.reserve(runs_.size());
+    for (const std::string& path : runs_) {
+        runs.emplace_back(path);
+    }
+
+    auto greater{[&runs](size_t a, size_t b) {
+        ByteView key_a{runs[a].key()};
+        ByteView key_b{runs[b].key()};
+        return key_a > key_b || (key_a == key_b && runs[a].value() > runs[b].value());
+    }};
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> queue{greater};
+    for (size_t i{0}; i < runs.size(); ++i) {
+        if (!runs[i].empty()) {
+            queue.push(i);
+        }
+    }
+
+    while (!queue.empty()) {
+        size_t i{queue.top()};
+        queue.pop();
+        f(runs[i].key(), runs[i].value());
+        runs[i].next();
+        if (!runs[i].empty()) {
+            queue.push(i);
+        }
+    }
+
+    runs.clear();
+    clear();
+}
+
+void Collector::load(lmdb::Table& table, const Reducer& reducer) {
+    unsigned table_flags{0};
+    lmdb::err_handler(table.get_flags(&table_flags));
+    const bool dupsort{(table_flags & MDB_DUPSORT) != 0};
+
+    auto put{[&](ByteView key, ByteView value, bool first_of_key) {
+        table.put(key, value, table.append_flag(key, first_of_key));
+    }};
+
+    Bytes previous_key{};
+    Bytes previous_value{};
+    bool has_previous{false};
+
+    if (dupsort && !reducer) {
+        load([&](ByteView key, ByteView value) {
+            bool first_of_key{!has_previous || key != ByteView{previous_key}};
+            if (!first_of_key && value == ByteView{previous_value}) {
+                return;  // LMDB keeps distinct values only
+            }
+            put(key, value, first_of_key);
+            previous_key = key;
+            previous_value = value;
+            has_previous = true;
+        });
+        return;
+    }
+
+    // Otherwise values of the same key are combined
+    load([&](ByteView key, ByteView value) {
+        if (has_previous && key == ByteView{previous_key}) {
+            if (reducer) {
+                reducer(key, previous_value, value);
+            } else {
+                previous_value = value;
+            }
+            return;
+        }
+        if (has_previous) {
+            put(previous_key, previous_value, /*first_of_key=*/true);
+        }
+        previous_key = key;
+        previous_value = value;
+        has_previous = true;
+    });
+    if (has_previous) {
+        put(previous_key, previous_value, /*first_of_key=*/true);
+    }
+}
+
+void Collector::clear() {
+    size_ = 0;
+    buffer_.clear();
+    offsets_.clear();
+    runs_.clear();
+    tmp_dir_.reset();
+}
+
+}  // namespace silkworm::db::etl
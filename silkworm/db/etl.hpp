@@ -0,0 +1,95 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_ETL_H_
+#define SILKWORM_DB_ETL_H_
+
+/*
+Extract, Transform, Load: bulk loading of tables in key order.
+See also Turbo-Geth package etl.
+*/
+
+#include <functional>
+#include <memory>
+#include <silkworm/common/base.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <string>
+#include <vector>
+
+namespace silkworm::db::etl {
+
+/** @brief Collects key/value pairs in any order and hands them back sorted by key and then by value.
+ *
+ * Entries are buffered in memory until they exceed memory_budget; the buffer is then sorted and
+ * spilled as a run into a file of a temporary directory. Loading k-way merges the runs.
+ *
+ * Not thread-safe.
+ */
+class Collector {
+  public:
+    // Combines value into the accumulated value of key; values of a key come in ascending order
+    using Reducer = std::function<void(ByteView key, Bytes& accumulated, ByteView value)>;
+
+    explicit Collector(size_t memory_budget = 256 << 20);
+
+    Collector(const Collector&) = delete;
+    Collector& operator=(const Collector&) = delete;
+
+    void collect(ByteView key, ByteView value);
+
+    // Number of entries collected so far
+    size_t size() const noexcept { return size_; }
+
+    /** Calls f for all the collected entries in ascending order, including duplicates, and clears the collector.
+     * The passed views are only valid during the call.
+     */
+    void load(const std::function<void(ByteView key, ByteView value)>& f);
+
+    /** @brief Writes all the collected entries into the table and clears the collector.
+     *
+     * Entries with keys past the last key of the table are written with MDB_APPEND (MDB_APPENDDUP for
+     * further values of a DUPSORT key), the rest with plain puts.
+     * With a reducer all the values of a key are combined into one.
+     * Otherwise DUPSORT tables get all the distinct values, while other tables get the last (greatest) value.
+     */
+    void load(lmdb::Table& table, const Reducer& reducer = {});
+
+    void clear();
+
+  private:
+    class Run;
+
+    // Entries are laid out in the buffer as key length (uint32), value length (uint32), key, value
+    ByteView key_at(uint64_t offset) const noexcept;
+    ByteView value_at(uint64_t offset) const noexcept;
+
+    void sort_buffer();
+    void spill();
+
+    size_t memory_budget_;
+    size_t size_{0};
+
+    Bytes buffer_{};
+    std::vector<uint64_t> offsets_{};  // of the buffered entries
+
+    std::unique_ptr<TemporaryDirectory> tmp_dir_{};  // created on first spill
+    std::vector<std::string> runs_{};
+};
+
+}  // namespace silkworm::db::etl
+
+#endif  // SILKWORM_DB_ETL_H_
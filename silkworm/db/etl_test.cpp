@@ -0,0 +1,167 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "etl.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <map>
+#include <random>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/util.hpp>
+#include <utility>
+#include <vector>
+
+namespace silkworm::db::etl {
+
+static std::vector<std::pair<Bytes, Bytes>> random_entries(size_t n) {
+    std::mt19937_64 rng{n};
+    std::vector<std::pair<Bytes, Bytes>> entries(n);
+    for (auto& [key, value] : entries) {
+        key = Bytes(1 + rng() % 4, '\0');
+        for (uint8_t& byte : key) {
+            byte = static_cast<uint8_t>(rng() % 4);  // plenty of duplicate keys
+        }
+        value = Bytes(rng() % 3, static_cast<uint8_t>(rng()));
+    }
+    return entries;
+}
+
+static std::vector<std::pair<Bytes, Bytes>> collect_and_load(Collector& collector,
+                                                             const std::vector<std::pair<Bytes, Bytes>>& entries) {
+    for (const auto& [key, value] : entries) {
+        collector.collect(key, value);
+    }
+    CHECK(collector.size() == entries.size());
+
+    std::vector<std::pair<Bytes, Bytes>> loaded;
+    collector.load([&loaded](ByteView key, ByteView value) { loaded.emplace_back(key, value); });
+    CHECK(collector.size() == 0);
+    return loaded;
+}
+
+TEST_CASE("ETL collector") {
+    std::vector<std::pair<Bytes, Bytes>> entries{random_entries(10'000)};
+    std::vector<std::pair<Bytes, Bytes>> sorted{entries};
+    std::sort(sorted.begin(), sorted.end());
+
+    SECTION("in memory") {
+        Collector collector;
+        CHECK(collect_and_load(collector, entries) == sorted);
+    }
+
+    SECTION("spilled runs") {
+        Collector collector{/*memory_budget=*/1'000};
+        CHECK(collect_and_load(collector, entries) == sorted);
+
+        // reusable after loading
+        CHECK(collect_and_load(collector, entries) == sorted);
+    }
+
+    SECTION("empty") {
+        Collector collector;
+        CHECK(collect_and_load(collector, {}).empty());
+    }
+}
+
+static std::vector<std::pair<Bytes, Bytes>> read_table(lmdb::Table& table) {
+    std::vector<std::pair<Bytes, Bytes>> entries;
+    MDB_val key, data;
+    for (int rc{table.get_first(&key, &data)}; rc == MDB_SUCCESS; rc = table.get_next(&key, &data)) {
+        entries.emplace_back(from_mdb_val(key), from_mdb_val(data));
+    }
+    return entries;
+}
+
+TEST_CASE("ETL collector into a table") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+
+    std::vector<std::pair<Bytes, Bytes>> entries{random_entries(10'000)};
+    std::vector<std::pair<Bytes, Bytes>> sorted{entries};
+    std::sort(sorted.begin(), sorted.end());
+
+    // Spilled runs as well
+    Collector collector{/*memory_budget=*/1'000};
+    for (const auto& [key, value] : entries) {
+        collector.collect(key, value);
+    }
+
+    SECTION("appended into an empty table") {
+        auto table{txn->open({"Plain"}, MDB_CREATE)};
+        collector.load(*table);
+
+        // Last value wins, which is the greatest one
+        std::map<Bytes, Bytes> expected;
+        for (const auto& [key, value] : sorted) {
+            expected[key] = value;
+        }
+        CHECK(read_table(*table) == std::vector<std::pair<Bytes, Bytes>>(expected.begin(), expected.end()));
+        CHECK(collector.size() == 0);
+    }
+
+    SECTION("keys not past the last one of the table") {
+        auto table{txn->open({"Plain"}, MDB_CREATE)};
+        std::map<Bytes, Bytes> expected{
+            {from_hex("00"), from_hex("aa")},      // overwritten
+            {from_hex("0105ff"), from_hex("bb")},  // kept, no collected key is like it
+            {from_hex("0203"), from_hex("cc")},    // overwritten, and the last key of the table
+        };
+        for (const auto& [key, value] : expected) {
+            table->put(key, value);
+        }
+
+        collector.load(*table);
+
+        for (const auto& [key, value] : sorted) {
+            expected[key] = value;
+        }
+        CHECK(read_table(*table) == std::vector<std::pair<Bytes, Bytes>>(expected.begin(), expected.end()));
+    }
+
+    SECTION("DUPSORT") {
+        auto table{txn->open({"DupSort", MDB_DUPSORT}, MDB_CREATE)};
+        table->put(from_hex("0203"), from_hex("ff"));
+
+        collector.load(*table);
+
+        // All the distinct values, the pre-existing one included
+        std::vector<std::pair<Bytes, Bytes>> expected{sorted};
+        expected.emplace_back(from_hex("0203"), from_hex("ff"));
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+        CHECK(read_table(*table) == expected);
+    }
+
+    SECTION("reducer") {
+        auto table{txn->open({"Plain"}, MDB_CREATE)};
+        table->put(from_hex("0203"), from_hex("ff"));  // overwritten by the reduced value
+
+        collector.load(*table, [](ByteView, Bytes& accumulator, ByteView value) { accumulator.append(value); });
+
+        std::map<Bytes, Bytes> expected;
+        for (const auto& [key, value] : sorted) {
+            expected[key] += value;
+        }
+        CHECK(read_table(*table) == std::vector<std::pair<Bytes, Bytes>>(expected.begin(), expected.end()));
+    }
+}
+
+}  // namespace silkworm::db::etl
@@ -0,0 +1,126 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "historical_state.hpp"
+
+#include <silkworm/common/util.hpp>
+#include <stdexcept>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+// Memoized reads are dropped once there are more than this
+constexpr size_t kMaxMemoizedReads{1'000'000};
+
+HistoricalState::HistoricalState(lmdb::Transaction& txn, uint64_t block_number, size_t window_size,
+                                 HistoryCache* history_cache)
+    : block_number_{block_number}, history_cache_{history_cache} {
+    if (window_size == 0) {
+        throw std::invalid_argument("Invalid argument : window_size");
+    }
+    for (size_t i{0}; i < window_size; ++i) {
+        load(txn, block_number + i);
+    }
+}
+
+void HistoricalState::load(lmdb::Transaction& txn, uint64_t block_number) {
+    const Bytes timestamp{encode_timestamp(block_number)};
+    auto account_table{txn.open(table::kPlainAccountChangeSet)};
+    auto storage_table{txn.open(table::kPlainStorageChangeSet)};
+    const BlockChanges& changes{
+        window_.emplace_back(account_table->get(timestamp).value_or(ByteView{}),
+                             storage_table->get(timestamp).value_or(ByteView{}))};
+
+    for (const AccountChangeSetView::Entry& entry : changes.accounts) {
+        evmc::address address{to_address(entry.address)};
+        account_index_[address].push_back(block_number);
+        accounts_.erase(address);
+    }
+    for (const StorageChangeSetView::Entry& entry : changes.storage) {
+        Bytes composite_key{storage_key(to_address(entry.address), entry.incarnation, to_bytes32(entry.location))};
+        storage_.erase(composite_key);
+        storage_index_[std::move(composite_key)].push_back(block_number);
+    }
+}
+
+void HistoricalState::advance(lmdb::Transaction& txn) {
+    const BlockChanges& passed{window_.front()};
+    for (const AccountChangeSetView::Entry& entry : passed.accounts) {
+        auto it{account_index_.find(to_address(entry.address))};
+        it->second.pop_front();
+        if (it->second.empty()) {
+            account_index_.erase(it);
+        }
+    }
+    for (const StorageChangeSetView::Entry& entry : passed.storage) {
+        auto it{storage_index_.find(
+            storage_key(to_address(entry.address), entry.incarnation, to_bytes32(entry.location)))};
+        it->second.pop_front();
+        if (it->second.empty()) {
+            storage_index_.erase(it);
+        }
+    }
+    window_.pop_front();
+
+    ++block_number_;
+    load(txn, block_number_ + window_.size());
+}
+
+std::optional<Account> HistoricalState::read_account(lmdb::Transaction& txn, const evmc::address& address) {
+    if (auto it{account_index_.find(address)}; it != account_index_.end()) {
+        return decode_account(txn, address, *changes_at(it->second.front()).accounts.find(full_view(address)));
+    }
+    if (auto it{accounts_.find(address)}; it != accounts_.end()) {
+        return it->second;
+    }
+
+    // Not changed within the window, so the value at the window's end is the same
+    std::optional<Account> account{db::read_account(txn, address, block_number_, history_cache_)};
+    if (accounts_.size() >= kMaxMemoizedReads) {
+        accounts_.clear();
+    }
+    accounts_.emplace(address, account);
+    return account;
+}
+
+evmc::bytes32 HistoricalState::read_storage(lmdb::Transaction& txn, const evmc::address& address,
+                                            uint64_t incarnation, const evmc::bytes32& key) {
+    Bytes composite_key{storage_key(address, incarnation, key)};
+    if (auto it{storage_index_.find(composite_key)}; it != storage_index_.end()) {
+        return to_bytes32(*changes_at(it->second.front()).storage.find(composite_key));
+    }
+    if (auto it{storage_.find(composite_key)}; it != storage_.end()) {
+        return it->second;
+    }
+
+    // Not changed within the window, so the value at the window's end is the same
+    evmc::bytes32 value{db::read_storage(txn, address, incarnation, key, block_number_, history_cache_)};
+    if (storage_.size() >= kMaxMemoizedReads) {
+        storage_.clear();
+    }
+    storage_.emplace(std::move(composite_key), value);
+    return value;
+}
+
+uint64_t HistoricalState::previous_incarnation(lmdb::Transaction& txn, const evmc::address& address) {
+    std::optional<uint64_t> incarnation{read_previous_incarnation(txn, address, block_number_)};
+    return incarnation ? *incarnation : 0;
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,107 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_HISTORICAL_STATE_H_
+#define SILKWORM_DB_HISTORICAL_STATE_H_
+
+#include <absl/container/btree_map.h>
+#include <absl/container/flat_hash_map.h>
+
+#include <deque>
+#include <evmc/evmc.hpp>
+#include <optional>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/change.hpp>
+#include <silkworm/db/history_cache.hpp>
+#include <silkworm/types/account.hpp>
+
+namespace silkworm::db {
+
+/** @brief Read-only view of the state at the beginning of a historical block, which can be moved forward.
+ *
+ * Change sets hold values at the beginning of a block, so the value of a key at the beginning of block N
+ * is the one in the first change set of block >= N where the key appears, or else the current one.
+ * The view keeps the change sets of a window of blocks [N; N + window_size) in memory
+ * together with an index of the keys they touch; reads of those keys are answered from the window.
+ * Other keys are looked up in history once and memoized until the window reaches their next change.
+ * Moving to the next block only drops a change set from the front of the window and loads one at its back.
+ *
+ * Loaded data is copied out of the database, so the view may outlive the transactions passed to it.
+ */
+class HistoricalState {
+  public:
+    HistoricalState(const HistoricalState&) = delete;
+    HistoricalState& operator=(const HistoricalState&) = delete;
+
+    /** Positions the view at the beginning of block_number.
+     * A history cache, if provided, is used for lookups of keys outside of the window.
+     */
+    HistoricalState(lmdb::Transaction& txn, uint64_t block_number, size_t window_size = 64,
+                    HistoryCache* history_cache = nullptr);
+
+    uint64_t block_number() const { return block_number_; }
+
+    /** Moves the view to the beginning of the next block. */
+    void advance(lmdb::Transaction& txn);
+
+    std::optional<Account> read_account(lmdb::Transaction& txn, const evmc::address& address);
+
+    evmc::bytes32 read_storage(lmdb::Transaction& txn, const evmc::address& address, uint64_t incarnation,
+                               const evmc::bytes32& key);
+
+    /** Previous non-zero incarnation of an account; 0 if none exists. */
+    uint64_t previous_incarnation(lmdb::Transaction& txn, const evmc::address& address);
+
+  private:
+    // Change sets of a block copied out of the database, viewed in place
+    struct BlockChanges {
+        BlockChanges(ByteView encoded_accounts, ByteView encoded_storage)
+            : account_bytes{encoded_accounts},
+              storage_bytes{encoded_storage},
+              accounts{account_bytes},
+              storage{storage_bytes} {}
+
+        BlockChanges(const BlockChanges&) = delete;
+        BlockChanges& operator=(const BlockChanges&) = delete;
+
+        const Bytes account_bytes;
+        const Bytes storage_bytes;
+        const AccountChangeSetView accounts;
+        const StorageChangeSetView storage;
+    };
+
+    void load(lmdb::Transaction& txn, uint64_t block_number);
+
+    const BlockChanges& changes_at(uint64_t block_number) const { return window_[block_number - block_number_]; }
+
+    uint64_t block_number_{0};
+    HistoryCache* history_cache_{nullptr};
+
+    // Change sets of blocks [block_number_; block_number_ + window_.size()); a deque never moves its elements
+    std::deque<BlockChanges> window_;
+
+    // Keys touched by the window -> blocks of the window where they change, in ascending order
+    absl::flat_hash_map<evmc::address, std::deque<uint64_t>> account_index_;
+    absl::btree_map<Bytes, std::deque<uint64_t>> storage_index_;
+
+    // Memoized values of keys not touched by the window
+    absl::flat_hash_map<evmc::address, std::optional<Account>> accounts_;
+    absl::btree_map<Bytes, evmc::bytes32> storage_;
+};
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_HISTORICAL_STATE_H_
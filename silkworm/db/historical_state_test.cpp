@@ -0,0 +1,195 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "historical_state.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <map>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+
+#include "access_layer.hpp"
+#include "history_index_builder.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static evmc::address test_address(uint64_t i) {
+    evmc::address address{};
+    boost::endian::store_big_u64(&address.bytes[kAddressLength - 8], i + 1);
+    return address;
+}
+
+static evmc::bytes32 test_location(uint64_t i) {
+    evmc::bytes32 location{};
+    boost::endian::store_big_u64(&location.bytes[kHashLength - 8], i + 1);
+    return location;
+}
+
+static Bytes encoded_account(uint64_t nonce) {
+    Account account;
+    account.nonce = nonce;
+    return account.encode_for_storage(/*omit_code_hash=*/false);
+}
+
+static Bytes storage_value(uint64_t v) {
+    evmc::bytes32 value{};
+    boost::endian::store_big_u64(&value.bytes[kHashLength - 8], v);
+    return Bytes{zeroless_view(value)};
+}
+
+constexpr uint64_t kNumOfAccounts{8};
+constexpr uint64_t kNumOfLocations{3};
+constexpr uint64_t kFirstBlock{5};  // of the change sets
+constexpr uint64_t kLastBlock{120};
+
+/* Account i changes every i + 2 blocks from kFirstBlock on, to a nonce of the block number,
+ * and is deleted every 5th time. Location j of account 0 changes every 3 * j + 4 blocks likewise.
+ * The last account never changes.
+ */
+static void write_history(lmdb::Transaction& txn) {
+    std::map<uint64_t, std::optional<uint64_t>> accounts;
+    std::map<uint64_t, uint64_t> storage;
+    accounts[kNumOfAccounts - 1] = 7;
+
+    auto account_changes{txn.open(table::kPlainAccountChangeSet)};
+    auto storage_changes{txn.open(table::kPlainStorageChangeSet)};
+    Bytes encoded;
+    for (uint64_t block_number{kFirstBlock}; block_number <= kLastBlock; ++block_number) {
+        AccountChangeSetBuilder account_builder;
+        for (uint64_t i{0}; i < kNumOfAccounts - 1; ++i) {
+            const uint64_t period{i + 2};
+            if (block_number % period != 0) {
+                continue;
+            }
+            std::optional<uint64_t>& nonce{accounts[i]};
+            account_builder.insert(test_address(i), nonce ? encoded_account(*nonce) : Bytes{});
+            if (block_number % (5 * period) == 0) {
+                nonce.reset();
+            } else {
+                nonce = block_number;
+            }
+        }
+        if (!account_builder.empty()) {
+            account_builder.encode(encoded);
+            account_changes->put(encode_timestamp(block_number), encoded);
+        }
+
+        StorageChangeSetBuilder storage_builder;
+        for (uint64_t j{0}; j < kNumOfLocations; ++j) {
+            const uint64_t period{3 * j + 4};
+            if (block_number % period != 0) {
+                continue;
+            }
+            uint64_t& value{storage[j]};
+            storage_builder.insert(test_address(0), 1, test_location(j), storage_value(value));
+            value = block_number % (5 * period) == 0 ? 0 : block_number;
+        }
+        if (!storage_builder.empty()) {
+            storage_builder.encode(encoded);
+            storage_changes->put(encode_timestamp(block_number), encoded);
+        }
+    }
+
+    auto state{txn.open(table::kPlainState)};
+    for (const auto& [i, nonce] : accounts) {
+        if (nonce) {
+            state->put(full_view(test_address(i)), encoded_account(*nonce));
+        }
+    }
+    for (const auto& [j, value] : storage) {
+        if (value) {
+            Bytes entry{full_view(test_location(j))};
+            entry.append(storage_value(value));
+            state->put(storage_prefix(test_address(0), 1), entry);
+        }
+    }
+
+    build_history_index(txn, /*storage=*/false, 1, kLastBlock + 1);
+    build_history_index(txn, /*storage=*/true, 1, kLastBlock + 1);
+}
+
+// Reads of all the keys through the view against historical reads from the DB
+static void check_state(lmdb::Transaction& txn, HistoricalState& state) {
+    const uint64_t block_number{state.block_number()};
+    // The extra key has no state at all
+    for (uint64_t i{0}; i <= kNumOfAccounts; ++i) {
+        CHECK(state.read_account(txn, test_address(i)) == read_account(txn, test_address(i), block_number));
+    }
+    for (uint64_t j{0}; j <= kNumOfLocations; ++j) {
+        CHECK(state.read_storage(txn, test_address(0), 1, test_location(j)) ==
+              read_storage(txn, test_address(0), 1, test_location(j), block_number));
+    }
+}
+
+TEST_CASE("Historical state") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+    write_history(*txn);
+
+    // Sanity check of the history itself
+    CHECK(!read_account(*txn, test_address(0), kFirstBlock + 1));
+    std::optional<Account> account{read_account(*txn, test_address(0), kFirstBlock + 2)};
+    REQUIRE(account);
+    CHECK(account->nonce == kFirstBlock + 1);
+    CHECK(!read_account(*txn, test_address(0), kLastBlock + 1));  // deleted in the last block
+    account = read_account(*txn, test_address(3), kLastBlock + 1);
+    REQUIRE(account);
+    CHECK(account->nonce == kLastBlock);
+    CHECK(!read_account(*txn, test_address(kNumOfAccounts), kLastBlock + 1));
+
+    SECTION("advancing from before the first change set to past the last one") {
+        for (size_t window_size : {1u, 4u, 64u}) {
+            HistoricalState state{*txn, 0, window_size};
+            for (uint64_t block_number{0}; block_number <= kLastBlock + 10; ++block_number) {
+                REQUIRE(state.block_number() == block_number);
+                check_state(*txn, state);
+                state.advance(*txn);
+            }
+        }
+    }
+
+    SECTION("memoized reads") {
+        // Keys are read again only every few blocks, after the window has moved past their changes
+        HistoryCache cache;
+        HistoricalState state{*txn, kFirstBlock - 1, /*window_size=*/3, &cache};
+        for (uint64_t block_number{kFirstBlock - 1}; block_number <= kLastBlock + 2; ++block_number) {
+            if (block_number % 7 == 0 || block_number > kLastBlock - 2) {
+                check_state(*txn, state);
+            }
+            state.advance(*txn);
+        }
+    }
+
+    SECTION("positioned anywhere") {
+        for (uint64_t block_number : {kFirstBlock, uint64_t{37}, kLastBlock, kLastBlock + 1, kLastBlock + 100}) {
+            HistoricalState state{*txn, block_number, /*window_size=*/8};
+            check_state(*txn, state);
+            state.advance(*txn);
+            check_state(*txn, state);
+        }
+    }
+
+    CHECK_THROWS_AS(HistoricalState(*txn, 0, /*window_size=*/0), std::invalid_argument);
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,121 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "history_cache.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static double hit_rate(uint64_t hits, uint64_t misses) {
+    uint64_t total{hits + misses};
+    return total ? static_cast<double>(hits) / total : 0;
+}
+
+double HistoryCacheStats::index_hit_rate() const { return hit_rate(index_hits, index_misses); }
+
+double HistoryCacheStats::change_set_hit_rate() const { return hit_rate(change_set_hits, change_set_misses); }
+
+std::optional<history_index::SearchResult> HistoryCache::find_change(lmdb::Transaction& txn, bool storage,
+                                                                     ByteView key, uint64_t block_number) {
+    Bytes seek_key{history_index_key(key, block_number)};
+    ByteView history_key{seek_key.data(), seek_key.length() - 8};
+    std::string prefix(reinterpret_cast<const char*>(history_key.data()), history_key.length());
+
+    std::shared_ptr<IndexChunk> chunk{};
+    if (index_chunks_.exists(prefix)) {
+        chunk = index_chunks_.get(prefix);
+        if (block_number < chunk->from || block_number > chunk->to) {
+            chunk = nullptr;
+        }
+    }
+
+    if (chunk) {
+        ++stats_.index_hits;
+    } else {
+        ++stats_.index_misses;
+
+        auto history_table{txn.open(storage ? table::kStorageHistory : table::kAccountHistory)};
+        std::optional<Entry> entry{history_table->seek(seek_key)};
+
+        chunk = std::make_shared<IndexChunk>();
+        chunk->from = block_number;
+        if (entry && entry->key.length() == seek_key.length() && has_prefix(entry->key, history_key)) {
+            // All blocks up to the chunk's key suffix land on this chunk
+            chunk->to = boost::endian::load_big_u64(&entry->key[history_key.length()]);
+            chunk->changes = history_index::Chunk{entry->value};
+        } else {
+            // No more history of this key
+            chunk->to = UINT64_MAX;
+        }
+        index_chunks_.put(prefix, chunk);
+    }
+
+    return chunk->changes.find(block_number);
+}
+
+template <class View>
+const View* HistoryCache::find_change_set(lmdb::Transaction& txn, const lmdb::TableConfig& table,
+                                          ChangeSetCache<View>& cache, uint64_t block_number) {
+    std::shared_ptr<const ChangeSet<View>> change_set{};
+    if (cache.exists(block_number)) {
+        ++stats_.change_set_hits;
+        change_set = cache.get(block_number);
+    } else {
+        ++stats_.change_set_misses;
+        auto change_table{txn.open(table)};
+        if (std::optional<ByteView> encoded{change_table->get(encode_timestamp(block_number))}; encoded) {
+            change_set = std::make_shared<const ChangeSet<View>>(*encoded);
+        }
+        cache.put(block_number, change_set);
+    }
+    // The cache holds a reference, so the view outlives change_set
+    return change_set ? &change_set->view : nullptr;
+}
+
+std::optional<ByteView> HistoryCache::find(lmdb::Transaction& txn, bool storage, ByteView key,
+                                           uint64_t block_number) {
+    std::optional<history_index::SearchResult> res{find_change(txn, storage, key, block_number)};
+    if (!res) {
+        return {};
+    }
+
+    if (res->new_record && !storage) {
+        return ByteView{};
+    }
+
+    if (storage) {
+        const StorageChangeSetView* changes{
+            find_change_set(txn, table::kPlainStorageChangeSet, storage_changes_, res->change_block)};
+        return changes ? changes->find(key) : std::nullopt;
+    }
+
+    const AccountChangeSetView* changes{
+        find_change_set(txn, table::kPlainAccountChangeSet, account_changes_, res->change_block)};
+    return changes ? changes->find(key) : std::nullopt;
+}
+
+void HistoryCache::clear() {
+    index_chunks_.clear();
+    account_changes_.clear();
+    storage_changes_.clear();
+}
+
+}  // namespace silkworm::db
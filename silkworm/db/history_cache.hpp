@@ -0,0 +1,111 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_HISTORY_CACHE_H_
+#define SILKWORM_DB_HISTORY_CACHE_H_
+
+#include <cpp-lru-cache/include/lrucache.hpp>
+#include <memory>
+#include <optional>
+#include <silkworm/common/base.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/change.hpp>
+#include <silkworm/db/history_index.hpp>
+#include <string>
+#include <vector>
+
+namespace silkworm::db {
+
+struct HistoryCacheStats {
+    uint64_t index_hits{0};
+    uint64_t index_misses{0};
+    uint64_t change_set_hits{0};
+    uint64_t change_set_misses{0};
+
+    double index_hit_rate() const;
+    double change_set_hit_rate() const;
+};
+
+/** @brief Cache of decoded history index chunks and change sets.
+ *
+ * Serves historical reads (see read_account & read_storage) from memory when they repeatedly hit
+ * the same index chunks and change sets, e.g. when executing consecutive blocks on historical state.
+ * Cached data is copied out of the database, so the cache may outlive the transactions it's used with.
+ * It assumes history doesn't change in the meantime, thus it must be cleared after an unwind.
+ *
+ * Not thread-safe.
+ */
+class HistoryCache {
+  public:
+    explicit HistoryCache(size_t max_index_chunks = 10'000, size_t max_change_sets = 256)
+        : index_chunks_{max_index_chunks}, account_changes_{max_change_sets}, storage_changes_{max_change_sets} {}
+
+    HistoryCache(const HistoryCache&) = delete;
+    HistoryCache& operator=(const HistoryCache&) = delete;
+
+    /** @brief Value of an account (or storage) key at the beginning of the given block, if it's been changed since.
+     * Same as a non-cached lookup in the history index followed by a lookup in the change set.
+     * The returned view is only valid until the next call.
+     */
+    std::optional<ByteView> find(lmdb::Transaction& txn, bool storage, ByteView key, uint64_t block_number);
+
+    const HistoryCacheStats& stats() const { return stats_; }
+
+    void clear();
+
+  private:
+    // Decoded index chunk of a key's history
+    struct IndexChunk {
+        uint64_t from{0};  // Range [from; to] of block numbers for which a DB seek lands on this chunk
+        uint64_t to{0};
+        history_index::Chunk changes{};  // Empty if there's no more history after from
+    };
+
+    // Change set copied out of the database, viewed in place
+    template <class View>
+    struct ChangeSet {
+        explicit ChangeSet(ByteView encoded) : bytes{encoded}, view{bytes} {}
+
+        ChangeSet(const ChangeSet&) = delete;
+        ChangeSet& operator=(const ChangeSet&) = delete;
+
+        const Bytes bytes;
+        const View view;
+    };
+
+    template <class View>
+    using ChangeSetCache = cache::lru_cache<uint64_t, std::shared_ptr<const ChangeSet<View>>>;
+
+    std::optional<history_index::SearchResult> find_change(lmdb::Transaction& txn, bool storage, ByteView key,
+                                                           uint64_t block_number);
+
+    template <class View>
+    const View* find_change_set(lmdb::Transaction& txn, const lmdb::TableConfig& table, ChangeSetCache<View>& cache,
+                                uint64_t block_number);
+
+    // Keys are history keys without the block number suffix
+    cache::lru_cache<std::string, std::shared_ptr<IndexChunk>> index_chunks_;
+
+    // nullptr for missing change sets
+    ChangeSetCache<AccountChangeSetView> account_changes_;
+    ChangeSetCache<StorageChangeSetView> storage_changes_;
+
+    HistoryCacheStats stats_{};
+};
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_HISTORY_CACHE_H_
@@ -0,0 +1,176 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "history_cache.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/account.hpp>
+
+#include "access_layer.hpp"
+#include "history_index_builder.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static Bytes encoded_account(uint64_t nonce) {
+    Account account;
+    account.nonce = nonce;
+    return account.encode_for_storage(/*omit_code_hash=*/false);
+}
+
+static Bytes storage_value(uint64_t v) {
+    Bytes value(2, '\0');
+    boost::endian::store_big_u16(&value[0], static_cast<uint16_t>(v));
+    return value;
+}
+
+TEST_CASE("History cache") {
+    using namespace evmc::literals;
+
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    // Created in block 1 & changed in every block, enough for several index chunks
+    const auto busy{0x0000000000000000000000000000000000000001_address};
+    // Changed every 10 blocks
+    const auto calm{0x0000000000000000000000000000000000000002_address};
+    // Storage changed every 3 blocks, from block 3 on
+    const auto contract{0x0000000000000000000000000000000000000003_address};
+    // Without history
+    const auto idle{0x0000000000000000000000000000000000000004_address};
+    const auto missing{0x0000000000000000000000000000000000000005_address};
+
+    const auto location{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto unchanged_location{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+
+    const uint64_t last_block{1'000};
+    {
+        auto account_changes{txn->open(table::kPlainAccountChangeSet)};
+        auto storage_changes{txn->open(table::kPlainStorageChangeSet)};
+        Bytes encoded;
+        for (uint64_t block_number{1}; block_number <= last_block; ++block_number) {
+            AccountChangeSetBuilder account_builder;
+            account_builder.insert(busy, block_number == 1 ? Bytes{} : encoded_account(block_number - 1));
+            if (block_number % 10 == 0) {
+                account_builder.insert(calm, encoded_account(block_number / 10));
+            }
+            account_builder.encode(encoded);
+            account_changes->put(encode_timestamp(block_number), encoded);
+
+            if (block_number % 3 == 0) {
+                StorageChangeSetBuilder storage_builder;
+                storage_builder.insert(contract, 1, location,
+                                       block_number == 3 ? Bytes{} : storage_value(block_number - 3));
+                storage_builder.encode(encoded);
+                storage_changes->put(encode_timestamp(block_number), encoded);
+            }
+        }
+
+        auto state{txn->open(table::kPlainState)};
+        state->put(full_view(busy), encoded_account(last_block));
+        state->put(full_view(calm), encoded_account(last_block / 10 + 1));
+        state->put(full_view(idle), encoded_account(7));
+        Bytes storage{full_view(location)};
+        storage.append(storage_value(last_block - 1));
+        state->put(storage_prefix(contract, 1), storage);
+        storage = full_view(unchanged_location);
+        storage.append(storage_value(42));
+        state->put(storage_prefix(contract, 1), storage);
+    }
+    build_history_index(*txn, /*storage=*/false, 1, last_block + 1);
+    build_history_index(*txn, /*storage=*/true, 1, last_block + 1);
+
+    SECTION("against uncached lookups") {
+        HistoryCache cache;
+        for (uint64_t block_number{0}; block_number <= last_block + 2; ++block_number) {
+            for (const evmc::address& address : {busy, calm, idle, missing}) {
+                CHECK(read_account(*txn, address, block_number, &cache) == read_account(*txn, address, block_number));
+            }
+            for (const evmc::bytes32& key : {location, unchanged_location}) {
+                CHECK(read_storage(*txn, contract, 1, key, block_number, &cache) ==
+                      read_storage(*txn, contract, 1, key, block_number));
+            }
+        }
+        CHECK(read_account(*txn, busy, 500, &cache)->nonce == 499);
+        CHECK(read_storage(*txn, contract, 1, location, 500, &cache) ==
+              0x00000000000000000000000000000000000000000000000000000000000001f2_bytes32);  // 498
+
+        // Neighbouring blocks reuse the [from; to] block range of an index chunk,
+        // so there's one miss per chunk and one past the history of each key
+        size_t num_of_chunks{0};
+        for (const lmdb::TableConfig& config : {table::kAccountHistory, table::kStorageHistory}) {
+            size_t count{0};
+            lmdb::err_handler(txn->open(config)->get_rcount(&count));
+            num_of_chunks += count;
+        }
+        CHECK(num_of_chunks > 4);
+        CHECK(cache.stats().index_misses <= num_of_chunks + 6);
+        CHECK(cache.stats().index_hit_rate() > 0.99);
+    }
+
+    SECTION("LRU eviction") {
+        HistoryCache cache{/*max_index_chunks=*/2, /*max_change_sets=*/2};
+
+        for (const evmc::address& address : {busy, calm, busy, idle, calm, busy}) {
+            CHECK(read_account(*txn, address, 500, &cache) == read_account(*txn, address, 500));
+        }
+        // idle evicts calm, which then evicts busy
+        CHECK(cache.stats().index_hits == 1);
+        CHECK(cache.stats().index_misses == 5);
+        // Both busy & calm changed in block 500
+        CHECK(cache.stats().change_set_hits == 4);
+        CHECK(cache.stats().change_set_misses == 1);
+
+        for (uint64_t block_number : {400u, 401u, 400u, 402u, 401u, 400u}) {
+            CHECK(read_account(*txn, busy, block_number, &cache) == read_account(*txn, busy, block_number));
+        }
+        // 402 evicts 401 and 401 then evicts 400
+        CHECK(cache.stats().change_set_hits == 4 + 1);
+        CHECK(cache.stats().change_set_misses == 1 + 5);
+    }
+
+    SECTION("keys without history") {
+        HistoryCache cache;
+        const Bytes unchanged_key{storage_key(contract, 1, unchanged_location)};
+        for (uint64_t block_number : {1u, 500u, 2'000u}) {
+            CHECK(!cache.find(*txn, /*storage=*/false, full_view(idle), block_number));
+            CHECK(!cache.find(*txn, /*storage=*/false, full_view(missing), block_number));
+            CHECK(!cache.find(*txn, /*storage=*/true, unchanged_key, block_number));
+        }
+        // Their chunks are empty & open-ended from the first block looked up
+        CHECK(cache.stats().index_misses == 3);
+        CHECK(cache.stats().index_hits == 6);
+        CHECK(cache.stats().change_set_misses == 0);
+
+        CHECK(!cache.find(*txn, /*storage=*/false, full_view(idle), 0));
+        CHECK(cache.stats().index_misses == 4);
+
+        CHECK(read_account(*txn, idle, 500, &cache)->nonce == 7);
+        CHECK(!read_account(*txn, missing, 500, &cache));
+        CHECK(read_storage(*txn, contract, 1, unchanged_location, 500, &cache) ==
+              0x000000000000000000000000000000000000000000000000000000000000002a_bytes32);
+    }
+}
+
+}  // namespace silkworm::db
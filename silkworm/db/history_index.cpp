@@ -19,6 +19,7 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/iterator/counting_iterator.hpp>
 #include <silkworm/common/util.hpp>
+#include <stdexcept>
 
 namespace silkworm::db::history_index {
 
@@ -78,4 +79,86 @@ std::optional<SearchResult> find_previous(ByteView hi, uint64_t v) {
         return search_result(hi, i - 1);
     }
 }
+
+Chunk::Chunk(ByteView hi) {
+    size_t n{number_of_elements(hi)};
+    min_element_ = boost::endian::load_big_u64(hi.data());
+    offsets_.resize(n);
+    new_records_.resize((n + 63) / 64);
+
+    const uint8_t* elements{hi.data() + 8};
+    for (size_t i{0}; i < n; ++i, elements += kItemLen) {
+        offsets_[i] = (static_cast<uint32_t>(elements[0] & 0x7f) << 16) | (elements[1] << 8) | elements[2];
+        new_records_[i / 64] |= static_cast<uint64_t>(elements[0] >> 7) << (i % 64);
+    }
+}
+
+Bytes Chunk::encode() const {
+    Bytes out(8 + offsets_.size() * kItemLen, '\0');
+    boost::endian::store_big_u64(&out[0], min_element_);
+    uint8_t* elements{&out[8]};
+    for (size_t i{0}; i < offsets_.size(); ++i, elements += kItemLen) {
+        uint32_t offset{offsets_[i]};
+        elements[0] = static_cast<uint8_t>(offset >> 16);
+        if ((new_records_[i / 64] >> (i % 64)) & 1) {
+            elements[0] |= 0x80;
+        }
+        elements[1] = static_cast<uint8_t>(offset >> 8);
+        elements[2] = static_cast<uint8_t>(offset);
+    }
+    return out;
+}
+
+void Chunk::push_back(uint64_t v, bool new_record) {
+    if (!fits(v)) {
+        throw std::invalid_argument("element doesn't fit into index chunk");
+    }
+    if (empty()) {
+        min_element_ = v;
+    }
+    size_t i{offsets_.size()};
+    offsets_.push_back(static_cast<uint32_t>(v - min_element_));
+    if (i % 64 == 0) {
+        new_records_.push_back(0);
+    }
+    new_records_[i / 64] |= static_cast<uint64_t>(new_record) << (i % 64);
+}
+
+size_t Chunk::lower_bound(uint64_t v) const noexcept {
+    if (empty() || v <= min_element_) {
+        return 0;
+    }
+    if (v - min_element_ > kMaxElementOffset) {
+        return offsets_.size();
+    }
+
+    // See Khuong & Morin, Array Layouts for Comparison-Based Searching:
+    // the loop compiles to conditional moves and its trip count only depends on the size.
+    const uint32_t x{static_cast<uint32_t>(v - min_element_)};
+    const uint32_t* base{offsets_.data()};
+    size_t n{offsets_.size()};
+    while (n > 1) {
+        size_t half{n / 2};
+        base = base[half] < x ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - offsets_.data()) + (*base < x);
+}
+
+std::optional<SearchResult> Chunk::find(uint64_t v) const noexcept {
+    size_t i{lower_bound(v)};
+    if (i == size()) {
+        return {};
+    }
+    return (*this)[i];
+}
+
+std::optional<SearchResult> Chunk::find_previous(uint64_t v) const noexcept {
+    size_t i{lower_bound(v)};
+    if (i == 0) {
+        return {};
+    }
+    return (*this)[i - 1];
+}
+
 }  // namespace silkworm::db::history_index
@@ -24,6 +24,7 @@ see its common/dbutils/history_index.go.
 
 #include <optional>
 #include <silkworm/common/base.hpp>
+#include <vector>
 
 namespace silkworm::db::history_index {
 
@@ -38,6 +39,59 @@ std::optional<SearchResult> find(ByteView index, uint64_t v);
 
 // Finds the largest element less than v.
 std::optional<SearchResult> find_previous(ByteView index, uint64_t v);
+
+// Maximal difference between an element of a chunk and its minimal element
+constexpr uint64_t kMaxElementOffset{0x7fffff};
+
+// Chunks are split before their encoding would exceed this many bytes.
+// See Turbo-Geth CheckNewIndexChunk
+constexpr size_t kMaxChunkSize{1000};
+
+// Index chunk decoded into an array of element offsets from the minimal element
+// and a bitmap of new record flags.
+// Meant to be decoded once and searched many times.
+class Chunk {
+  public:
+    Chunk() = default;
+
+    // Throws DecodingError
+    explicit Chunk(ByteView encoded);
+
+    // See Turbo-Geth (HistoryIndexBytes)Append
+    Bytes encode() const;
+
+    bool empty() const noexcept { return offsets_.empty(); }
+    size_t size() const noexcept { return offsets_.size(); }
+
+    uint64_t min_element() const noexcept { return min_element_; }
+
+    SearchResult operator[](size_t i) const noexcept {
+        return {min_element_ + offsets_[i], ((new_records_[i / 64] >> (i % 64)) & 1) != 0};
+    }
+
+    // Whether v can be appended to this chunk
+    bool fits(uint64_t v) const noexcept {
+        return empty() || (v >= min_element_ + offsets_.back() && v - min_element_ <= kMaxElementOffset);
+    }
+
+    // Appends an element; throws std::invalid_argument unless it fits
+    void push_back(uint64_t v, bool new_record);
+
+    // Index of the first element equal or greater than v; branchless
+    size_t lower_bound(uint64_t v) const noexcept;
+
+    // Finds the smallest element equal or greater than v.
+    std::optional<SearchResult> find(uint64_t v) const noexcept;
+
+    // Finds the largest element less than v.
+    std::optional<SearchResult> find_previous(uint64_t v) const noexcept;
+
+  private:
+    uint64_t min_element_{0};
+    std::vector<uint32_t> offsets_;
+    std::vector<uint64_t> new_records_;  // bitmap
+};
+
 }  // namespace silkworm::db::history_index
 
 #endif  // SILKWORM_DB_HISTORY_INDEX_H_
@@ -0,0 +1,122 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "history_index_builder.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+
+#include "change.hpp"
+#include "etl.hpp"
+#include "history_index.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static constexpr size_t encoded_chunk_length(size_t num_of_elements) { return 8 + 3 * num_of_elements; }
+
+// Empty values mark records that didn't exist before the change
+static ByteView new_record_flag(ByteView value) {
+    static constexpr uint8_t kFlags[]{0, 1};
+    return {&kFlags[value.empty() ? 1 : 0], 1};
+}
+
+void build_history_index(lmdb::Transaction& txn, bool storage, uint64_t from, uint64_t to, size_t memory_budget) {
+    using boost::endian::load_big_u64;
+    using boost::endian::store_big_u64;
+
+    // Index elements are collected as history key + block number -> new record flag,
+    // so that their key order is the index order
+    const size_t key_length{storage ? kAddressLength + kHashLength : kAddressLength};
+    etl::Collector collector{memory_budget};
+
+    Bytes element_key(key_length + 8, '\0');
+    auto change_table{txn.open(storage ? table::kPlainStorageChangeSet : table::kPlainAccountChangeSet)};
+    for (uint64_t block_number{from}; block_number < to; ++block_number) {
+        std::optional<ByteView> changes{change_table->get(encode_timestamp(block_number))};
+        if (!changes) {
+            continue;
+        }
+        store_big_u64(&element_key[key_length], block_number);
+        if (storage) {
+            for (const StorageChangeSetView::Entry& entry : StorageChangeSetView{*changes}) {
+                std::memcpy(&element_key[0], entry.address.data(), kAddressLength);
+                std::memcpy(&element_key[kAddressLength], entry.location.data(), kHashLength);
+                collector.collect(element_key, new_record_flag(entry.value));
+            }
+        } else {
+            for (const AccountChangeSetView::Entry& entry : AccountChangeSetView{*changes}) {
+                std::memcpy(&element_key[0], entry.address.data(), kAddressLength);
+                collector.collect(element_key, new_record_flag(entry.value));
+            }
+        }
+    }
+    change_table.reset();
+
+    auto index_table{txn.open(storage ? table::kStorageHistory : table::kAccountHistory)};
+
+    // Key of the current chunk: history key + big-endian suffix,
+    // which is the chunk's last element or UINT64_MAX for the last chunk of the key
+    Bytes chunk_key(key_length + 8, '\0');
+    history_index::Chunk chunk{};
+    bool has_key{false};
+
+    auto write_chunk{[&](uint64_t suffix) {
+        store_big_u64(&chunk_key[key_length], suffix);
+        index_table->put(chunk_key, chunk.encode(), index_table->append_flag(chunk_key));
+        chunk = {};
+    }};
+
+    collector.load([&](ByteView element_key, ByteView flag) {
+        ByteView key{element_key.substr(0, key_length)};
+        uint64_t block_number{load_big_u64(&element_key[key_length])};
+        bool new_record{flag[0] != 0};
+
+        if (!has_key || key != ByteView{chunk_key}.substr(0, key_length)) {
+            if (has_key) {
+                write_chunk(UINT64_MAX);
+            }
+            has_key = true;
+            std::memcpy(&chunk_key[0], key.data(), key_length);
+
+            // Extend the last chunk of the key, if it's already indexed
+            store_big_u64(&chunk_key[key_length], UINT64_MAX);
+            if (std::optional<ByteView> last_chunk{index_table->get(chunk_key)}; last_chunk) {
+                chunk = history_index::Chunk{*last_chunk};
+                index_table->del(chunk_key);
+            }
+        }
+
+        if (!chunk.empty()) {
+            uint64_t last_block{chunk[chunk.size() - 1].change_block};
+            if (block_number <= last_block) {
+                return;  // already indexed
+            }
+            if (!chunk.fits(block_number) ||
+                encoded_chunk_length(chunk.size() + 1) > history_index::kMaxChunkSize) {
+                write_chunk(last_block);
+            }
+        }
+        chunk.push_back(block_number, new_record);
+    });
+
+    if (has_key) {
+        write_chunk(UINT64_MAX);
+    }
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,43 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_HISTORY_INDEX_BUILDER_H_
+#define SILKWORM_DB_HISTORY_INDEX_BUILDER_H_
+
+/*
+Part of the compatibility layer with the Turbo-Geth DB format;
+see its eth/stagedsync/stage_indexes.go.
+*/
+
+#include <silkworm/db/chaindb.hpp>
+
+namespace silkworm::db {
+
+/** @brief Indexes the plain account (or storage) change sets of blocks [from; to)
+ * into kAccountHistory (or kStorageHistory).
+ *
+ * Index elements are collected from the change sets and sorted externally with an etl::Collector
+ * within memory_budget.
+ * The merged elements are then written key by key in ascending order; the last chunk of a key
+ * already in the index is extended, and chunks past the end of the table are written with MDB_APPEND.
+ * Blocks already in the index are skipped, so the index may be extended from its current progress.
+ */
+void build_history_index(lmdb::Transaction& txn, bool storage, uint64_t from, uint64_t to,
+                         size_t memory_budget = 256 << 20);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_HISTORY_INDEX_BUILDER_H_
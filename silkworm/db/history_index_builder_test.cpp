@@ -0,0 +1,169 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "history_index_builder.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <map>
+#include <random>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/change.hpp>
+#include <silkworm/db/history_index.hpp>
+#include <silkworm/db/tables.hpp>
+#include <silkworm/db/util.hpp>
+#include <utility>
+#include <vector>
+
+namespace silkworm::db {
+
+using Changes = std::vector<std::pair<uint64_t, bool>>;  // change_block & new_record
+
+static std::map<Bytes, Bytes> read_table(lmdb::Transaction& txn, const lmdb::TableConfig& config) {
+    std::map<Bytes, Bytes> entries;
+    auto table{txn.open(config)};
+    MDB_val key, data;
+    for (int rc{table->get_first(&key, &data)}; rc == MDB_SUCCESS; rc = table->get_next(&key, &data)) {
+        entries.emplace(from_mdb_val(key), from_mdb_val(data));
+    }
+    return entries;
+}
+
+// Concatenates the chunks of key, checking their suffixes along the way
+static Changes read_index(const std::map<Bytes, Bytes>& index, const Bytes& key) {
+    Changes changes;
+    uint64_t previous_suffix{0};
+    for (auto it{index.lower_bound(key)}; it != index.end() && has_prefix(it->first, key); ++it) {
+        REQUIRE(it->first.length() == key.length() + 8);
+        CHECK(it->second.length() <= history_index::kMaxChunkSize);
+
+        uint64_t suffix{boost::endian::load_big_u64(&it->first[key.length()])};
+        CHECK(suffix > previous_suffix);
+        previous_suffix = suffix;
+
+        history_index::Chunk chunk{it->second};
+        REQUIRE(chunk.size() > 0);
+        CHECK(chunk[chunk.size() - 1].change_block - chunk[0].change_block <= history_index::kMaxElementOffset);
+        if (suffix != UINT64_MAX) {
+            CHECK(suffix == chunk[chunk.size() - 1].change_block);
+        }
+        for (size_t i{0}; i < chunk.size(); ++i) {
+            changes.emplace_back(chunk[i].change_block, chunk[i].new_record);
+        }
+    }
+    CHECK(previous_suffix == UINT64_MAX);
+    return changes;
+}
+
+TEST_CASE("Build history index") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    std::vector<evmc::address> addresses(40);
+    for (size_t i{0}; i < addresses.size(); ++i) {
+        addresses[i].bytes[0] = static_cast<uint8_t>(i * 5 + 1);
+    }
+
+    // Expected index contents, keyed by address (and location, without incarnation)
+    std::map<Bytes, Changes> account_index;
+    std::map<Bytes, Changes> storage_index;
+
+    auto account_changes{txn->open(table::kPlainAccountChangeSet)};
+    auto storage_changes{txn->open(table::kPlainStorageChangeSet)};
+    Bytes encoded;
+
+    // addresses[0] changes in every block, enough for several chunks of kMaxChunkSize
+    std::mt19937_64 rng{33};
+    constexpr uint64_t kNumOfBlocks{1'200};
+    for (uint64_t block_number{1}; block_number < kNumOfBlocks; ++block_number) {
+        AccountChangeSetBuilder account_builder;
+        StorageChangeSetBuilder storage_builder;
+        for (size_t i{0}; i < addresses.size(); ++i) {
+            if (i == 0 || rng() % 7 == 0) {
+                bool was_empty{rng() % 5 == 0};
+                account_builder.insert(addresses[i], was_empty ? Bytes{} : from_hex("0102"));
+                account_index[Bytes{full_view(addresses[i])}].emplace_back(block_number, was_empty);
+            }
+            if (i < 10 && rng() % 3 == 0) {
+                evmc::bytes32 location{};
+                location.bytes[31] = static_cast<uint8_t>(rng() % 4);
+                uint64_t incarnation{1 + rng() % 2};
+                bool was_empty{rng() % 4 == 0};
+                storage_builder.insert(addresses[i], incarnation, location, was_empty ? Bytes{} : from_hex("05"));
+
+                Bytes key{full_view(addresses[i])};
+                key.append(full_view(location));
+                Changes& changes{storage_index[key]};
+                if (changes.empty() || changes.back().first != block_number) {
+                    changes.emplace_back(block_number, was_empty);
+                }
+            }
+        }
+        if (!account_builder.empty()) {
+            account_builder.encode(encoded);
+            account_changes->put(encode_timestamp(block_number), encoded);
+        }
+        if (!storage_builder.empty()) {
+            storage_builder.encode(encoded);
+            storage_changes->put(encode_timestamp(block_number), encoded);
+        }
+    }
+
+    // Changes of addresses[1] further apart than kMaxElementOffset go into separate chunks
+    for (uint64_t block_number : {kNumOfBlocks + 1, kNumOfBlocks + 2 + history_index::kMaxElementOffset}) {
+        AccountChangeSetBuilder account_builder;
+        account_builder.insert(addresses[1], from_hex("0102"));
+        account_builder.encode(encoded);
+        account_changes->put(encode_timestamp(block_number), encoded);
+        account_index[Bytes{full_view(addresses[1])}].emplace_back(block_number, false);
+    }
+    const uint64_t to{kNumOfBlocks + 3 + history_index::kMaxElementOffset};
+
+    for (bool storage : {false, true}) {
+        const lmdb::TableConfig& index_table{storage ? table::kStorageHistory : table::kAccountHistory};
+        const std::map<Bytes, Changes>& expected{storage ? storage_index : account_index};
+
+        // In one go
+        build_history_index(*txn, storage, 1, to);
+        std::map<Bytes, Bytes> index{read_table(*txn, index_table)};
+        for (const auto& [key, changes] : expected) {
+            CHECK(read_index(index, key) == changes);
+        }
+        // Only expected keys, e.g. no incarnations
+        for (const auto& [key, chunk] : index) {
+            CHECK(expected.count(key.substr(0, key.length() - 8)) == 1);
+        }
+        if (!storage) {
+            CHECK(index.size() > expected.size() + 1);
+        }
+
+        // Incrementally with the UINT64_MAX chunks extended, over partly indexed ranges,
+        // and with a memory budget small enough to spill sorted runs into files
+        txn->open(index_table)->clear();
+        build_history_index(*txn, storage, 1, 400, /*memory_budget=*/1'000);
+        build_history_index(*txn, storage, 400, 900, /*memory_budget=*/1'000);
+        build_history_index(*txn, storage, 700, kNumOfBlocks, /*memory_budget=*/1'000);
+        build_history_index(*txn, storage, 1, to, /*memory_budget=*/1'000);
+        CHECK(read_table(*txn, index_table) == index);
+    }
+}
+
+}  // namespace silkworm::db
@@ -40,4 +40,68 @@ TEST_CASE("History index search") {
     CHECK(find_previous(index, 8)->change_block == 5);
     CHECK(find_previous(index, 9)->change_block == 8);
 }
+
+TEST_CASE("Decoded history index chunk") {
+    Bytes index{from_hex("0000000000000003000000800002000005")};
+
+    Chunk chunk{index};
+    REQUIRE(chunk.size() == 3);
+    CHECK(chunk.min_element() == 3);
+    CHECK(chunk[0].change_block == 3);
+    CHECK(!chunk[0].new_record);
+    CHECK(chunk[1].change_block == 5);
+    CHECK(chunk[1].new_record);
+    CHECK(chunk[2].change_block == 8);
+    CHECK(!chunk[2].new_record);
+    CHECK(to_hex(chunk.encode()) == to_hex(index));
+
+    for (uint64_t v{0}; v < 12; ++v) {
+        std::optional<SearchResult> expected{find(index, v)};
+        std::optional<SearchResult> actual{chunk.find(v)};
+        REQUIRE(actual.has_value() == expected.has_value());
+        if (expected) {
+            CHECK(actual->change_block == expected->change_block);
+            CHECK(actual->new_record == expected->new_record);
+        }
+
+        expected = find_previous(index, v);
+        actual = chunk.find_previous(v);
+        REQUIRE(actual.has_value() == expected.has_value());
+        if (expected) {
+            CHECK(actual->change_block == expected->change_block);
+        }
+    }
+
+    CHECK(Chunk{from_hex("0000000000000003")}.empty());
+    CHECK(!Chunk{}.find(0));
+    CHECK_THROWS_AS(Chunk{from_hex("000000000000000300")}, DecodingError);
+    CHECK_THROWS_AS(Chunk{from_hex("00000003")}, DecodingError);
+    CHECK_THROWS_AS(Chunk{ByteView{}}, DecodingError);
+}
+
+TEST_CASE("Building history index chunk") {
+    Chunk chunk;
+    for (uint64_t i{0}; i < 200; ++i) {
+        chunk.push_back(1'000'000 + 7 * i, i % 3 == 0);
+    }
+    CHECK(!chunk.fits(1'000'000 + 7 * 198));
+    CHECK(!chunk.fits(1'000'000 + kMaxElementOffset + 1));
+    CHECK(chunk.fits(1'000'000 + kMaxElementOffset));
+    CHECK_THROWS_AS(chunk.push_back(999'999, false), std::invalid_argument);
+
+    Chunk decoded{chunk.encode()};
+    REQUIRE(decoded.size() == 200);
+    for (uint64_t i{0}; i < 200; ++i) {
+        CHECK(decoded[i].change_block == 1'000'000 + 7 * i);
+        CHECK(decoded[i].new_record == (i % 3 == 0));
+    }
+
+    CHECK(decoded.lower_bound(0) == 0);
+    CHECK(decoded.lower_bound(1'000'000) == 0);
+    CHECK(decoded.lower_bound(1'000'001) == 1);
+    CHECK(decoded.lower_bound(1'000'007) == 1);
+    CHECK(decoded.lower_bound(1'000'000 + 7 * 199) == 199);
+    CHECK(decoded.lower_bound(1'000'000 + 7 * 199 + 1) == 200);
+    CHECK(decoded.lower_bound(UINT64_MAX) == 200);
+}
 }  // namespace silkworm::db::history_index
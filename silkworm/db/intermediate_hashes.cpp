@@ -0,0 +1,588 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "intermediate_hashes.hpp"
+
+#include <absl/container/btree_map.h>
+#include <absl/container/btree_set.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/endian/conversion.hpp>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/trie/hash_builder.hpp>
+#include <thread>
+#include <vector>
+
+#include "access_layer.hpp"
+#include "change.hpp"
+#include "etl.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static Bytes unpack_nibbles(ByteView packed) {
+    Bytes out(2 * packed.length(), '\0');
+    for (size_t i{0}; i < packed.length(); ++i) {
+        out[2 * i] = packed[i] >> 4;
+        out[2 * i + 1] = packed[i] & 0xF;
+    }
+    return out;
+}
+
+// An odd path is padded with 0, so that the packed path precedes all the keys under it
+static Bytes pack_nibbles(ByteView nibbles) {
+    Bytes out((nibbles.length() + 1) / 2, '\0');
+    for (size_t i{0}; i < nibbles.length(); ++i) {
+        out[i / 2] |= i % 2 ? nibbles[i] : nibbles[i] << 4;
+    }
+    return out;
+}
+
+// Whether the key comes before the path and isn't under it
+static bool precedes(ByteView packed_key, ByteView path) {
+    for (size_t i{0}; i < path.length(); ++i) {
+        uint8_t byte{packed_key[i / 2]};
+        uint8_t nibble{static_cast<uint8_t>(i % 2 ? byte & 0xF : byte >> 4)};
+        if (nibble != path[i]) {
+            return nibble < path[i];
+        }
+    }
+    return false;
+}
+
+// Moves the path past all the paths under it; false if there are none past it
+static bool increment(Bytes& path) {
+    while (!path.empty() && path.back() == 0xF) {
+        path.pop_back();
+    }
+    if (path.empty()) {
+        return false;
+    }
+    ++path.back();
+    return true;
+}
+
+static evmc::bytes32 to_bytes32(const ethash::hash256& hash) {
+    evmc::bytes32 res;
+    std::memcpy(res.bytes, hash.bytes, kHashLength);
+    return res;
+}
+
+static Bytes hashed_storage_prefix(ByteView address, ByteView encoded_incarnation) {
+    Bytes prefix(full_view(keccak256(address).bytes));
+    prefix.append(encoded_incarnation);
+    return prefix;
+}
+
+namespace {
+
+    using ChangedKeys = absl::btree_set<evmc::bytes32>;
+
+    // Hashed storage prefix -> hashed locations
+    using ChangedStorage = absl::btree_map<Bytes, ChangedKeys>;
+
+    constexpr uint8_t kAccountTrieOwner[kHashLength + kIncarnationLength]{};
+
+    // Account leaves of kCurrentState in key order; storage entries are skipped
+    class AccountLeaves {
+      public:
+        explicit AccountLeaves(lmdb::Table& table) : table_{table} {}
+
+        // Positions at the first account with key >= packed_key
+        bool seek(ByteView packed_key) {
+            MDB_val key{to_mdb_val(packed_key)}, value;
+            return settle(packed_key.empty() ? table_.get_first(&key, &value) : table_.seek(&key, &value));
+        }
+
+        bool next() { return settle(table_.get_next_nodup(&key_, &value_)); }
+
+        ByteView key() const { return from_mdb_val(key_); }
+        ByteView value() const { return from_mdb_val(value_); }
+
+      private:
+        bool settle(int rc) {
+            if (rc == MDB_SUCCESS) {
+                rc = table_.get_current(&key_, &value_);
+            }
+            while (rc != MDB_NOTFOUND) {
+                lmdb::err_handler(rc);
+                if (key_.mv_size == kHashLength) {
+                    return true;
+                }
+                rc = table_.get_next_nodup(&key_, &value_);
+            }
+            return false;
+        }
+
+        lmdb::Table& table_;
+        MDB_val key_{}, value_{};
+    };
+
+    // Storage leaves of an account in kCurrentState in key order
+    class StorageLeaves {
+      public:
+        StorageLeaves(lmdb::Table& table, ByteView storage_prefix) : table_{table}, storage_prefix_{storage_prefix} {}
+
+        // Positions at the first location with hash >= packed_key
+        bool seek(ByteView packed_key) {
+            MDB_val key{to_mdb_val(storage_prefix_)};
+            value_ = to_mdb_val(packed_key);
+            return settle(table_.seek_dup(&key, &value_));
+        }
+
+        bool next() {
+            MDB_val key;
+            return settle(table_.get_next_dup(&key, &value_));
+        }
+
+        ByteView key() const { return from_mdb_val(value_).substr(0, kHashLength); }
+        ByteView value() const { return from_mdb_val(value_).substr(kHashLength); }
+
+      private:
+        bool settle(int rc) {
+            if (rc == MDB_NOTFOUND) {
+                return false;
+            }
+            lmdb::err_handler(rc);
+            return true;
+        }
+
+        lmdb::Table& table_;
+        ByteView storage_prefix_;
+        MDB_val value_{};
+    };
+
+}  // namespace
+
+// Drops the stored hashes of branch nodes on the paths of the changed keys
+static void invalidate(lmdb::Table& ih_table, ByteView owner, const ChangedKeys& changed_keys) {
+    Bytes prev_path{};
+    Bytes prefix{owner};
+    for (const evmc::bytes32& key : changed_keys) {
+        Bytes path{unpack_nibbles(full_view(key))};
+        // Shorter paths were dealt with along with the previous key
+        for (size_t len{prefix_length(path, prev_path) + 1}; len < path.length(); ++len) {
+            prefix.resize(owner.length());
+            prefix.append(path, 0, len);
+            std::optional<Entry> entry{ih_table.seek(prefix)};
+            if (!entry || !has_prefix(entry->key, prefix)) {
+                break;  // nothing stored down the path
+            }
+            if (entry->key.length() == prefix.length()) {
+                lmdb::err_handler(ih_table.del_current());
+            }
+        }
+        prev_path = std::move(path);
+    }
+}
+
+namespace {
+
+    // Computes trie roots from the hashed state, using the stored hashes of unchanged subtries
+    class RootCalculator {
+      public:
+        RootCalculator(lmdb::Transaction& txn, const ChangedStorage& changed_storage, bool regenerate,
+                       size_t memory_budget)
+            : hashed_table_{txn.open(table::kCurrentState)},
+              storage_table_{txn.open(table::kCurrentState)},
+              ih_table_{txn.open(table::kIntermediateTrieHash, MDB_CREATE)},
+              changed_storage_{changed_storage},
+              regenerate_{regenerate},
+              collector_{memory_budget} {}
+
+        evmc::bytes32 account_root() {
+            AccountLeaves leaves{*hashed_table_};
+            Bytes rlp{};
+            return root(full_view(kAccountTrieOwner), leaves, [&](ByteView address_hash, ByteView encoded) {
+                Account account{decode_account_from_storage(encoded)};
+                if (account.incarnation > 0) {
+                    Bytes prefix{address_hash};
+                    prefix.resize(kHashLength + kIncarnationLength);
+                    boost::endian::store_big_u64(&prefix[kHashLength], account.incarnation);
+                    account.storage_root = storage_root(prefix);
+                }
+                rlp.clear();
+                rlp::encode(rlp, account);
+                return ByteView{rlp};
+            });
+        }
+
+        // Writes the collected branch hashes into kIntermediateTrieHash
+        void write() { collector_.load(*ih_table_); }
+
+      private:
+        evmc::bytes32 storage_root(ByteView prefix) {
+            if (!regenerate_ && changed_storage_.count(Bytes{prefix}) == 0) {
+                std::optional<ByteView> stored{ih_table_->get(prefix)};
+                if (!stored) {
+                    return kEmptyRoot;
+                }
+                assert(stored->length() == kHashLength);
+                evmc::bytes32 hash;
+                std::memcpy(hash.bytes, stored->data(), kHashLength);
+                return hash;
+            }
+
+            StorageLeaves leaves{*storage_table_, prefix};
+            Bytes rlp{};
+            evmc::bytes32 hash{root(prefix, leaves, [&rlp](ByteView, ByteView value) {
+                rlp.clear();
+                rlp::encode(rlp, value);
+                return ByteView{rlp};
+            })};
+            if (hash != kEmptyRoot) {
+                collector_.collect(prefix, full_view(hash));
+            }
+            return hash;
+        }
+
+        /* Feeds the hash builder with the stored branch nodes of the owner's trie in path order
+         * and, between them, with the leaves they don't cover.
+         * The IH cursor is sought anew for every node, as the leaf callback may move it.
+         */
+        template <class Leaves, class LeafRlp>
+        evmc::bytes32 root(ByteView owner, Leaves& leaves, LeafRlp leaf_rlp) {
+            trie::HashBuilder hb;
+            const Bytes owner_copy{owner};
+            hb.node_collector = [this, &owner_copy](ByteView path, const evmc::bytes32& hash) {
+                if (!path.empty()) {
+                    collector_.collect(owner_copy + Bytes{path}, full_view(hash));
+                }
+            };
+
+            Bytes path{};  // everything before it has been added
+            auto add_leaves{[&](std::optional<ByteView> end) {
+                for (bool found{leaves.seek(pack_nibbles(path))}; found; found = leaves.next()) {
+                    if (end && !precedes(leaves.key(), *end)) {
+                        break;
+                    }
+                    Bytes key{leaves.key()};
+                    hb.add(key, leaf_rlp(key, leaves.value()));
+                }
+            }};
+
+            Bytes ih_key{owner};
+            while (true) {
+                ih_key.resize(owner.length());
+                ih_key.append(path);
+                std::optional<Entry> node{ih_table_->seek(ih_key)};
+                if (node && node->key.length() == owner.length() && has_prefix(node->key, owner)) {
+                    // The stored root of a storage trie
+                    MDB_val key, value;
+                    int rc{ih_table_->get_next(&key, &value)};
+                    if (rc == MDB_NOTFOUND) {
+                        node.reset();
+                    } else {
+                        lmdb::err_handler(rc);
+                        node = Entry{from_mdb_val(key), from_mdb_val(value)};
+                    }
+                }
+                if (!node || !has_prefix(node->key, owner)) {
+                    add_leaves(std::nullopt);
+                    break;
+                }
+
+                Bytes node_path{node->key.substr(owner.length())};
+                assert(node->value.length() == kHashLength);
+                evmc::bytes32 node_hash;
+                std::memcpy(node_hash.bytes, node->value.data(), kHashLength);
+
+                add_leaves(node_path);
+                hb.add_branch_node(node_path, node_hash);
+
+                path = std::move(node_path);
+                if (!increment(path)) {
+                    break;
+                }
+            }
+
+            return hb.root_hash();
+        }
+
+        std::unique_ptr<lmdb::Table> hashed_table_;   // for account leaves
+        std::unique_ptr<lmdb::Table> storage_table_;  // for storage leaves
+        std::unique_ptr<lmdb::Table> ih_table_;
+        const ChangedStorage& changed_storage_;
+        bool regenerate_;
+        etl::Collector collector_;
+    };
+
+}  // namespace
+
+evmc::bytes32 regenerate_intermediate_hashes(lmdb::Transaction& txn, size_t memory_budget) {
+    etl::Collector collector{memory_budget};
+
+    auto plain_table{txn.open(table::kPlainState)};
+    MDB_val key, value;
+    for (int rc{plain_table->get_first(&key, &value)}; rc != MDB_NOTFOUND; rc = plain_table->get_next(&key, &value)) {
+        lmdb::err_handler(rc);
+        ByteView k{from_mdb_val(key)};
+        ByteView v{from_mdb_val(value)};
+        if (k.length() == kAddressLength) {
+            evmc::address address;
+            std::memcpy(address.bytes, k.data(), kAddressLength);
+            if (std::optional<Account> account{decode_account(txn, address, v)}; account) {
+                collector.collect(full_view(keccak256(k).bytes), account->encode_for_storage(/*omit_code_hash=*/false));
+            }
+        } else if (k.length() == kStoragePrefixLength) {
+            Bytes location_value(full_view(keccak256(v.substr(0, kHashLength)).bytes));
+            location_value.append(v.substr(kHashLength));
+            collector.collect(hashed_storage_prefix(k.substr(0, kAddressLength), k.substr(kAddressLength)),
+                              location_value);
+        }
+    }
+    plain_table.reset();
+
+    // Clearing invalidates the cursor, hence the table is opened again
+    lmdb::err_handler(txn.open(table::kCurrentState, MDB_CREATE)->clear());
+    collector.load(*txn.open(table::kCurrentState));
+
+    lmdb::err_handler(txn.open(table::kIntermediateTrieHash, MDB_CREATE)->clear());
+
+    const ChangedStorage all_storage{};  // unused, as all the storage is rehashed
+    RootCalculator calculator{txn, all_storage, /*regenerate=*/true, memory_budget};
+    evmc::bytes32 root{calculator.account_root()};
+    calculator.write();
+    return root;
+}
+
+// Copies the changed state from kPlainState into kCurrentState
+static void hash_state(lmdb::Transaction& txn, uint64_t from, uint64_t to, ChangedKeys& changed_accounts,
+                       ChangedStorage& changed_storage) {
+    absl::btree_set<evmc::address> addresses;
+    absl::btree_set<Bytes> storage_keys;  // address + incarnation + location
+
+    auto account_changes{txn.open(table::kPlainAccountChangeSet)};
+    auto storage_changes{txn.open(table::kPlainStorageChangeSet)};
+    for (uint64_t block_number{from}; block_number <= to; ++block_number) {
+        Bytes block_key{encode_timestamp(block_number)};
+        if (std::optional<ByteView> changes{account_changes->get(block_key)}; changes) {
+            for (const AccountChangeSetView::Entry& entry : AccountChangeSetView{*changes}) {
+                evmc::address address;
+                std::memcpy(address.bytes, entry.address.data(), kAddressLength);
+                addresses.insert(address);
+            }
+        }
+        if (std::optional<ByteView> changes{storage_changes->get(block_key)}; changes) {
+            for (const StorageChangeSetView::Entry& entry : StorageChangeSetView{*changes}) {
+                Bytes key(kStoragePrefixLength, '\0');
+                std::memcpy(&key[0], entry.address.data(), kAddressLength);
+                boost::endian::store_big_u64(&key[kAddressLength], entry.incarnation);
+                key.append(entry.location);
+                storage_keys.insert(key);
+            }
+        }
+    }
+    account_changes.reset();
+    storage_changes.reset();
+
+    auto plain_table{txn.open(table::kPlainState)};
+    auto hashed_table{txn.open(table::kCurrentState, MDB_CREATE)};
+
+    for (const evmc::address& address : addresses) {
+        std::optional<Account> account{};
+        if (std::optional<ByteView> encoded{plain_table->get(full_view(address))}; encoded) {
+            account = decode_account(txn, address, *encoded);
+        }
+
+        ethash::hash256 address_hash{keccak256(full_view(address))};
+        hashed_table->del(full_view(address_hash.bytes));
+        if (account) {
+            hashed_table->put(full_view(address_hash.bytes), account->encode_for_storage(/*omit_code_hash=*/false));
+        }
+        changed_accounts.insert(to_bytes32(address_hash));
+    }
+
+    for (const Bytes& key : storage_keys) {
+        ByteView plain_prefix{ByteView{key}.substr(0, kStoragePrefixLength)};
+        ByteView location{ByteView{key}.substr(kStoragePrefixLength)};
+        std::optional<ByteView> value{plain_table->get(plain_prefix, location)};
+
+        ByteView address{plain_prefix.substr(0, kAddressLength)};
+        Bytes prefix{hashed_storage_prefix(address, plain_prefix.substr(kAddressLength))};
+        ethash::hash256 location_hash{keccak256(location)};
+        hashed_table->del(prefix, full_view(location_hash.bytes));
+        if (value && !value->empty()) {
+            Bytes data{full_view(location_hash.bytes)};
+            data.append(*value);
+            hashed_table->put(prefix, data);
+        }
+
+        evmc::bytes32 address_hash;
+        std::memcpy(address_hash.bytes, prefix.data(), kHashLength);
+        changed_accounts.insert(address_hash);
+        changed_storage[prefix].insert(to_bytes32(location_hash));
+    }
+}
+
+evmc::bytes32 increment_intermediate_hashes(lmdb::Transaction& txn, uint64_t from, uint64_t to) {
+    ChangedKeys changed_accounts;
+    ChangedStorage changed_storage;
+    hash_state(txn, from, to, changed_accounts, changed_storage);
+
+    {
+        auto ih_table{txn.open(table::kIntermediateTrieHash, MDB_CREATE)};
+        invalidate(*ih_table, full_view(kAccountTrieOwner), changed_accounts);
+        for (const auto& [prefix, locations] : changed_storage) {
+            invalidate(*ih_table, prefix, locations);
+            ih_table->del(prefix);  // the storage root
+        }
+    }
+
+    RootCalculator calculator{txn, changed_storage, /*regenerate=*/false, /*memory_budget=*/256 << 20};
+    evmc::bytes32 root{calculator.account_root()};
+    calculator.write();
+    return root;
+}
+
+namespace {
+
+    // Subtrie of the account trie under a first byte of hashed addresses
+    struct Subtrie {
+        uint8_t first_byte{0};
+        size_t depth{0};  // in nibbles: the part of the keys above the subtrie root
+        evmc::bytes32 hash{};
+    };
+
+}  // namespace
+
+static evmc::bytes32 storage_root(lmdb::Table& table, ByteView prefix) {
+    StorageLeaves leaves{table, prefix};
+    trie::HashBuilder hb;
+    Bytes rlp{};
+    for (bool found{leaves.seek({})}; found; found = leaves.next()) {
+        rlp.clear();
+        rlp::encode(rlp, leaves.value());
+        hb.add(leaves.key(), rlp);
+    }
+    return hb.root_hash();
+}
+
+static evmc::bytes32 subtrie_hash(lmdb::Transaction& txn, const Subtrie& subtrie) {
+    auto account_table{txn.open(table::kCurrentState)};
+    auto storage_table{txn.open(table::kCurrentState)};
+    AccountLeaves accounts{*account_table};
+
+    trie::HashBuilder hb;
+    Bytes prefix{}, rlp{};
+    for (bool found{accounts.seek({&subtrie.first_byte, 1})}; found && accounts.key()[0] == subtrie.first_byte;
+         found = accounts.next()) {
+        Account account{decode_account_from_storage(accounts.value())};
+        if (account.incarnation > 0) {
+            prefix.assign(accounts.key());
+            prefix.resize(kHashLength + kIncarnationLength);
+            boost::endian::store_big_u64(&prefix[kHashLength], account.incarnation);
+            account.storage_root = storage_root(*storage_table, prefix);
+        }
+        rlp.clear();
+        rlp::encode(rlp, account);
+        hb.add_leaf(ByteView{unpack_nibbles(accounts.key())}.substr(subtrie.depth), rlp);
+    }
+
+    // With 32-byte keys the RLP of a node this high up is never short enough to be embedded,
+    // so the root hash is the reference to it from its parent
+    return hb.root_hash();
+}
+
+evmc::bytes32 calculate_state_root(lmdb::Environment& env, ThreadPool& pool) {
+    std::vector<Subtrie> subtries;
+    {
+        auto txn{env.begin_ro_transaction()};
+        auto table{txn->open(table::kCurrentState)};
+        AccountLeaves accounts{*table};
+        for (bool found{accounts.seek({})}; found;) {
+            const uint8_t first_byte{accounts.key()[0]};
+            subtries.push_back({first_byte});
+            if (first_byte == 0xFF) {
+                break;
+            }
+            const auto next_byte{static_cast<uint8_t>(first_byte + 1)};
+            found = accounts.seek({&next_byte, 1});
+        }
+    }
+
+    if (subtries.empty()) {
+        return kEmptyRoot;
+    }
+
+    // A subtrie root must be the child of a branch node, so that it can be joined by its hash.
+    // That's the branch at the first nibble if there are several subtries under it, or else the trie root.
+    // A single subtrie is the whole trie.
+    std::array<size_t, 16> subtries_per_nibble{};
+    for (const Subtrie& subtrie : subtries) {
+        ++subtries_per_nibble[subtrie.first_byte >> 4];
+    }
+    const auto nibbles_in_use{std::count_if(subtries_per_nibble.begin(), subtries_per_nibble.end(),
+                                            [](size_t n) { return n > 0; })};
+    for (Subtrie& subtrie : subtries) {
+        if (subtries.size() == 1) {
+            subtrie.depth = 0;
+        } else if (subtries_per_nibble[subtrie.first_byte >> 4] > 1 || nibbles_in_use == 1) {
+            subtrie.depth = 2;
+        } else {
+            subtrie.depth = 1;
+        }
+    }
+
+    std::atomic<size_t> pending{subtries.size()};
+    std::mutex error_mutex;
+    std::exception_ptr error{nullptr};
+    for (Subtrie& subtrie : subtries) {
+        Subtrie* task_subtrie{&subtrie};
+        pool.push([&env, &pending, &error_mutex, &error, task_subtrie] {
+            try {
+                auto txn{env.begin_ro_transaction()};
+                task_subtrie->hash = subtrie_hash(*txn, *task_subtrie);
+            } catch (...) {
+                std::lock_guard lock{error_mutex};
+                error = std::current_exception();
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!pool.try_run_one()) {
+            std::this_thread::yield();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    if (subtries.size() == 1) {
+        return subtries[0].hash;
+    }
+
+    // Subtrie roots are added as branch nodes even when they are leaves or extensions.
+    // That's fine since their parents are branches, so no extension is built right above them.
+    trie::HashBuilder hb;
+    for (const Subtrie& subtrie : subtries) {
+        const uint8_t path[2]{static_cast<uint8_t>(subtrie.first_byte >> 4),
+                              static_cast<uint8_t>(subtrie.first_byte & 0xF)};
+        hb.add_branch_node({path, subtrie.depth}, subtrie.hash);
+    }
+    return hb.root_hash();
+}
+
+}  // namespace silkworm::db
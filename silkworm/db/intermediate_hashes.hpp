@@ -0,0 +1,73 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_INTERMEDIATE_HASHES_H_
+#define SILKWORM_DB_INTERMEDIATE_HASHES_H_
+
+/*
+State root computation over the hashed state (kCurrentState),
+with the hashes of trie branch nodes kept in kIntermediateTrieHash between runs;
+see Turbo-Geth eth/stagedsync/stage_hashstate.go & stage_interhashes.go.
+
+kCurrentState holds accounts under keccak(address) and storage under keccak(address) + incarnation,
+with DUPSORT values keccak(location) + zeroless value.
+
+kIntermediateTrieHash maps owner + path to the hash of the branch node at that path,
+the path being in unpacked nibbles. The owner of a storage trie is keccak(address) + incarnation,
+under which the root of the trie is kept too (with an empty path).
+The account trie is owned by 40 zero bytes, which no storage trie can have as incarnations start from 1.
+*/
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/thread_pool.hpp>
+#include <silkworm/db/chaindb.hpp>
+
+namespace silkworm::db {
+
+/** @brief Rebuilds kCurrentState from kPlainState and kIntermediateTrieHash from scratch.
+ *
+ * The hashed state is sorted externally with an etl::Collector within memory_budget, as are the branch node hashes.
+ *
+ * @return The state root.
+ */
+evmc::bytes32 regenerate_intermediate_hashes(lmdb::Transaction& txn, size_t memory_budget = 256 << 20);
+
+/** @brief Applies the state changes of blocks [from; to] to kCurrentState and kIntermediateTrieHash.
+ *
+ * Keys changed are taken from the plain change sets and their current values from kPlainState.
+ * Stored branch hashes on the paths of changed keys are dropped; every other stored hash stands for its whole
+ * subtrie, so only the changed paths are rehashed.
+ * The tables must be consistent with the state before block from, e.g. after regenerate_intermediate_hashes.
+ *
+ * @return The state root after block to.
+ */
+evmc::bytes32 increment_intermediate_hashes(lmdb::Transaction& txn, uint64_t from, uint64_t to);
+
+/** @brief Computes the state root from kCurrentState alone, in parallel.
+ *
+ * The account trie is split into 256 subtries by the first byte of the hashed address. Those are hashed concurrently
+ * on the pool, each task reading through its own readonly transaction, and then joined into the top branch nodes.
+ * kIntermediateTrieHash is neither used nor updated, so the result can verify it.
+ * The hashed state must be committed and must not change meanwhile, as the tasks read separate snapshots.
+ * Tasks may run on the calling thread, which therefore must not hold a readonly transaction of env.
+ *
+ * @return The state root, the same as regenerate_intermediate_hashes would return.
+ */
+evmc::bytes32 calculate_state_root(lmdb::Environment& env, ThreadPool& pool);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_INTERMEDIATE_HASHES_H_
@@ -0,0 +1,274 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "intermediate_hashes.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <map>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/thread_pool.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/account.hpp>
+#include <utility>
+#include <vector>
+
+#include "change.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static evmc::address test_address(uint64_t i) {
+    evmc::address address{};
+    boost::endian::store_big_u64(&address.bytes[kAddressLength - 8], i);
+    return address;
+}
+
+static evmc::bytes32 test_word(uint64_t i) {
+    evmc::bytes32 word{};
+    boost::endian::store_big_u64(&word.bytes[kHashLength - 8], i);
+    return word;
+}
+
+static std::vector<std::pair<Bytes, Bytes>> read_table(lmdb::Transaction& txn, const lmdb::TableConfig& config) {
+    std::vector<std::pair<Bytes, Bytes>> entries;
+    auto table{txn.open(config)};
+    MDB_val key, data;
+    for (int rc{table->get_first(&key, &data)}; rc == MDB_SUCCESS; rc = table->get_next(&key, &data)) {
+        entries.emplace_back(from_mdb_val(key), from_mdb_val(data));
+    }
+    return entries;
+}
+
+namespace {
+
+    // Writes kPlainState along with the change sets of a block; previous values are left out, as only keys matter
+    class BlockWriter {
+      public:
+        BlockWriter(lmdb::Transaction& txn, uint64_t block_number) : txn_{txn}, block_number_{block_number} {}
+
+        void write_account(uint64_t i, const std::optional<Account>& account) {
+            evmc::address address{test_address(i)};
+            auto table{txn_.open(table::kPlainState)};
+            table->del(full_view(address));
+            if (account) {
+                table->put(full_view(address), account->encode_for_storage(/*omit_code_hash=*/false));
+            }
+            account_changes_[address] = Bytes{};
+        }
+
+        void write_storage(uint64_t i, uint64_t incarnation, uint64_t location, uint64_t value) {
+            evmc::address address{test_address(i)};
+            evmc::bytes32 location_word{test_word(location)};
+            Bytes prefix{storage_prefix(address, incarnation)};
+            auto table{txn_.open(table::kPlainState)};
+            table->del(prefix, full_view(location_word));
+            if (value) {
+                Bytes data{full_view(location_word)};
+                data.append(zeroless_view(test_word(value)));
+                table->put(prefix, data);
+            }
+            storage_changes_[storage_key(address, incarnation, location_word)] = Bytes{};
+        }
+
+        ~BlockWriter() {
+            Bytes key{encode_timestamp(block_number_)};
+            txn_.open(table::kPlainAccountChangeSet)->put(key, account_changes_.encode());
+            if (!storage_changes_.empty()) {
+                txn_.open(table::kPlainStorageChangeSet)->put(key, storage_changes_.encode());
+            }
+        }
+
+      private:
+        lmdb::Transaction& txn_;
+        uint64_t block_number_;
+        AccountChanges account_changes_;
+        StorageChanges storage_changes_;
+    };
+
+}  // namespace
+
+TEST_CASE("Intermediate hashes") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    // Accounts 1 to 300, enough for stored branch nodes below the root;
+    // every tenth is a contract with up to 7 storage slots
+    std::map<uint64_t, Account> accounts;
+    {
+        BlockWriter genesis{*txn, 0};
+        for (uint64_t i{1}; i <= 300; ++i) {
+            Account& account{accounts[i]};
+            account.nonce = i;
+            account.balance = i * kGiga;
+            if (i % 10 == 0) {
+                account.incarnation = 1;
+                account.code_hash = to_bytes32(full_view(keccak256(full_view(test_address(i))).bytes));
+                for (uint64_t j{1}; j <= i % 7 + 1; ++j) {
+                    genesis.write_storage(i, 1, j, i * 1000 + j);
+                }
+            }
+            genesis.write_account(i, account);
+        }
+    }
+
+    // Roots computed independently of silkworm
+    constexpr evmc::bytes32 kRoot0{0x01bede341f69cf78acdb1fe962be4707f57d41ed70257e9abf2d3a82104555af_bytes32};
+    constexpr evmc::bytes32 kRoot1{0x8670677eebb8696654e166fde2902efe12522941de8785436be517db6e4de99c_bytes32};
+    constexpr evmc::bytes32 kRoot2{0x51d192b7bc8b2275443bc12428477062f73ff88a6545297d63227ff6713ab2ce_bytes32};
+
+    // Sorting spills into files
+    CHECK(regenerate_intermediate_hashes(*txn, /*memory_budget=*/1'000) == kRoot0);
+    CHECK(read_table(*txn, table::kIntermediateTrieHash).size() > 1);
+
+    auto block1{[&] {
+        BlockWriter block{*txn, 1};
+
+        // Account deletions, with & without storage
+        accounts.erase(5);
+        block.write_account(5, std::nullopt);
+        accounts.erase(20);
+        block.write_account(20, std::nullopt);
+        for (uint64_t j{1}; j <= 20 % 7 + 1; ++j) {
+            block.write_storage(20, 1, j, 0);
+        }
+
+        // Storage only: a slot updated, one cleared and one created
+        block.write_storage(30, 1, 1, 7);
+        block.write_storage(30, 1, 2, 0);
+        block.write_storage(30, 1, 100, 0x1234);
+
+        accounts[7].balance += 1;
+        block.write_account(7, accounts[7]);
+
+        accounts[1000].balance = 1;
+        block.write_account(1000, accounts[1000]);
+    }};
+
+    auto block2{[&] {
+        BlockWriter block{*txn, 2};
+
+        // Self-destructed & recreated with a new incarnation
+        for (uint64_t j{1}; j <= 40 % 7 + 1; ++j) {
+            block.write_storage(40, 1, j, 0);
+        }
+        accounts[40].incarnation = 2;
+        block.write_account(40, accounts[40]);
+        block.write_storage(40, 2, 1, 99);
+
+        // One of the only two accounts under a first byte of hashed addresses is deleted,
+        // so that the branch node above them collapses
+        std::map<uint8_t, std::vector<uint64_t>> by_first_byte;
+        for (const auto& [i, account] : accounts) {
+            by_first_byte[keccak256(full_view(test_address(i))).bytes[0]].push_back(i);
+        }
+        for (const auto& [first_byte, group] : by_first_byte) {
+            if (group.size() == 2 && accounts[group[0]].incarnation == 0 && accounts[group[1]].incarnation == 0) {
+                accounts.erase(group[0]);
+                block.write_account(group[0], std::nullopt);
+                break;
+            }
+        }
+    }};
+
+    SECTION("block by block") {
+        block1();
+        CHECK(increment_intermediate_hashes(*txn, 1, 1) == kRoot1);
+        block2();
+        CHECK(increment_intermediate_hashes(*txn, 2, 2) == kRoot2);
+    }
+
+    SECTION("blocks at once") {
+        block1();
+        block2();
+        CHECK(increment_intermediate_hashes(*txn, 1, 2) == kRoot2);
+    }
+
+    // The tables end up as if regenerated
+    std::vector<std::pair<Bytes, Bytes>> hashed_state{read_table(*txn, table::kCurrentState)};
+    std::vector<std::pair<Bytes, Bytes>> trie_hashes{read_table(*txn, table::kIntermediateTrieHash)};
+    CHECK(regenerate_intermediate_hashes(*txn) == kRoot2);
+    CHECK(read_table(*txn, table::kCurrentState) == hashed_state);
+    CHECK(read_table(*txn, table::kIntermediateTrieHash) == trie_hashes);
+}
+
+// Writes accounts 1 to n whose hashed addresses pass the filter, every third with storage,
+// then regenerates the hashed state and commits it
+template <class Filter>
+static evmc::bytes32 write_state(lmdb::Environment& env, uint64_t n, Filter filter) {
+    std::unique_ptr<lmdb::Transaction> txn{env.begin_rw_transaction()};
+    table::create_all(*txn);
+    {
+        BlockWriter genesis{*txn, 0};
+        for (uint64_t i{1}; i <= n; ++i) {
+            if (!filter(keccak256(full_view(test_address(i))).bytes[0])) {
+                continue;
+            }
+            Account account;
+            account.nonce = i;
+            if (i % 3 == 0) {
+                account.incarnation = 1;
+                for (uint64_t j{1}; j <= i % 5 + 1; ++j) {
+                    genesis.write_storage(i, 1, j, i + j);
+                }
+            }
+            genesis.write_account(i, account);
+        }
+    }
+    evmc::bytes32 root{regenerate_intermediate_hashes(*txn)};
+    lmdb::err_handler(txn->commit());
+    return root;
+}
+
+TEST_CASE("Parallel state root") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    ThreadPool pool{3};
+
+    SECTION("empty") {
+        CHECK(write_state(*env, 0, [](uint8_t) { return true; }) == kEmptyRoot);
+        CHECK(calculate_state_root(*env, pool) == kEmptyRoot);
+    }
+
+    SECTION("single account") {
+        evmc::bytes32 root{write_state(*env, 1, [](uint8_t) { return true; })};
+        CHECK(calculate_state_root(*env, pool) == root);
+    }
+
+    SECTION("single first nibble") {
+        evmc::bytes32 root{write_state(*env, 600, [](uint8_t first_byte) { return first_byte >> 4 == 0x7; })};
+        CHECK(calculate_state_root(*env, pool) == root);
+    }
+
+    SECTION("single first byte") {
+        evmc::bytes32 root{write_state(*env, 3'000, [](uint8_t first_byte) { return first_byte == 0x7a; })};
+        CHECK(calculate_state_root(*env, pool) == root);
+    }
+
+    SECTION("several first nibbles") {
+        evmc::bytes32 root{write_state(*env, 300, [](uint8_t) { return true; })};
+        CHECK(calculate_state_root(*env, pool) == root);
+    }
+}
+
+}  // namespace silkworm::db
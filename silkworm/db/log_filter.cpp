@@ -0,0 +1,115 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_filter.hpp"
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+
+#include "access_layer.hpp"
+#include "bloom_bits.hpp"
+#include "log_index.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+bool LogFilter::matches(const Log& log) const {
+    if (!addresses.empty() && std::find(addresses.begin(), addresses.end(), log.address) == addresses.end()) {
+        return false;
+    }
+    if (log.topics.size() < topics.size()) {
+        return false;
+    }
+    for (size_t i{0}; i < topics.size(); ++i) {
+        if (!topics[i].empty() && std::find(topics[i].begin(), topics[i].end(), log.topics[i]) == topics[i].end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether all the 3 bits of a value are set in the bloom; see m3_2048
+static bool bloom_contains(const Bloom& bloom, ByteView value) {
+    ethash::hash256 hash{keccak256(value)};
+    for (size_t i{0}; i < 6; i += 2) {
+        const unsigned bit{((hash.bytes[i] << 8) | hash.bytes[i + 1]) & 0x7FFu};
+        if (!(bloom[kBloomByteLength - 1 - bit / 8] & (1 << (bit % 8)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogFilter::may_match(const Bloom& bloom) const {
+    if (!addresses.empty() && std::none_of(addresses.begin(), addresses.end(), [&bloom](const evmc::address& a) {
+            return bloom_contains(bloom, full_view(a));
+        })) {
+        return false;
+    }
+    for (const std::vector<evmc::bytes32>& position : topics) {
+        if (!position.empty() && std::none_of(position.begin(), position.end(), [&bloom](const evmc::bytes32& t) {
+                return bloom_contains(bloom, full_view(t));
+            })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<FilteredLog> get_logs(lmdb::Transaction& txn, const LogFilter& filter, uint64_t from, uint64_t to) {
+    std::vector<FilteredLog> res;
+
+    // Blocks indexed by the log index stage are looked up there, the rest through the bloom bits
+    std::vector<uint64_t> blocks;
+    const uint64_t indexed_to{read_stage_progress(txn, kLogIndexStage).value_or(0)};
+    if (indexed_to > 0 && from <= indexed_to) {
+        blocks = log_index::match(txn, filter, from, std::min(to, indexed_to));
+        from = indexed_to + 1;
+    }
+    if (from <= to) {
+        std::vector<uint64_t> rest{bloom_bits::match(txn, filter, from, to)};
+        blocks.insert(blocks.end(), rest.begin(), rest.end());
+    }
+
+    auto log_table{txn.open(table::kLogs)};
+    std::vector<Log> logs;
+    for (uint64_t block_number : blocks) {
+        uint32_t log_index{0};
+        Bytes first_key{log_key(block_number, 0)};
+        MDB_val key{to_mdb_val(first_key)}, value;
+        for (int rc{log_table->seek(&key, &value)}; rc != MDB_NOTFOUND; rc = log_table->get_next(&key, &value)) {
+            lmdb::err_handler(rc);
+            ByteView k{from_mdb_val(key)};
+            if (k.length() != 8 + 4 || boost::endian::load_big_u64(k.data()) != block_number) {
+                break;
+            }
+            const uint32_t transaction_index{boost::endian::load_big_u32(&k[8])};
+            cbor_decode(from_mdb_val(value), logs);
+            for (Log& log : logs) {
+                if (filter.matches(log)) {
+                    res.push_back({block_number, transaction_index, log_index, std::move(log)});
+                }
+                ++log_index;
+            }
+        }
+    }
+
+    return res;
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,58 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_LOG_FILTER_H_
+#define SILKWORM_DB_LOG_FILTER_H_
+
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/types/bloom.hpp>
+#include <silkworm/types/log.hpp>
+#include <vector>
+
+namespace silkworm::db {
+
+// Log filter with the semantics of eth_getLogs
+struct LogFilter {
+    std::vector<evmc::address> addresses;  // any of them; no address means any address
+
+    // For every position the topic must be one of those given; no topics means any topic.
+    // Logs with fewer topics than positions are not matched.
+    std::vector<std::vector<evmc::bytes32>> topics;
+
+    bool matches(const Log& log) const;
+
+    // Whether logs matching the filter may be present, according to a logs bloom
+    bool may_match(const Bloom& bloom) const;
+};
+
+struct FilteredLog {
+    uint64_t block_number{0};
+    uint32_t transaction_index{0};
+    uint32_t log_index{0};  // within the block
+    Log log;
+};
+
+/** @brief Finds the logs of blocks [from; to] matching the filter.
+ *
+ * Candidate blocks are picked through the log index up to its stage progress (see log_index::match)
+ * and through the bloom bits index past it (see bloom_bits::match); only their logs are read.
+ * Requires the logs to be stored in kLogs.
+ */
+std::vector<FilteredLog> get_logs(lmdb::Transaction& txn, const LogFilter& filter, uint64_t from, uint64_t to);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_LOG_FILTER_H_
@@ -0,0 +1,218 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_index.hpp"
+
+#include <absl/container/flat_hash_set.h>
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+#include <optional>
+
+#include "etl.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db::log_index {
+
+using boost::endian::load_big_u32;
+using boost::endian::load_big_u64;
+using boost::endian::store_big_u32;
+
+// Writes the elements collected as key + block number (uint32 BE), in the same way as build_history_index
+static void load_index(etl::Collector& collector, lmdb::Table& index_table, size_t key_length) {
+    Bytes chunk_key(key_length + 4, '\0');
+    bitmap::Bitmap chunk{};
+    bool has_key{false};
+
+    auto write_chunk{[&](uint32_t suffix) {
+        store_big_u32(&chunk_key[key_length], suffix);
+        index_table.put(chunk_key, chunk.serialize(), index_table.append_flag(chunk_key));
+        chunk = {};
+    }};
+
+    collector.load([&](ByteView element_key, ByteView) {
+        ByteView key{element_key.substr(0, key_length)};
+        const uint32_t block_number{load_big_u32(&element_key[key_length])};
+
+        if (!has_key || key != ByteView{chunk_key}.substr(0, key_length)) {
+            if (has_key) {
+                write_chunk(UINT32_MAX);
+            }
+            has_key = true;
+            std::memcpy(&chunk_key[0], key.data(), key_length);
+
+            // Extend the last chunk of the key, if it's already indexed
+            store_big_u32(&chunk_key[key_length], UINT32_MAX);
+            if (std::optional<ByteView> last_chunk{index_table.get(chunk_key)}; last_chunk) {
+                chunk = bitmap::Bitmap{*last_chunk};
+                index_table.del(chunk_key);
+            }
+        }
+
+        if (!chunk.empty()) {
+            const uint32_t last_block{chunk.maximum()};
+            if (block_number <= last_block) {
+                return;  // already indexed
+            }
+            // An array value takes 2 bytes; a new array container 8 more for its header
+            const size_t added_size{(block_number >> 16) == (last_block >> 16) ? 2u : 10u};
+            if (chunk.serialized_size() + added_size > kChunkLimit) {
+                write_chunk(last_block);
+            }
+        }
+        chunk.add(block_number);
+    });
+
+    if (has_key) {
+        write_chunk(UINT32_MAX);
+    }
+}
+
+void build(lmdb::Transaction& txn, uint64_t from, uint64_t to, size_t memory_budget) {
+    etl::Collector address_collector{memory_budget / 2};
+    etl::Collector topic_collector{memory_budget / 2};
+
+    // Addresses & topics are collected once per block
+    absl::flat_hash_set<evmc::address> block_addresses;
+    absl::flat_hash_set<evmc::bytes32> block_topics;
+    uint64_t current_block{from};
+
+    Bytes address_key(kAddressLength + 4, '\0');
+    Bytes topic_key(kHashLength + 4, '\0');
+
+    auto log_table{txn.open(table::kLogs)};
+    std::vector<Log> logs;
+    Bytes first_key{log_key(from, 0)};
+    MDB_val key{to_mdb_val(first_key)}, value;
+    for (int rc{log_table->seek(&key, &value)}; rc != MDB_NOTFOUND; rc = log_table->get_next(&key, &value)) {
+        lmdb::err_handler(rc);
+        ByteView k{from_mdb_val(key)};
+        const uint64_t block_number{load_big_u64(k.data())};
+        if (block_number > to) {
+            break;
+        }
+        if (block_number != current_block) {
+            block_addresses.clear();
+            block_topics.clear();
+            current_block = block_number;
+        }
+
+        cbor_decode(from_mdb_val(value), logs);
+        store_big_u32(&address_key[kAddressLength], static_cast<uint32_t>(block_number));
+        store_big_u32(&topic_key[kHashLength], static_cast<uint32_t>(block_number));
+        for (const Log& log : logs) {
+            if (block_addresses.insert(log.address).second) {
+                std::memcpy(&address_key[0], log.address.bytes, kAddressLength);
+                address_collector.collect(address_key, {});
+            }
+            for (const evmc::bytes32& topic : log.topics) {
+                if (block_topics.insert(topic).second) {
+                    std::memcpy(&topic_key[0], topic.bytes, kHashLength);
+                    topic_collector.collect(topic_key, {});
+                }
+            }
+        }
+    }
+    log_table.reset();
+
+    auto address_table{txn.open(table::kLogAddressIndex, MDB_CREATE)};
+    load_index(address_collector, *address_table, kAddressLength);
+    auto topic_table{txn.open(table::kLogTopicIndex, MDB_CREATE)};
+    load_index(topic_collector, *topic_table, kHashLength);
+}
+
+bitmap::Bitmap get(lmdb::Table& index_table, ByteView key, uint32_t from, uint32_t to) {
+    bitmap::Bitmap res;
+
+    // The first chunk that may have from is the first one with a suffix not less than it
+    Bytes seek_key(key.length() + 4, '\0');
+    std::memcpy(&seek_key[0], key.data(), key.length());
+    store_big_u32(&seek_key[key.length()], from);
+
+    MDB_val k{to_mdb_val(seek_key)}, v;
+    for (int rc{index_table.seek(&k, &v)}; rc != MDB_NOTFOUND; rc = index_table.get_next(&k, &v)) {
+        lmdb::err_handler(rc);
+        ByteView chunk_key{from_mdb_val(k)};
+        if (chunk_key.length() != key.length() + 4 || chunk_key.substr(0, key.length()) != key) {
+            break;
+        }
+        res |= bitmap::Bitmap{from_mdb_val(v)};
+        if (load_big_u32(&chunk_key[key.length()]) >= to) {
+            break;
+        }
+    }
+    return res;
+}
+
+std::vector<uint64_t> match(lmdb::Transaction& txn, const LogFilter& filter, uint64_t from, uint64_t to) {
+    std::vector<uint64_t> res;
+    if (from > to || from > UINT32_MAX) {
+        return res;
+    }
+    const auto from32{static_cast<uint32_t>(from)};
+    const auto to32{static_cast<uint32_t>(std::min<uint64_t>(to, UINT32_MAX))};
+
+    auto address_table{txn.open(table::kLogAddressIndex, MDB_CREATE)};
+    auto topic_table{txn.open(table::kLogTopicIndex, MDB_CREATE)};
+
+    std::optional<bitmap::Bitmap> blocks;
+    auto intersect{[&blocks](bitmap::Bitmap any) {
+        if (blocks) {
+            *blocks &= any;
+        } else {
+            blocks = std::move(any);
+        }
+    }};
+
+    if (!filter.addresses.empty()) {
+        bitmap::Bitmap any;
+        for (const evmc::address& address : filter.addresses) {
+            any |= get(*address_table, full_view(address), from32, to32);
+        }
+        intersect(std::move(any));
+    }
+    for (const std::vector<evmc::bytes32>& position : filter.topics) {
+        if (blocks && blocks->empty()) {
+            return res;
+        }
+        if (position.empty()) {
+            continue;
+        }
+        bitmap::Bitmap any;
+        for (const evmc::bytes32& topic : position) {
+            any |= get(*topic_table, full_view(topic), from32, to32);
+        }
+        intersect(std::move(any));
+    }
+
+    if (!blocks) {
+        for (uint64_t block_number{from32}; block_number <= to32; ++block_number) {
+            res.push_back(block_number);
+        }
+        return res;
+    }
+
+    blocks->for_each([&](uint32_t block_number) {
+        if (block_number >= from32 && block_number <= to32) {
+            res.push_back(block_number);
+        }
+    });
+    return res;
+}
+
+}  // namespace silkworm::db::log_index
@@ -0,0 +1,70 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_LOG_INDEX_H_
+#define SILKWORM_DB_LOG_INDEX_H_
+
+/*
+Part of the compatibility layer with the Turbo-Geth DB format;
+see its eth/stagedsync/stage_log_index.go.
+
+kLogAddressIndex and kLogTopicIndex map every log address (or topic) to the blocks with logs of it,
+as Roaring bitmaps (see bitmap.hpp) split into chunks of at most kChunkLimit bytes:
+    address (or topic) + chunk suffix (uint32 BE) -> serialized bitmap
+The chunk suffix is the largest block of the chunk, or UINT32_MAX for the last chunk of the key.
+Topics are indexed regardless of their position in the log.
+Block numbers are 32-bit, as in Turbo-Geth.
+*/
+
+#include <silkworm/db/bitmap.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/log_filter.hpp>
+#include <vector>
+
+namespace silkworm::db {
+
+namespace log_index {
+
+    // Chunks are split before their serialized bitmap would exceed this many bytes.
+    // See Turbo-Geth bitmapdb.ChunkLimit
+    constexpr size_t kChunkLimit{1950};
+
+    /** @brief Indexes the logs of blocks [from; to] from kLogs.
+     *
+     * Index elements are sorted externally with etl::Collectors within memory_budget.
+     * The last chunk of a key already in the index is extended, so the index may be extended from its current
+     * progress; blocks already in the index are skipped.
+     */
+    void build(lmdb::Transaction& txn, uint64_t from, uint64_t to, size_t memory_budget = 256 << 20);
+
+    // Union of the chunks of key (an address or a topic) that may have blocks in [from; to].
+    // The result may have blocks outside the range.
+    bitmap::Bitmap get(lmdb::Table& index_table, ByteView key, uint32_t from, uint32_t to);
+
+    /** @brief Blocks in [from; to] that have logs of the addresses and topics of the filter, in ascending order.
+     *
+     * The bitmaps of the values of every constraint (addresses, topic positions) are united,
+     * and those of the constraints intersected. As topic positions aren't indexed, the blocks found may still
+     * have no logs matching the filter. A filter without constraints matches every block.
+     * Blocks not indexed yet aren't found; see kLogIndexStage.
+     */
+    std::vector<uint64_t> match(lmdb::Transaction& txn, const LogFilter& filter, uint64_t from, uint64_t to);
+
+}  // namespace log_index
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_LOG_INDEX_H_
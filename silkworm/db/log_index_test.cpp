@@ -0,0 +1,144 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_index.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <map>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <vector>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db::log_index {
+
+static std::map<Bytes, Bytes> read_table(lmdb::Transaction& txn, const lmdb::TableConfig& config) {
+    std::map<Bytes, Bytes> res;
+    auto table{txn.open(config)};
+    MDB_val key, data;
+    for (int rc{table->get_first(&key, &data)}; rc == MDB_SUCCESS; rc = table->get_next(&key, &data)) {
+        res.emplace(from_mdb_val(key), from_mdb_val(data));
+    }
+    return res;
+}
+
+TEST_CASE("Log index") {
+    using namespace evmc::literals;
+
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const auto a{0x000000000000000000000000000000000000000a_address};
+    const auto b{0x000000000000000000000000000000000000000b_address};
+    const auto t{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto u{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+
+    // a logs in every third block, b in every fifth, across two bitmap containers
+    const auto has_a{[](uint64_t block_number) { return block_number % 3 == 0; }};
+    const auto has_b{[](uint64_t block_number) { return block_number % 5 == 0; }};
+    const uint64_t last_block{70'000};
+    {
+        auto log_table{txn->open(table::kLogs)};
+        for (uint64_t block_number{0}; block_number <= last_block; ++block_number) {
+            if (has_a(block_number)) {
+                log_table->put(log_key(block_number, 0), cbor_encode(std::vector<Log>{{a, {t}}, {a, {t}}}));
+            }
+            if (has_b(block_number)) {
+                log_table->put(log_key(block_number, 1), cbor_encode(std::vector<Log>{{b, {u, t}}}));
+            }
+        }
+    }
+
+    build(*txn, 0, 4'000);
+    CHECK(match(*txn, LogFilter{{a}, {}}, 3'990, 4'010) == std::vector<uint64_t>{3'990, 3'993, 3'996, 3'999});
+    CHECK(match(*txn, LogFilter{{b}, {}}, 3'999, 4'010) == std::vector<uint64_t>{4'000});  // to is included
+
+    // Overlapping the blocks already indexed
+    build(*txn, 3'000, last_block);
+
+    SECTION("chunks") {
+        std::map<Bytes, Bytes> chunks{read_table(*txn, table::kLogAddressIndex)};
+        std::vector<uint32_t> a_blocks;
+        size_t a_chunks{0};
+        for (const auto& [key, value] : chunks) {
+            CHECK(value.length() <= kChunkLimit);
+            if (ByteView{key}.substr(0, kAddressLength) != full_view(a)) {
+                continue;
+            }
+            ++a_chunks;
+            const bitmap::Bitmap chunk{value};
+            const uint32_t suffix{boost::endian::load_big_u32(&key[kAddressLength])};
+            if (suffix != UINT32_MAX) {
+                CHECK(suffix == chunk.maximum());
+                // Only the last chunk may be split early
+                CHECK(value.length() + 2 > kChunkLimit);
+            } else {
+                CHECK(chunk.maximum() == last_block - last_block % 3);
+            }
+            std::vector<uint32_t> values{chunk.values()};
+            a_blocks.insert(a_blocks.end(), values.begin(), values.end());
+        }
+        CHECK(a_chunks > 20);
+
+        std::vector<uint32_t> expected;
+        for (uint32_t block_number{0}; block_number <= last_block; ++block_number) {
+            if (has_a(block_number)) {
+                expected.push_back(block_number);
+            }
+        }
+        CHECK(a_blocks == expected);  // chunks are ordered and disjoint
+
+        // Indexing again changes nothing
+        build(*txn, 0, last_block);
+        CHECK(read_table(*txn, table::kLogAddressIndex) == chunks);
+    }
+
+    SECTION("match") {
+        const auto expected{[](uint64_t from, uint64_t to, auto predicate) {
+            std::vector<uint64_t> res;
+            for (uint64_t block_number{from}; block_number <= to; ++block_number) {
+                if (predicate(block_number)) {
+                    res.push_back(block_number);
+                }
+            }
+            return res;
+        }};
+
+        CHECK(match(*txn, LogFilter{{a}, {}}, 100, 65'600) == expected(100, 65'600, has_a));
+        CHECK(match(*txn, LogFilter{{b}, {}}, 3'999, 4'001) == std::vector<uint64_t>{4'000});
+        CHECK(match(*txn, LogFilter{{a, b}, {}}, 10, 20) == std::vector<uint64_t>{10, 12, 15, 18, 20});
+        CHECK(match(*txn, LogFilter{{a}, {{u}}}, 0, last_block) ==
+              expected(0, last_block, [&](uint64_t n) { return has_a(n) && has_b(n); }));
+
+        // Topic positions aren't indexed
+        CHECK(match(*txn, LogFilter{{}, {{}, {u}}}, 60'000, 60'030) == expected(60'000, 60'030, has_b));
+        CHECK(match(*txn, LogFilter{{}, {{t}}}, 69'990, last_block + 100) ==
+              expected(69'990, last_block, [&](uint64_t n) { return has_a(n) || has_b(n); }));
+
+        CHECK(match(*txn, LogFilter{}, 5, 8) == std::vector<uint64_t>{5, 6, 7, 8});
+        CHECK(match(*txn, LogFilter{{0x000000000000000000000000000000000000000c_address}, {}}, 0, last_block).empty());
+        CHECK(match(*txn, LogFilter{{a}, {}}, 20, 10).empty());
+    }
+}
+
+}  // namespace silkworm::db::log_index
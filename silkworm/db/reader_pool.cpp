@@ -0,0 +1,124 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "reader_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace silkworm::lmdb {
+
+ReaderPool::ReaderPool(std::shared_ptr<Environment> env, const ReaderPoolConfig& config)
+    : env_{std::move(env)}, max_snapshot_age_{config.max_snapshot_age} {
+    if (!env_ || !env_->is_opened()) {
+        throw std::invalid_argument("Invalid argument : env");
+    }
+
+    unsigned int env_flags{0};
+    err_handler(env_->get_flags(&env_flags));
+    if ((env_flags & MDB_NOTLS) != MDB_NOTLS) {
+        throw std::runtime_error("Reader pool requires an environment opened with MDB_NOTLS");
+    }
+
+    size_ = config.max_readers ? config.max_readers : std::max(std::thread::hardware_concurrency(), 1u);
+    unsigned int max_readers{0};
+    err_handler(env_->get_max_readers(&max_readers));
+    if (size_ >= max_readers) {
+        throw std::runtime_error("Reader pool size exceeds environment's max readers");
+    }
+
+    readers_ = std::make_unique<Reader[]>(size_);
+}
+
+// Threads are numbered in the order of their first acquisition from any pool
+static size_t thread_index() {
+    static std::atomic<size_t> next_index{0};
+    thread_local const size_t index{next_index.fetch_add(1, std::memory_order_relaxed)};
+    return index;
+}
+
+ReaderPool::Lease ReaderPool::acquire() {
+    // Start from this thread's preferred reader so that worker threads keep to their own
+    const size_t first{thread_index() % size_};
+    for (;;) {
+        for (size_t i{0}; i < size_; ++i) {
+            Reader& reader{readers_[(first + i) % size_]};
+            if (reader.busy.load(std::memory_order_relaxed) || reader.busy.exchange(true, std::memory_order_acquire)) {
+                continue;
+            }
+            try {
+                renew(reader);
+            } catch (...) {
+                reader.busy.store(false, std::memory_order_release);
+                throw;
+            }
+            return Lease{this, &reader};
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ReaderPool::renew(Reader& reader) const {
+    int maxtries{3};
+    int rc{0};
+    do {
+        if (reader.txn) {
+            rc = mdb_txn_renew(*reader.txn->handle());
+        } else {
+            MDB_txn* handle{nullptr};
+            rc = mdb_txn_begin(*env_->handle(), nullptr, MDB_RDONLY, &handle);
+            if (rc == MDB_SUCCESS) {
+                // Pooled readers are deliberately not accounted in the environment's per-thread counters
+                reader.txn = std::make_unique<Transaction>(nullptr, handle, MDB_RDONLY);
+            }
+        }
+        if (rc == MDB_MAP_RESIZED) {
+            // Data file has been grown by another process
+            err_handler(env_->set_mapsize(0));
+        } else if (rc == MDB_SUCCESS) {
+            break;
+        }
+    } while (--maxtries > 0);
+    err_handler(rc);
+    reader.renewed_at = std::chrono::steady_clock::now();
+}
+
+ReaderPool::Lease::Lease(Lease&& other) noexcept : pool_{other.pool_}, reader_{other.reader_} {
+    other.reader_ = nullptr;
+}
+
+ReaderPool::Lease::~Lease() {
+    if (reader_) {
+        reader_->txn->reset();
+        reader_->busy.store(false, std::memory_order_release);
+    }
+}
+
+bool ReaderPool::Lease::is_stale() const {
+    return std::chrono::steady_clock::now() - reader_->renewed_at > pool_->max_snapshot_age_;
+}
+
+bool ReaderPool::Lease::refresh(bool force) {
+    if (!force && !is_stale()) {
+        return false;
+    }
+    reader_->txn->reset();
+    pool_->renew(*reader_);
+    return true;
+}
+
+}  // namespace silkworm::lmdb
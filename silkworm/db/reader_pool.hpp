@@ -0,0 +1,114 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_READER_POOL_H_
+#define SILKWORM_DB_READER_POOL_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <silkworm/db/chaindb.hpp>
+
+namespace silkworm::lmdb {
+
+/**
+ * Options for a ReaderPool
+ */
+struct ReaderPoolConfig {
+    size_t max_readers{0};                             // Number of pooled readers (0 means hardware concurrency)
+    std::chrono::milliseconds max_snapshot_age{5000};  // Age after which a leased snapshot is considered stale
+};
+
+/**
+ * A fixed set of readonly transactions shared among worker threads.
+ *
+ * Readers are begun once and then recycled with mdb_txn_reset/mdb_txn_renew, so handing
+ * one out costs a reader table update instead of a full begin/abort cycle and involves
+ * neither the environment's per-thread counters nor any mutex.
+ * Every thread has a preferred reader, assigned round robin in the order in which threads first
+ * acquire from any pool. Threads only share a preferred reader once more threads than readers
+ * have acquired; until then an acquisition is a single uncontended atomic exchange.
+ * Otherwise the other readers are tried in turn.
+ *
+ * An idle reader holds no snapshot. A long running scan should call Lease::refresh()
+ * at convenient points so that it does not pin old pages and make the data file grow.
+ *
+ * Requires the environment to be opened with MDB_NOTLS.
+ */
+class ReaderPool {
+  private:
+    struct Reader {
+        std::atomic<bool> busy{false};
+        std::unique_ptr<Transaction> txn{nullptr};
+        std::chrono::steady_clock::time_point renewed_at{};
+    };
+
+  public:
+    /**
+     * Exclusive use of a pooled reader. Returns the reader to the pool when destroyed.
+     */
+    class Lease {
+      public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        Transaction& operator*() const { return *reader_->txn; }
+        Transaction* operator->() const { return reader_->txn.get(); }
+        Transaction* get() const { return reader_->txn.get(); }
+
+        // Whether the snapshot is older than the pool's max_snapshot_age
+        bool is_stale() const;
+
+        // Moves to the latest snapshot if the current one is stale or if forced.
+        // Returns whether the snapshot has been renewed, in which case tables opened
+        // on the previous snapshot are no longer usable.
+        bool refresh(bool force = false);
+
+      private:
+        friend class ReaderPool;
+
+        Lease(const ReaderPool* pool, Reader* reader) : pool_{pool}, reader_{reader} {}
+
+        const ReaderPool* pool_;
+        Reader* reader_;
+    };
+
+    explicit ReaderPool(std::shared_ptr<Environment> env, const ReaderPoolConfig& config = {});
+    ~ReaderPool() = default;
+
+    ReaderPool(const ReaderPool&) = delete;
+    ReaderPool& operator=(const ReaderPool&) = delete;
+
+    // Hands out a reader positioned on the latest snapshot. Waits if all readers are leased.
+    Lease acquire();
+
+    size_t size() const { return size_; }
+
+  private:
+    void renew(Reader& reader) const;
+
+    std::shared_ptr<Environment> env_;
+    std::chrono::milliseconds max_snapshot_age_;
+    size_t size_;
+    std::unique_ptr<Reader[]> readers_;
+};
+
+}  // namespace silkworm::lmdb
+
+#endif  // SILKWORM_DB_READER_POOL_H_
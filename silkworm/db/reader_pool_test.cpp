@@ -0,0 +1,122 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "reader_pool.hpp"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <thread>
+
+namespace silkworm::lmdb {
+
+static const TableConfig kTestTable{"Test"};
+
+static void write_value(Environment& env, ByteView value) {
+    std::unique_ptr<Transaction> txn{env.begin_rw_transaction()};
+    txn->open(kTestTable, MDB_CREATE)->put(from_hex("01"), value);
+    err_handler(txn->commit());
+}
+
+static std::optional<ByteView> read_value(Transaction& txn) { return txn.open(kTestTable)->get(from_hex("01")); }
+
+TEST_CASE("Reader pool") {
+    TemporaryDirectory tmp_dir{};
+    DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<Environment> env{get_env(db_config)};
+    const Bytes aa{from_hex("aa")};
+    const Bytes bb{from_hex("bb")};
+    write_value(*env, aa);
+
+    ReaderPoolConfig pool_config{/*max_readers=*/2, /*max_snapshot_age=*/std::chrono::hours{1}};
+
+    SECTION("acquire") {
+        ReaderPool pool{env, pool_config};
+        CHECK(pool.size() == 2);
+
+        auto first{std::make_unique<ReaderPool::Lease>(pool.acquire())};
+        ReaderPool::Lease second{pool.acquire()};
+        CHECK(first->get() != second.get());
+        CHECK(read_value(**first) == ByteView{aa});
+        CHECK(read_value(*second) == ByteView{aa});
+
+        // All readers are leased, so another thread waits for one to be returned
+        Transaction* first_txn{first->get()};
+        std::atomic<Transaction*> third_txn{nullptr};
+        std::thread thread{[&pool, &third_txn] {
+            ReaderPool::Lease third{pool.acquire()};
+            third_txn = third.get();
+        }};
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        CHECK(third_txn.load() == nullptr);
+        first.reset();
+        thread.join();
+        CHECK(third_txn.load() == first_txn);
+    }
+
+    SECTION("renew after reset") {
+        ReaderPool pool{env, pool_config};
+        Transaction* txn{nullptr};
+        {
+            ReaderPool::Lease lease{pool.acquire()};
+            txn = lease.get();
+            CHECK(read_value(*lease) == ByteView{aa});
+        }
+        write_value(*env, bb);
+
+        // The same thread gets its reader back, renewed on the latest snapshot
+        ReaderPool::Lease lease{pool.acquire()};
+        CHECK(lease.get() == txn);
+        CHECK(read_value(*lease) == ByteView{bb});
+    }
+
+    SECTION("refresh after a write commit") {
+        ReaderPool pool{env, pool_config};
+        ReaderPool::Lease lease{pool.acquire()};
+        CHECK(read_value(*lease) == ByteView{aa});
+
+        write_value(*env, bb);
+        CHECK(read_value(*lease) == ByteView{aa});
+
+        // Not stale yet
+        CHECK(!lease.refresh());
+        CHECK(read_value(*lease) == ByteView{aa});
+
+        CHECK(lease.refresh(/*force=*/true));
+        CHECK(read_value(*lease) == ByteView{bb});
+    }
+
+    SECTION("stale snapshot") {
+        pool_config.max_snapshot_age = std::chrono::milliseconds{50};
+        ReaderPool pool{env, pool_config};
+        ReaderPool::Lease lease{pool.acquire()};
+        CHECK(!lease.is_stale());
+        CHECK(read_value(*lease) == ByteView{aa});
+
+        write_value(*env, bb);
+        std::this_thread::sleep_for(std::chrono::milliseconds{60});
+        CHECK(lease.is_stale());
+        CHECK(read_value(*lease) == ByteView{aa});
+
+        CHECK(lease.refresh());
+        CHECK(!lease.is_stale());
+        CHECK(read_value(*lease) == ByteView{bb});
+    }
+}
+
+}  // namespace silkworm::lmdb
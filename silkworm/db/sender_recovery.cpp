@@ -0,0 +1,192 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "sender_recovery.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <gsl/gsl_util>
+#include <memory>
+#include <silkworm/crypto/ecdsa.hpp>
+#include <silkworm/crypto/keccak.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/block_view.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "block_range_reader.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+namespace {
+
+    // Transactions per pool task
+    constexpr size_t kChunkSize{1024};
+
+    // Batches recovered or written at the same time; bounds the memory held by results not written yet
+    constexpr size_t kMaxBatchesInFlight{4};
+
+    struct BlockSenders {
+        uint64_t block_number;
+        evmc::bytes32 hash;
+        size_t num_of_transactions;
+    };
+
+    // Filled in by the calling thread, then recovered chunk by chunk by the pool.
+    // Each task writes its own slice of senders and publishes it by decrementing pending_chunks,
+    // so the results are handed back without any locking.
+    struct Batch {
+        std::vector<BlockSenders> blocks;
+        std::vector<ecdsa::RecoverableSignature> signatures;
+        std::vector<evmc::address> senders;
+        std::atomic<size_t> pending_chunks{0};
+        std::atomic<bool> failed{false};
+
+        bool done() const { return pending_chunks.load(std::memory_order_acquire) == 0; }
+    };
+
+}  // namespace
+
+static void recover_chunk(Batch& batch, size_t begin, size_t end) {
+    if (!ecdsa::recover_addresses(&batch.signatures[begin], end - begin, &batch.senders[begin])) {
+        batch.failed.store(true, std::memory_order_relaxed);
+    }
+    batch.pending_chunks.fetch_sub(1, std::memory_order_release);
+}
+
+static void dispatch(Batch& batch, ThreadPool& pool) {
+    const size_t n{batch.signatures.size()};
+    batch.senders.resize(n);
+    batch.pending_chunks.store((n + kChunkSize - 1) / kChunkSize, std::memory_order_relaxed);
+    for (size_t begin{0}; begin < n; begin += kChunkSize) {
+        size_t end{std::min(begin + kChunkSize, n)};
+        pool.push([&batch, begin, end] { recover_chunk(batch, begin, end); });
+    }
+}
+
+static void wait(const Batch& batch, ThreadPool& pool) {
+    while (!batch.done()) {
+        if (!pool.try_run_one()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void add_signatures(Batch& batch, const ChainConfig& config, const evmc::bytes32& block_hash,
+                           const BlockView& block) {
+    const uint64_t block_number{block.header.number};
+    const bool homestead{config.has_homestead(block_number)};
+    const bool spurious_dragon{config.has_spurious_dragon(block_number)};
+
+    KeccakHasher hasher;
+    for (const TransactionView& txn : block.transactions) {
+        if (!ecdsa::is_valid_signature(txn.r, txn.s, homestead)) {
+            throw ValidationError("invalid signature in block " + std::to_string(block_number));
+        }
+
+        ecdsa::RecoveryId x{ecdsa::get_signature_recovery_id(txn.v)};
+        if (x.eip155_chain_id) {
+            if (!spurious_dragon || *x.eip155_chain_id != config.chain_id) {
+                throw ValidationError("invalid EIP-155 signature in block " + std::to_string(block_number));
+            }
+        }
+
+        rlp::encode(hasher, txn, /*for_signing=*/true,
+                    x.eip155_chain_id ? std::optional<uint64_t>{config.chain_id} : std::nullopt);
+
+        ecdsa::RecoverableSignature& signature{batch.signatures.emplace_back()};
+        ethash::hash256 hash{hasher.finalize()};
+        std::memcpy(signature.message, hash.bytes, kHashLength);
+        intx::be::unsafe::store(signature.signature, txn.r);
+        intx::be::unsafe::store(signature.signature + kHashLength, txn.s);
+        signature.recovery_id = x.recovery_id;
+    }
+
+    batch.blocks.push_back({block_number, block_hash, block.transactions.size()});
+}
+
+std::optional<uint64_t> recover_senders(lmdb::Transaction& txn, const ChainConfig& config, uint64_t from,
+                                        uint64_t to, ThreadPool& pool, size_t batch_size) {
+    auto sender_table{txn.open(table::kSenders, MDB_CREATE)};
+
+    std::deque<std::unique_ptr<Batch>> in_flight{};
+
+    // Tasks refer to their batches, so those must outlive them even if we bail out
+    auto cleanup{gsl::finally([&in_flight, &pool] {
+        for (const std::unique_ptr<Batch>& batch : in_flight) {
+            wait(*batch, pool);
+        }
+    })};
+
+    auto write_front{[&] {
+        Batch& batch{*in_flight.front()};
+        wait(batch, pool);
+        if (batch.failed.load(std::memory_order_relaxed)) {
+            throw ValidationError("failed to recover senders in blocks " +
+                                  std::to_string(batch.blocks.front().block_number) + " to " +
+                                  std::to_string(batch.blocks.back().block_number));
+        }
+
+        const evmc::address* senders{batch.senders.data()};
+        for (const BlockSenders& block : batch.blocks) {
+            Bytes key{block_key(block.block_number, block.hash.bytes)};
+            ByteView value{senders->bytes, block.num_of_transactions * kAddressLength};
+            sender_table->put(key, value, sender_table->append_flag(key));
+            senders += block.num_of_transactions;
+        }
+        in_flight.pop_front();
+    }};
+
+    std::optional<uint64_t> last_block{};
+    auto batch{std::make_unique<Batch>()};
+
+    // Signatures are copied out of the block views, which thus needn't outlive the writes to kSenders
+    BlockRangeReader reader{txn, from, to, /*read_senders=*/false};
+    BlockView block;
+    while (std::optional<evmc::bytes32> block_hash{reader.next(block)}) {
+        last_block = block.header.number;
+        if (block.transactions.empty()) {
+            continue;
+        }
+
+        add_signatures(*batch, config, *block_hash, block);
+
+        if (batch->signatures.size() >= batch_size) {
+            dispatch(*batch, pool);
+            in_flight.push_back(std::move(batch));
+            batch = std::make_unique<Batch>();
+            if (in_flight.size() == kMaxBatchesInFlight) {
+                write_front();
+            }
+        }
+    }
+
+    if (!batch->signatures.empty()) {
+        dispatch(*batch, pool);
+        in_flight.push_back(std::move(batch));
+    }
+    while (!in_flight.empty()) {
+        write_front();
+    }
+
+    return last_block;
+}
+
+}  // namespace silkworm::db
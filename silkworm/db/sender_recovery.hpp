@@ -0,0 +1,49 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_SENDER_RECOVERY_H_
+#define SILKWORM_DB_SENDER_RECOVERY_H_
+
+/*
+Part of the compatibility layer with the Turbo-Geth DB format;
+see its eth/stagedsync/stage_senders.go.
+*/
+
+#include <optional>
+#include <silkworm/chain/config.hpp>
+#include <silkworm/common/thread_pool.hpp>
+#include <silkworm/db/chaindb.hpp>
+
+namespace silkworm::db {
+
+/** @brief Recovers the transaction senders of canonical blocks [from; to] and writes them into kSenders.
+ *
+ * Signatures are validated and signing hashes computed on the calling thread,
+ * which hands batches of about batch_size transactions over to the pool for public key recovery.
+ * Recovered batches are written in block order while later ones are still in the pool,
+ * with MDB_APPEND past the end of the table.
+ * The calling thread runs pool tasks rather than blocking while it waits for a batch.
+ * Blocks without transactions get no kSenders entry; processing stops early at the end of the canonical chain.
+ *
+ * @return The number of the last block processed, if any.
+ * @throws ValidationError if a signature is invalid or its public key can't be recovered.
+ */
+std::optional<uint64_t> recover_senders(lmdb::Transaction& txn, const ChainConfig& config, uint64_t from,
+                                        uint64_t to, ThreadPool& pool, size_t batch_size = 10'000);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_SENDER_RECOVERY_H_
@@ -0,0 +1,185 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "sender_recovery.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <map>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/block.hpp>
+#include <vector>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+// Writes a canonical block, returning its key
+static Bytes write_block(lmdb::Transaction& txn, uint64_t block_number, const std::vector<Transaction>& transactions) {
+    BlockHeader header;
+    header.number = block_number;
+    Bytes encoded_header;
+    rlp::encode(encoded_header, header);
+    ethash::hash256 hash{keccak256(encoded_header)};
+
+    BlockBody body;
+    body.transactions = transactions;
+    Bytes encoded_body;
+    rlp::encode(encoded_body, body);
+
+    Bytes key{block_key(block_number, hash.bytes)};
+    txn.open(table::kBlockHeaders)->put(header_hash_key(block_number), full_view(hash.bytes));
+    txn.open(table::kBlockHeaders)->put(key, encoded_header);
+    txn.open(table::kBlockBodies)->put(key, encoded_body);
+    return key;
+}
+
+static std::map<Bytes, Bytes> read_senders(lmdb::Transaction& txn) {
+    std::map<Bytes, Bytes> senders;
+    auto table{txn.open(table::kSenders)};
+    MDB_val key, data;
+    for (int rc{table->get_first(&key, &data)}; rc == MDB_SUCCESS; rc = table->get_next(&key, &data)) {
+        senders.emplace(from_mdb_val(key), from_mdb_val(data));
+    }
+    return senders;
+}
+
+TEST_CASE("Recover senders") {
+    TemporaryDirectory tmp_dir{};
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 << 20};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    // Past Spurious Dragon, so that both pre-EIP-155 and EIP-155 signatures are valid
+    constexpr uint64_t kFirstBlock{2'675'000};
+
+    const evmc::address alice{0x8fa7de588b149efa9f1fdbe307921842f27b37c7_address};
+    const evmc::address bob{0xd94f176ccc749f9f3bebbd0fcf5a65c719219b09_address};
+
+    std::vector<Transaction> transactions{
+        {
+            0,                                                   // nonce
+            30 * kGiga,                                          // gas_price
+            21'000,                                              // gas_limit
+            0x5a0b54d5dc17e0aadc383d2db43b0a0d3e029c4c_address,  // to
+            kEther / 10,                                         // value
+            {},                                                  // data
+            27,                                                  // v
+            intx::from_string<intx::uint256>("0xbdd53a805e2c8f3313d63bb557b44e86be8f8cc445f46fd4030160843e7f5e37"),  // r
+            intx::from_string<intx::uint256>("0x5700b82fa072fcffe9b1ef448be95766043826d58cf723bd033032de91222f21"),  // s
+        },
+        {
+            0,                                                   // nonce
+            25 * kGiga,                                          // gas_price
+            50'000,                                              // gas_limit
+            0x5a0b54d5dc17e0aadc383d2db43b0a0d3e029c4c_address,  // to
+            0,                                                   // value
+            from_hex("a9059cbb"),                                // data
+            37,                                                  // v
+            intx::from_string<intx::uint256>("0x41e52bd4991dd4411a3664fdc6405ce458f69d1fab856cddd75370e254e6611a"),  // r
+            intx::from_string<intx::uint256>("0x076bb928fc41df54462a5efc3da23747e59635a97513c366757abcd2bcfab64f"),  // s
+        },
+        // The example of EIP-155
+        {
+            9,                                                   // nonce
+            20 * kGiga,                                          // gas_price
+            21'000,                                              // gas_limit
+            0x3535353535353535353535353535353535353535_address,  // to
+            kEther,                                              // value
+            {},                                                  // data
+            37,                                                  // v
+            intx::from_string<intx::uint256>("0x28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"),  // r
+            intx::from_string<intx::uint256>("0x67cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83"),  // s
+        },
+        {
+            1,                         // nonce
+            30 * kGiga,                // gas_price
+            100'000,                   // gas_limit
+            {},                        // to
+            0,                         // value
+            from_hex("600035600055"),  // data
+            27,                        // v
+            intx::from_string<intx::uint256>("0xf567c06367cc7977030f85eed8e201f277f1e2e8e7071d1f3dbf1bb9f70faf01"),  // r
+            intx::from_string<intx::uint256>("0x37679133aa2bd0083721e079c5fe4fea6f958d449a83ce0707ce65e9d6d27fc2"),  // s
+        },
+        {
+            1,                                                   // nonce
+            25 * kGiga,                                          // gas_price
+            21'000,                                              // gas_limit
+            0xb685342b8c54347aad148e1f22eff3eb3eb29391_address,  // to
+            5,                                                   // value
+            {},                                                  // data
+            37,                                                  // v
+            intx::from_string<intx::uint256>("0x24f7b3ea16c05c1de2a497280ebc21f4570285a19a6834b9aa0c74b7ed17af64"),  // r
+            intx::from_string<intx::uint256>("0x01f0daaaeb17b64cb4f2fbabd756c561906442ef1473e6f1a8ee1c5b9ebfca84"),  // s
+        },
+    };
+
+    // The second block has no transactions, hence no kSenders entry
+    Bytes key1{write_block(*txn, kFirstBlock, {transactions[0], transactions[1], transactions[2]})};
+    write_block(*txn, kFirstBlock + 1, {});
+    Bytes key3{write_block(*txn, kFirstBlock + 2, {transactions[3], transactions[4]})};
+
+    auto concat{[](std::initializer_list<evmc::address> senders) {
+        Bytes out;
+        for (const evmc::address& sender : senders) {
+            out.append(full_view(sender));
+        }
+        return out;
+    }};
+    const std::map<Bytes, Bytes> expected{
+        {key1, concat({alice, bob, 0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f_address})},
+        {key3, concat({alice, bob})},
+    };
+
+    ThreadPool pool{2};
+
+    SECTION("batches smaller than a block") {
+        std::optional<uint64_t> last_block{
+            recover_senders(*txn, kMainnetConfig, kFirstBlock, kFirstBlock + 10, pool, /*batch_size=*/2)};
+        CHECK(last_block == kFirstBlock + 2);
+        CHECK(read_senders(*txn) == expected);
+
+        // Recovered again over existing entries
+        last_block = recover_senders(*txn, kMainnetConfig, kFirstBlock, kFirstBlock + 1, pool, /*batch_size=*/1);
+        CHECK(last_block == kFirstBlock + 1);
+        CHECK(read_senders(*txn) == expected);
+
+        CHECK(!recover_senders(*txn, kMainnetConfig, kFirstBlock + 3, kFirstBlock + 10, pool));
+    }
+
+    SECTION("invalid signature") {
+        Transaction txn_without_r{transactions[0]};
+        txn_without_r.r = 0;
+        write_block(*txn, kFirstBlock + 3, {txn_without_r});
+        CHECK_THROWS_AS(recover_senders(*txn, kMainnetConfig, kFirstBlock, kFirstBlock + 3, pool), ValidationError);
+    }
+
+    SECTION("unrecoverable public key") {
+        // x = 5 is not on the curve
+        Transaction unrecoverable{transactions[0]};
+        unrecoverable.r = 5;
+        write_block(*txn, kFirstBlock + 3, {unrecoverable});
+        CHECK_THROWS_AS(recover_senders(*txn, kMainnetConfig, kFirstBlock, kFirstBlock + 3, pool), ValidationError);
+    }
+}
+
+}  // namespace silkworm::db
@@ -26,12 +26,14 @@ evmc::address create_address(const evmc::address& caller, uint64_t nonce) noexce
     rlp::Header h{true, 1 + kAddressLength};
     h.payload_length += rlp::length(nonce);
 
-    Bytes rlp{};
+    // The payload is under 56 bytes, so the whole encoding fits on the stack
+    uint8_t buf[1 + 1 + kAddressLength + 1 + 8];
+    rlp::SpanWriter rlp{buf, sizeof(buf)};
     rlp::encode_header(rlp, h);
     rlp::encode(rlp, caller.bytes);
     rlp::encode(rlp, nonce);
 
-    ethash::hash256 hash{keccak256(rlp)};
+    ethash::hash256 hash{keccak256(ByteView{buf, rlp.size()})};
 
     evmc::address address{};
     std::memcpy(address.bytes, hash.bytes + 12, kAddressLength);
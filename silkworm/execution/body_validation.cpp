@@ -0,0 +1,102 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "body_validation.hpp"
+
+#include <cstring>
+#include <silkworm/crypto/keccak.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/trie/vector_root.hpp>
+#include <string>
+#include <thread>
+
+#include "execution.hpp"
+
+namespace silkworm {
+
+BodyValidator::BodyValidator(const Block& block, ThreadPool& pool) : header_{block.header}, pool_{pool} {
+    pool_.push([this, &block] {
+        try {
+            transactions_root_ = trie::root_hash(block.transactions);
+
+            KeccakHasher hasher;
+            rlp::encode(hasher, block.ommers);
+            ethash::hash256 hash{hasher.finalize()};
+            std::memcpy(ommers_hash_.bytes, hash.bytes, kHashLength);
+        } catch (...) {
+            exception_ = std::current_exception();
+        }
+        done_.store(true, std::memory_order_release);
+    });
+}
+
+BodyValidator::BodyValidator(const BlockView& block, ThreadPool& pool) : header_{block.header}, pool_{pool} {
+    pool_.push([this, &block] {
+        try {
+            transactions_root_ = trie::root_hash(block.transactions);
+
+            ethash::hash256 hash;
+            if (!block.ommers_rlp.empty()) {
+                hash = keccak256(block.ommers_rlp);
+            } else {  // not decoded; even an empty list is encoded
+                KeccakHasher hasher;
+                rlp::encode(hasher, block.ommers);
+                hash = hasher.finalize();
+            }
+            std::memcpy(ommers_hash_.bytes, hash.bytes, kHashLength);
+        } catch (...) {
+            exception_ = std::current_exception();
+        }
+        done_.store(true, std::memory_order_release);
+    });
+}
+
+BodyValidator::~BodyValidator() { wait(); }
+
+void BodyValidator::wait() {
+    while (!done_.load(std::memory_order_acquire)) {
+        if (!pool_.try_run_one()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void BodyValidator::check(const std::vector<Receipt>& receipts) {
+    const BlockHeader& header{header_};
+
+    Bloom bloom{};
+    for (const Receipt& receipt : receipts) {
+        for (size_t i{0}; i < kBloomByteLength; ++i) {
+            bloom[i] |= receipt.bloom[i];
+        }
+    }
+    if (bloom != header.logs_bloom) {
+        throw ValidationError("logs bloom mismatch for block " + std::to_string(header.number));
+    }
+
+    wait();
+    if (exception_) {
+        std::rethrow_exception(exception_);
+    }
+    if (transactions_root_ != header.transactions_root) {
+        throw ValidationError("transactions root mismatch for block " + std::to_string(header.number));
+    }
+    if (ommers_hash_ != header.ommers_hash) {
+        throw ValidationError("ommers hash mismatch for block " + std::to_string(header.number));
+    }
+}
+
+}  // namespace silkworm
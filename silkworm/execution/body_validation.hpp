@@ -0,0 +1,67 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_EXECUTION_BODY_VALIDATION_H_
+#define SILKWORM_EXECUTION_BODY_VALIDATION_H_
+
+#include <atomic>
+#include <exception>
+#include <silkworm/common/thread_pool.hpp>
+#include <silkworm/types/block.hpp>
+#include <silkworm/types/block_view.hpp>
+#include <silkworm/types/receipt.hpp>
+#include <vector>
+
+namespace silkworm {
+
+/** @brief Checks a block header against the body & receipts: transactions root, ommers hash and logs bloom.
+ *
+ * The transactions root and the ommers hash don't depend on execution, so they are computed on the pool
+ * from construction on, while the block is being executed; only the logs bloom is left for check().
+ * The block must outlive the validator.
+ */
+class BodyValidator {
+  public:
+    BodyValidator(const Block& block, ThreadPool& pool);
+
+    // Hashes the encodings viewed rather than encoding the body again
+    BodyValidator(const BlockView& block, ThreadPool& pool);
+
+    // Waits for the pool task, if still running
+    ~BodyValidator();
+
+    BodyValidator(const BodyValidator&) = delete;
+    BodyValidator& operator=(const BodyValidator&) = delete;
+
+    // Throws ValidationError in case of a mismatch;
+    // rethrows any exception raised by the pool task
+    void check(const std::vector<Receipt>& receipts);
+
+  private:
+    void wait();
+
+    const BlockHeader& header_;
+    ThreadPool& pool_;
+
+    evmc::bytes32 transactions_root_{};
+    evmc::bytes32 ommers_hash_{};
+    std::exception_ptr exception_{};
+    std::atomic<bool> done_{false};
+};
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_EXECUTION_BODY_VALIDATION_H_
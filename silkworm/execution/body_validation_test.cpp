@@ -0,0 +1,111 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "body_validation.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <silkworm/crypto/keccak.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/trie/vector_root.hpp>
+
+#include "execution.hpp"
+
+namespace silkworm {
+
+TEST_CASE("Body validation") {
+    using namespace evmc::literals;
+
+    Block block{};
+    block.header.number = 1'000'000;
+
+    block.transactions.resize(2);
+    block.transactions[0].nonce = 172339;
+    block.transactions[0].gas_price = 50 * kGiga;
+    block.transactions[0].gas_limit = 90'000;
+    block.transactions[0].to = 0xe5ef458d37212a06e3f59d40c454e76150ae7c32_address;
+    block.transactions[0].value = 1'027'501'080 * kGiga;
+    block.transactions[0].v = 27;
+    block.transactions[0].r =
+        intx::from_string<intx::uint256>("0x48b55bfa915ac795c431978d8a6a992b628d557da5ff759b307d495a36649353");
+    block.transactions[0].s =
+        intx::from_string<intx::uint256>("0x1fffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804");
+    block.transactions[1] = block.transactions[0];
+    block.transactions[1].nonce = 172340;
+
+    block.ommers.resize(1);
+    block.ommers[0].number = 999'999;
+    block.ommers[0].beneficiary = 0x0c729be7c39543c3d549282a40395299d987cec2_address;
+
+    std::vector<Receipt> receipts(2);
+    receipts[0].bloom[7] = 0x10;
+    receipts[1].bloom[7] = 0x01;
+    receipts[1].bloom[200] = 0x80;
+
+    block.header.transactions_root = trie::root_hash(block.transactions);
+    Bytes ommers_rlp{};
+    rlp::encode(ommers_rlp, block.ommers);
+    ethash::hash256 ommers_hash{keccak256(ommers_rlp)};
+    std::memcpy(block.header.ommers_hash.bytes, ommers_hash.bytes, kHashLength);
+    block.header.logs_bloom[7] = 0x11;
+    block.header.logs_bloom[200] = 0x80;
+
+    ThreadPool pool{2};
+
+    SECTION("valid") {
+        BodyValidator validator{block, pool};
+        CHECK_NOTHROW(validator.check(receipts));
+    }
+
+    SECTION("view converted from a block") {
+        BlockView view{};
+        view.header = block.header;
+        for (const Transaction& txn : block.transactions) {
+            view.transactions.emplace_back(txn);
+        }
+        view.ommers = block.ommers;
+        BodyValidator validator{view, pool};
+        CHECK_NOTHROW(validator.check(receipts));
+    }
+
+    SECTION("transactions root mismatch") {
+        block.transactions[1].nonce = 172341;
+        BodyValidator validator{block, pool};
+        CHECK_THROWS_AS(validator.check(receipts), ValidationError);
+    }
+
+    SECTION("ommers hash mismatch") {
+        block.ommers.clear();
+        BodyValidator validator{block, pool};
+        CHECK_THROWS_AS(validator.check(receipts), ValidationError);
+    }
+
+    SECTION("logs bloom mismatch") {
+        receipts[1].bloom[201] = 0x01;
+        BodyValidator validator{block, pool};
+        CHECK_THROWS_AS(validator.check(receipts), ValidationError);
+    }
+
+    SECTION("empty body") {
+        Block empty{};
+        empty.header.transactions_root = kEmptyRoot;
+        empty.header.ommers_hash = kEmptyListHash;
+        BodyValidator validator{empty, pool};
+        CHECK_NOTHROW(validator.check({}));
+    }
+}
+
+}  // namespace silkworm
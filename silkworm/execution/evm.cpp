@@ -31,10 +31,10 @@
 
 namespace silkworm {
 
-EVM::EVM(const Block& block, IntraBlockState& state, const ChainConfig& config) noexcept
-    : block_{block}, state_{state}, config_{config} {}
+EVM::EVM(const BlockHeader& header, IntraBlockState& state, const ChainConfig& config) noexcept
+    : header_{header}, state_{state}, config_{config} {}
 
-CallResult EVM::execute(const Transaction& txn, uint64_t gas) noexcept {
+CallResult EVM::execute(const TransactionView& txn, uint64_t gas) noexcept {
     txn_ = &txn;
 
     bool contract_creation{!txn.to};
@@ -46,7 +46,7 @@ CallResult EVM::execute(const Transaction& txn, uint64_t gas) noexcept {
         static_cast<int64_t>(gas),                    // gas
         txn.to ? *txn.to : evmc::address{},           // destination
         *txn.from,                                    // sender
-        &txn.data[0],                                 // input_data
+        txn.data.data(),                              // input_data
         txn.data.size(),                              // input_size
         intx::be::store<evmc::uint256be>(txn.value),  // value
     };
@@ -86,7 +86,7 @@ evmc::result EVM::create(const evmc_message& message) noexcept {
 
     auto snapshot{state_.take_snapshot()};
 
-    uint64_t block_num{block_.header.number};
+    uint64_t block_num{header_.number};
     bool spurious_dragon{config().has_spurious_dragon(block_num)};
 
     state_.create_contract(contract_addr);
@@ -150,7 +150,7 @@ evmc::result EVM::call(const evmc_message& message) noexcept {
     bool precompiled{is_precompiled(message.destination)};
 
     // https://eips.ethereum.org/EIPS/eip-161
-    if (value == 0 && config().has_spurious_dragon(block_.header.number) && !state_.exists(message.destination) &&
+    if (value == 0 && config().has_spurious_dragon(header_.number) && !state_.exists(message.destination) &&
         !precompiled) {
         return res;
     }
@@ -250,7 +250,7 @@ evmc::result EVM::execute(const evmc_message& msg, ByteView code, std::optional<
 }
 
 evmc_revision EVM::revision() const noexcept {
-    uint64_t block_number{block_.header.number};
+    uint64_t block_number{header_.number};
 
     if (config().has_istanbul(block_number)) return EVMC_ISTANBUL;
     if (config().has_petersburg(block_number)) return EVMC_PETERSBURG;
@@ -264,7 +264,7 @@ evmc_revision EVM::revision() const noexcept {
 }
 
 uint8_t EVM::number_of_precompiles() const noexcept {
-    uint64_t block_number{block_.header.number};
+    uint64_t block_number{header_.number};
 
     if (config().has_istanbul(block_number)) {
         return precompiled::kNumOfIstanbulContracts;
@@ -286,7 +286,7 @@ bool EVM::is_precompiled(const evmc::address& contract) const noexcept {
 }
 
 bool EvmHost::account_exists(const evmc::address& address) const noexcept {
-    if (evm_.config().has_spurious_dragon(evm_.block_.header.number)) {
+    if (evm_.config().has_spurious_dragon(evm_.header_.number)) {
         return !evm_.state().dead(address);
     } else {
         return evm_.state().exists(address);
@@ -307,7 +307,7 @@ evmc_storage_status EvmHost::set_storage(const evmc::address& address, const evm
 
     evm_.state().set_storage(address, key, new_val);
 
-    uint64_t block_number{evm_.block_.header.number};
+    uint64_t block_number{evm_.header_.number};
     bool eip1283{evm_.config().has_istanbul(block_number) ||
                  (evm_.config().has_constantinople(block_number) && !evm_.config().has_petersburg(block_number))};
 
@@ -414,23 +414,23 @@ evmc_tx_context EvmHost::get_tx_context() const noexcept {
     evmc_tx_context context;
     intx::be::store(context.tx_gas_price.bytes, evm_.txn_->gas_price);
     context.tx_origin = *evm_.txn_->from;
-    context.block_coinbase = evm_.block_.header.beneficiary;
-    context.block_number = evm_.block_.header.number;
-    context.block_timestamp = evm_.block_.header.timestamp;
-    context.block_gas_limit = evm_.block_.header.gas_limit;
-    intx::be::store(context.block_difficulty.bytes, evm_.block_.header.difficulty);
+    context.block_coinbase = evm_.header_.beneficiary;
+    context.block_number = evm_.header_.number;
+    context.block_timestamp = evm_.header_.timestamp;
+    context.block_gas_limit = evm_.header_.gas_limit;
+    intx::be::store(context.block_difficulty.bytes, evm_.header_.difficulty);
     intx::be::store(context.chain_id.bytes, intx::uint256{evm_.config().chain_id});
     return context;
 }
 
 evmc::bytes32 EvmHost::get_block_hash(int64_t n) const noexcept {
-    uint64_t base_number{evm_.block_.header.number};
+    uint64_t base_number{evm_.header_.number};
     uint64_t new_size{base_number - n};
     assert(new_size <= 256);
 
     std::vector<evmc::bytes32>& hashes{evm_.block_hashes_};
     if (hashes.empty()) {
-        hashes.push_back(evm_.block_.header.parent_hash);
+        hashes.push_back(evm_.header_.parent_hash);
     }
 
     uint64_t old_size{hashes.size()};
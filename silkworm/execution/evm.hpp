@@ -25,6 +25,7 @@
 #include <silkworm/execution/analysis_cache.hpp>
 #include <silkworm/state/intra_block_state.hpp>
 #include <silkworm/types/block.hpp>
+#include <silkworm/types/block_view.hpp>
 #include <stack>
 #include <vector>
 
@@ -45,15 +46,20 @@ class EVM {
     EVM(const EVM&) = delete;
     EVM& operator=(const EVM&) = delete;
 
-    EVM(const Block& block, IntraBlockState& state, const ChainConfig& config = kMainnetConfig) noexcept;
+    EVM(const BlockHeader& header, IntraBlockState& state, const ChainConfig& config = kMainnetConfig) noexcept;
 
-    const Block& block() const noexcept { return block_; }
+    EVM(const Block& block, IntraBlockState& state, const ChainConfig& config = kMainnetConfig) noexcept
+        : EVM{block.header, state, config} {}
+
+    const BlockHeader& header() const noexcept { return header_; }
 
     const ChainConfig& config() const noexcept { return config_; }
 
     IntraBlockState& state() noexcept { return state_; }
 
-    CallResult execute(const Transaction& txn, uint64_t gas) noexcept;
+    CallResult execute(const TransactionView& txn, uint64_t gas) noexcept;
+
+    CallResult execute(const Transaction& txn, uint64_t gas) noexcept { return execute(TransactionView{txn}, gas); }
 
     AnalysisCache* analysis_cache{nullptr};  // use for better performance
 
@@ -71,10 +77,10 @@ class EVM {
     uint8_t number_of_precompiles() const noexcept;
     bool is_precompiled(const evmc::address& contract) const noexcept;
 
-    const Block& block_;
+    const BlockHeader& header_;
     IntraBlockState& state_;
     const ChainConfig& config_;
-    const Transaction* txn_{nullptr};
+    const TransactionView* txn_{nullptr};
     std::vector<evmc::bytes32> block_hashes_{};
     std::stack<evmc::address> address_stack_{};
 };
@@ -16,18 +16,27 @@
 
 #include "execution.hpp"
 
+#include <optional>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/trie/vector_root.hpp>
 
+#include "body_validation.hpp"
 #include "processor.hpp"
 
 namespace silkworm {
 
-std::vector<Receipt> execute_block(const Block& block, db::Buffer& buffer, const ChainConfig& config,
-                                   AnalysisCache* analysis_cache) {
+// Block or BlockView
+template <class B>
+static std::vector<Receipt> execute(const B& block, db::Buffer& buffer, const ChainConfig& config,
+                                    AnalysisCache* analysis_cache, ThreadPool* validation_pool) {
     const BlockHeader& header{block.header};
     uint64_t block_num{header.number};
 
+    std::optional<BodyValidator> body_validator{};
+    if (validation_pool) {
+        body_validator.emplace(block, *validation_pool);
+    }
+
     IntraBlockState state{buffer};
     ExecutionProcessor processor{block, state, config};
     processor.evm().analysis_cache = analysis_cache;
@@ -50,7 +59,21 @@ std::vector<Receipt> execute_block(const Block& block, db::Buffer& buffer, const
         }
     }
 
+    if (body_validator) {
+        body_validator->check(receipts);
+    }
+
     return receipts;
 }
 
+std::vector<Receipt> execute_block(const Block& block, db::Buffer& buffer, const ChainConfig& config,
+                                   AnalysisCache* analysis_cache, ThreadPool* validation_pool) {
+    return execute(block, buffer, config, analysis_cache, validation_pool);
+}
+
+std::vector<Receipt> execute_block(const BlockView& block, db::Buffer& buffer, const ChainConfig& config,
+                                   AnalysisCache* analysis_cache, ThreadPool* validation_pool) {
+    return execute(block, buffer, config, analysis_cache, validation_pool);
+}
+
 }  // namespace silkworm
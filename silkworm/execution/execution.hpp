@@ -18,25 +18,28 @@
 #define SILKWORM_EXECUTION_EXECUTION_H_
 
 #include <silkworm/chain/config.hpp>
+#include <silkworm/common/thread_pool.hpp>
 #include <silkworm/db/buffer.hpp>
 #include <silkworm/execution/analysis_cache.hpp>
+#include <silkworm/types/block_view.hpp>
 #include <silkworm/types/receipt.hpp>
-#include <stdexcept>
 
 namespace silkworm {
 
-class ValidationError : public std::runtime_error {
-  public:
-    using std::runtime_error::runtime_error;
-};
-
 /** @brief Executes a given block and writes resulting changes into the database.
  *
  * Transaction senders must be already populated.
  * The DB table kCurrentState should match the Ethereum state at the begining of the block.
+ * If validation_pool is given, the transactions root, the ommers hash and the logs bloom of the header
+ * are checked as well, the former two on the pool while the block is executed (see BodyValidator).
  */
 std::vector<Receipt> execute_block(const Block& block, db::Buffer& buffer, const ChainConfig& config = kMainnetConfig,
-                                   AnalysisCache* analysis_cache = nullptr);
+                                   AnalysisCache* analysis_cache = nullptr, ThreadPool* validation_pool = nullptr);
+
+// Same for a block decoded in place, e.g. by db::read_block into a BlockView
+std::vector<Receipt> execute_block(const BlockView& block, db::Buffer& buffer,
+                                   const ChainConfig& config = kMainnetConfig, AnalysisCache* analysis_cache = nullptr,
+                                   ThreadPool* validation_pool = nullptr);
 
 }  // namespace silkworm
 
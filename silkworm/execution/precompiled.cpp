@@ -18,18 +18,16 @@
 
 #include <cryptopp/ripemd.h>
 #include <cryptopp/sha.h>
-#include <silkworm/crypto/blake2.h>
 
 #include <algorithm>
 #include <boost/endian/conversion.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
 #include <cstring>
-#include <ethash/keccak.hpp>
-#include <iterator>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pairing.hpp>
 #include <limits>
 #include <silkworm/common/util.hpp>
+#include <silkworm/crypto/blake2b.hpp>
 #include <silkworm/crypto/ecdsa.hpp>
+#include <silkworm/crypto/modexp.hpp>
 #include <silkworm/crypto/snark.hpp>
 
 #include "protocol_param.hpp"
@@ -59,21 +57,24 @@ std::optional<Bytes> ecrec_run(ByteView input) noexcept {
         return Bytes{};
     }
 
-    std::optional<Bytes> key{ecdsa::recover(d.substr(0, 32), d.substr(64, 64), x.recovery_id)};
-    if (!key || key->at(0) != 4) {
+    ecdsa::RecoverableSignature signature;
+    std::memcpy(signature.message, &d[0], 32);
+    std::memcpy(signature.signature, &d[64], 64);
+    signature.recovery_id = x.recovery_id;
+
+    std::optional<evmc::address> address{ecdsa::recover_address(signature)};
+    if (!address) {
         return Bytes{};
     }
 
-    // Ignore the first byte of the public key
-    ethash::hash256 hash{ethash::keccak256(key->data() + 1, key->length() - 1)};
-
     Bytes out(32, '\0');
-    std::memcpy(&out[12], &hash.bytes[12], 32 - 12);
+    std::memcpy(&out[12], address->bytes, kAddressLength);
     return out;
 }
 
 uint64_t sha256_gas(ByteView input, evmc_revision) noexcept { return 60 + 12 * ((input.length() + 31) / 32); }
 
+// CryptoPP switches to SHA-NI, or to the ARMv8 SHA-2 instructions, at run time where the CPU has them
 std::optional<Bytes> sha256_run(ByteView input) noexcept {
     Bytes out(CryptoPP::SHA256::DIGESTSIZE, '\0');
     CryptoPP::SHA256 hash;
@@ -175,35 +176,15 @@ std::optional<Bytes> expmod_run(ByteView input) noexcept {
 
     input = right_pad(input, base_len + exponent_len + modulus_len);
 
-    boost::multiprecision::cpp_int base{};
-    if (base_len) {
-        import_bits(base, input.data(), input.data() + base_len);
-        input.remove_prefix(base_len);
-    }
-
-    boost::multiprecision::cpp_int exponent{};
-    if (exponent_len) {
-        import_bits(exponent, input.data(), input.data() + exponent_len);
-        input.remove_prefix(exponent_len);
-    }
-
-    boost::multiprecision::cpp_int modulus{};
-    if (modulus_len) {
-        import_bits(modulus, input.data(), input.data() + modulus_len);
-    }
+    ByteView base{input.substr(0, base_len)};
+    input.remove_prefix(base_len);
 
-    if (modulus == 0) {
-        return Bytes(modulus_len, '\0');
-    }
+    ByteView exponent{input.substr(0, exponent_len)};
+    input.remove_prefix(exponent_len);
 
-    boost::multiprecision::cpp_int result{boost::multiprecision::powm(base, exponent, modulus)};
+    ByteView modulus{input.substr(0, modulus_len)};
 
-    Bytes out{};
-    export_bits(result, std::back_inserter(out), 8);
-    assert(out.size() <= modulus_len);
-    out.insert(0, modulus_len - out.size(), '\0');
-
-    return out;
+    return modexp(base, exponent, modulus);
 }
 
 uint64_t bn_add_gas(ByteView, evmc_revision rev) noexcept { return rev >= EVMC_ISTANBUL ? 150 : 500; }
@@ -320,7 +301,7 @@ std::optional<Bytes> blake2_f_run(ByteView input) noexcept {
     std::memcpy(&state.t, input.data() + 196, 8 * 2);
 
     uint32_t r{boost::endian::load_big_u32(input.data())};
-    blake2b_compress(&state, block, r);
+    blake2b_f(&state, block, r);
 
     Bytes out(8 * 8, '\0');
     std::memcpy(&out[0], &state.h[0], 8 * 8);
@@ -28,7 +28,7 @@
 
 namespace silkworm {
 
-intx::uint128 intrinsic_gas(const Transaction& txn, bool homestead, bool istanbul) {
+intx::uint128 intrinsic_gas(const TransactionView& txn, bool homestead, bool istanbul) {
     intx::uint128 gas{fee::kGTransaction};
     if (!txn.to && homestead) {
         gas += fee::kGTxCreate;
@@ -50,7 +50,13 @@ intx::uint128 intrinsic_gas(const Transaction& txn, bool homestead, bool istanbu
 }
 
 ExecutionProcessor::ExecutionProcessor(const Block& block, IntraBlockState& state, const ChainConfig& config)
-    : evm_{block, state, config} {}
+    : evm_{block.header, state, config}, transaction_views_(block.transactions.begin(), block.transactions.end()) {
+    transactions_ = transaction_views_;
+    ommers_ = block.ommers;
+}
+
+ExecutionProcessor::ExecutionProcessor(const BlockView& block, IntraBlockState& state, const ChainConfig& config)
+    : evm_{block.header, state, config}, transactions_{block.transactions}, ommers_{block.ommers} {}
 
 /*
 static void print_gas_used(const Transaction& txn, uint64_t gas_used) {
@@ -61,7 +67,7 @@ static void print_gas_used(const Transaction& txn, uint64_t gas_used) {
 }
 */
 
-Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) {
+Receipt ExecutionProcessor::execute_transaction(const TransactionView& txn) {
     IntraBlockState& state{evm_.state()};
 
     if (!txn.from) {
@@ -73,7 +79,7 @@ Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) {
         throw ValidationError("invalid nonce");
     }
 
-    uint64_t block_number{evm_.block().header.number};
+    uint64_t block_number{evm_.header().number};
     bool homestead{evm_.config().has_homestead(block_number)};
     bool spurious_dragon{evm_.config().has_spurious_dragon(block_number)};
     bool istanbul{evm_.config().has_istanbul(block_number)};
@@ -107,7 +113,7 @@ Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) {
     uint64_t gas_used{txn.gas_limit - refund_gas(txn, vm_res.gas_left)};
 
     // award the miner
-    state.add_to_balance(evm_.block().header.beneficiary, gas_used * txn.gas_price);
+    state.add_to_balance(evm_.header().beneficiary, gas_used * txn.gas_price);
 
     evm_.state().destruct_suicides();
     if (spurious_dragon) {
@@ -126,9 +132,9 @@ Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) {
     };
 }
 
-uint64_t ExecutionProcessor::available_gas() const { return evm_.block().header.gas_limit - cumulative_gas_used_; }
+uint64_t ExecutionProcessor::available_gas() const { return evm_.header().gas_limit - cumulative_gas_used_; }
 
-uint64_t ExecutionProcessor::refund_gas(const Transaction& txn, uint64_t gas_left) {
+uint64_t ExecutionProcessor::refund_gas(const TransactionView& txn, uint64_t gas_left) {
     uint64_t refund{std::min((txn.gas_limit - gas_left) / 2, evm_.state().total_refund())};
     gas_left += refund;
     evm_.state().add_to_balance(*txn.from, gas_left * txn.gas_price);
@@ -138,13 +144,13 @@ uint64_t ExecutionProcessor::refund_gas(const Transaction& txn, uint64_t gas_lef
 std::vector<Receipt> ExecutionProcessor::execute_block() {
     std::vector<Receipt> receipts{};
 
-    uint64_t block_num{evm_.block().header.number};
+    uint64_t block_num{evm_.header().number};
     if (block_num == evm_.config().dao_block) {
         dao::transfer_balances(evm_.state());
     }
 
     cumulative_gas_used_ = 0;
-    for (const Transaction& txn : evm_.block().transactions) {
+    for (const TransactionView& txn : transactions_) {
         receipts.push_back(execute_transaction(txn));
     }
 
@@ -162,7 +168,7 @@ std::vector<Receipt> ExecutionProcessor::execute_block() {
 }
 
 void ExecutionProcessor::apply_rewards() {
-    uint64_t block_number{evm_.block().header.number};
+    uint64_t block_number{evm_.header().number};
     intx::uint256 block_reward;
     if (evm_.config().has_constantinople(block_number)) {
         block_reward = param::kConstantinopleBlockReward;
@@ -173,12 +179,12 @@ void ExecutionProcessor::apply_rewards() {
     }
 
     intx::uint256 miner_reward{block_reward};
-    for (const BlockHeader& ommer : evm_.block().ommers) {
+    for (const BlockHeader& ommer : ommers_) {
         intx::uint256 ommer_reward{((8 + ommer.number - block_number) * block_reward) >> 3};
         evm_.state().add_to_balance(ommer.beneficiary, ommer_reward);
         miner_reward += block_reward / 32;
     }
 
-    evm_.state().add_to_balance(evm_.block().header.beneficiary, miner_reward);
+    evm_.state().add_to_balance(evm_.header().beneficiary, miner_reward);
 }
 }  // namespace silkworm
@@ -19,8 +19,10 @@
 
 #include <stdint.h>
 
+#include <gsl/span>
 #include <silkworm/execution/evm.hpp>
 #include <silkworm/types/block.hpp>
+#include <silkworm/types/block_view.hpp>
 #include <silkworm/types/receipt.hpp>
 #include <silkworm/types/transaction.hpp>
 #include <vector>
@@ -34,8 +36,13 @@ class ExecutionProcessor {
 
     ExecutionProcessor(const Block& block, IntraBlockState& state, const ChainConfig& config = kMainnetConfig);
 
+    // The block is viewed, so it must outlive the processor
+    ExecutionProcessor(const BlockView& block, IntraBlockState& state, const ChainConfig& config = kMainnetConfig);
+
     // precondition: txn.from must be recovered
-    Receipt execute_transaction(const Transaction& txn);
+    Receipt execute_transaction(const TransactionView& txn);
+
+    Receipt execute_transaction(const Transaction& txn) { return execute_transaction(TransactionView{txn}); }
 
     std::vector<Receipt> execute_block();
 
@@ -45,17 +52,25 @@ class ExecutionProcessor {
 
   private:
     uint64_t available_gas() const;
-    uint64_t refund_gas(const Transaction& txn, uint64_t gas_left);
+    uint64_t refund_gas(const TransactionView& txn, uint64_t gas_left);
 
     void apply_rewards();
 
     uint64_t cumulative_gas_used_{0};
     EVM evm_;
+
+    std::vector<TransactionView> transaction_views_;  // of a Block
+    gsl::span<const TransactionView> transactions_;
+    gsl::span<const BlockHeader> ommers_;
 };
 
 // Returns the intrinsic gas of a transaction.
 // Refer to g0 in Section 6.2 "Execution" of the Yellow Paper.
-intx::uint128 intrinsic_gas(const Transaction& txn, bool homestead, bool istanbul);
+intx::uint128 intrinsic_gas(const TransactionView& txn, bool homestead, bool istanbul);
+
+inline intx::uint128 intrinsic_gas(const Transaction& txn, bool homestead, bool istanbul) {
+    return intrinsic_gas(TransactionView{txn}, homestead, istanbul);
+}
 
 }  // namespace silkworm
 
@@ -139,6 +139,16 @@ void decode(ByteView& from, Bytes& to) {
     from.remove_prefix(h.payload_length);
 }
 
+template <>
+void decode(ByteView& from, ByteView& to) {
+    Header h = decode_header(from);
+    if (h.list) {
+        throw DecodingError("unexpected list");
+    }
+    to = from.substr(0, h.payload_length);
+    from.remove_prefix(h.payload_length);
+}
+
 template <>
 void decode(ByteView& from, uint64_t& to) {
     Header h{decode_header(from)};
@@ -40,6 +40,10 @@ void decode(ByteView& from, T& to);
 template <>
 void decode(ByteView& from, Bytes& to);
 
+// Views the string within from instead of copying it
+template <>
+void decode(ByteView& from, ByteView& to);
+
 template <>
 void decode(ByteView& from, uint64_t& to);
 
@@ -21,18 +21,6 @@
 
 namespace silkworm::rlp {
 
-void encode_header(Bytes& to, Header header) {
-    if (header.payload_length < 56) {
-        uint8_t code{header.list ? kEmptyListCode : kEmptyStringCode};
-        to.push_back(static_cast<uint8_t>(code + header.payload_length));
-    } else {
-        ByteView len_be{big_endian(header.payload_length)};
-        uint8_t code = header.list ? '\xF7' : '\xB7';
-        to.push_back(static_cast<uint8_t>(code + len_be.length()));
-        to.append(len_be);
-    }
-}
-
 size_t length_of_length(uint64_t payload_length) {
     if (payload_length < 56) {
         return 1;
@@ -41,18 +29,6 @@ size_t length_of_length(uint64_t payload_length) {
     }
 }
 
-void encode(Bytes& to, const evmc::bytes32& hash) {
-    to.push_back(kEmptyStringCode + kHashLength);
-    to.append(full_view(hash));
-}
-
-void encode(Bytes& to, ByteView s) {
-    if (s.length() != 1 || s[0] >= kEmptyStringCode) {
-        encode_header(to, {false, s.length()});
-    }
-    to.append(s);
-}
-
 size_t length(ByteView s) {
     size_t len{s.length()};
     if (s.length() != 1 || s[0] >= kEmptyStringCode) {
@@ -61,18 +37,6 @@ size_t length(ByteView s) {
     return len;
 }
 
-void encode(Bytes& to, uint64_t n) {
-    if (n == 0) {
-        to.push_back(kEmptyStringCode);
-    } else if (n < kEmptyStringCode) {
-        to.push_back(static_cast<uint8_t>(n));
-    } else {
-        ByteView be{big_endian(n)};
-        to.push_back(static_cast<uint8_t>(kEmptyStringCode + be.length()));
-        to.append(be);
-    }
-}
-
 size_t length(uint64_t n) noexcept {
     if (n < kEmptyStringCode) {
         return 1;
@@ -81,18 +45,6 @@ size_t length(uint64_t n) noexcept {
     }
 }
 
-void encode(Bytes& to, const intx::uint256& n) {
-    if (n == 0) {
-        to.push_back(kEmptyStringCode);
-    } else if (n < kEmptyStringCode) {
-        to.push_back(intx::narrow_cast<uint8_t>(n));
-    } else {
-        ByteView be{big_endian(n)};
-        to.push_back(static_cast<uint8_t>(kEmptyStringCode + be.length()));
-        to.append(be);
-    }
-}
-
 size_t length(const intx::uint256& n) {
     if (n < kEmptyStringCode) {
         return 1;
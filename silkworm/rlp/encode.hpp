@@ -20,7 +20,9 @@
 #ifndef SILKWORM_RLP_ENCODE_H_
 #define SILKWORM_RLP_ENCODE_H_
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <gsl/span>
 #include <intx/intx.hpp>
 #include <optional>
@@ -34,6 +36,7 @@ struct BlockHeader;
 struct Log;
 struct Receipt;
 struct Transaction;
+struct TransactionView;
 
 namespace rlp {
 
@@ -45,35 +48,139 @@ namespace rlp {
     constexpr uint8_t kEmptyStringCode = 0x80;
     constexpr uint8_t kEmptyListCode = 0xC0;
 
-    void encode_header(Bytes& to, Header header);
+    // Returns a view of a thread-local buffer,
+    // which must be consumed prior to the next invocation.
+    ByteView big_endian(uint64_t n);
+
+    // Returns a view of a thread-local buffer,
+    // which must be consumed prior to the next invocation.
+    ByteView big_endian(const intx::uint256& n);
+
+    // Encoding functions templated over Writer accept Bytes as well as
+    // anything else with push_back(uint8_t) & append(ByteView), e.g. KeccakHasher or SpanWriter.
+
+    /** @brief Writer into a caller-supplied buffer, e.g. a slice of an arena or of an MDB_RESERVE'd value.
+     *
+     * Unlike Bytes it never checks capacity nor reallocates, so the buffer must hold the whole encoding;
+     * size it exactly with the matching length function beforehand.
+     * Overruns are only caught by debug asserts.
+     */
+    class SpanWriter {
+      public:
+        SpanWriter(uint8_t* data, size_t size) : begin_{data}, out_{data}, end_{data + size} {}
+
+        void push_back(uint8_t byte) {
+            assert(out_ < end_);
+            *out_++ = byte;
+        }
+
+        void append(ByteView s) {
+            assert(s.length() <= static_cast<size_t>(end_ - out_));
+            out_ = std::copy_n(s.data(), s.length(), out_);
+        }
+
+        // Bytes written so far
+        size_t size() const { return static_cast<size_t>(out_ - begin_); }
 
-    void encode(Bytes& to, const evmc::bytes32&);
-    void encode(Bytes& to, ByteView);
-    void encode(Bytes& to, uint64_t);
-    void encode(Bytes& to, const intx::uint256&);
+        bool full() const { return out_ == end_; }
 
-    template <size_t N>
-    void encode(Bytes& to, gsl::span<const uint8_t, N> bytes) {
+      private:
+        uint8_t* begin_;
+        uint8_t* out_;
+        uint8_t* end_;
+    };
+
+    template <class Writer>
+    void encode_header(Writer& to, Header header) {
+        if (header.payload_length < 56) {
+            uint8_t code{header.list ? kEmptyListCode : kEmptyStringCode};
+            to.push_back(static_cast<uint8_t>(code + header.payload_length));
+        } else {
+            ByteView len_be{big_endian(header.payload_length)};
+            uint8_t code = header.list ? '\xF7' : '\xB7';
+            to.push_back(static_cast<uint8_t>(code + len_be.length()));
+            to.append(len_be);
+        }
+    }
+
+    template <class Writer>
+    void encode(Writer& to, const evmc::bytes32& hash) {
+        to.push_back(kEmptyStringCode + kHashLength);
+        to.append(ByteView{hash.bytes, kHashLength});
+    }
+
+    template <class Writer>
+    void encode(Writer& to, ByteView s) {
+        if (s.length() != 1 || s[0] >= kEmptyStringCode) {
+            encode_header(to, {false, s.length()});
+        }
+        to.append(s);
+    }
+
+    template <class Writer>
+    void encode(Writer& to, uint64_t n) {
+        if (n == 0) {
+            to.push_back(kEmptyStringCode);
+        } else if (n < kEmptyStringCode) {
+            to.push_back(static_cast<uint8_t>(n));
+        } else {
+            ByteView be{big_endian(n)};
+            to.push_back(static_cast<uint8_t>(kEmptyStringCode + be.length()));
+            to.append(be);
+        }
+    }
+
+    template <class Writer>
+    void encode(Writer& to, const intx::uint256& n) {
+        if (n == 0) {
+            to.push_back(kEmptyStringCode);
+        } else if (n < kEmptyStringCode) {
+            to.push_back(intx::narrow_cast<uint8_t>(n));
+        } else {
+            ByteView be{big_endian(n)};
+            to.push_back(static_cast<uint8_t>(kEmptyStringCode + be.length()));
+            to.append(be);
+        }
+    }
+
+    template <class Writer, size_t N>
+    void encode(Writer& to, gsl::span<const uint8_t, N> bytes) {
         static_assert(N <= 55, "Complex RLP length encoding not supported");
         to.push_back(kEmptyStringCode + N);
-        to.append(bytes.data(), N);
+        to.append(ByteView{bytes.data(), N});
     }
 
-    template <size_t N>
-    void encode(Bytes& to, const uint8_t (&bytes)[N]) {
-        encode<N>(to, gsl::span<const uint8_t, N>{bytes});
+    template <class Writer, size_t N>
+    void encode(Writer& to, const uint8_t (&bytes)[N]) {
+        encode(to, gsl::span<const uint8_t, N>{bytes});
     }
 
-    template <size_t N>
-    void encode(Bytes& to, const std::array<uint8_t, N>& bytes) {
-        encode<N>(to, gsl::span<const uint8_t, N>{bytes});
+    template <class Writer, size_t N>
+    void encode(Writer& to, const std::array<uint8_t, N>& bytes) {
+        encode(to, gsl::span<const uint8_t, N>{bytes});
     }
 
     void encode(Bytes& to, const BlockBody&);
-    void encode(Bytes& to, const BlockHeader&);
-    void encode(Bytes& to, const Log&);
-    void encode(Bytes& to, const Receipt&);
-    void encode(Bytes& to, const Transaction&);
+
+    // Instantiated for Bytes, KeccakHasher and SpanWriter
+    template <class Writer>
+    void encode(Writer& to, const BlockHeader&);
+
+    // Instantiated for Bytes and SpanWriter
+    template <class Writer>
+    void encode(Writer& to, const Log&);
+
+    // Instantiated for Bytes and SpanWriter
+    template <class Writer>
+    void encode(Writer& to, const Receipt&);
+
+    // Instantiated for Bytes, KeccakHasher and SpanWriter
+    template <class Writer>
+    void encode(Writer& to, const Transaction&);
+
+    // Copies the encoding viewed, if any, see BlockView. Instantiated for Bytes and SpanWriter.
+    template <class Writer>
+    void encode(Writer& to, const TransactionView&);
 
     size_t length_of_length(uint64_t payload_length);
 
@@ -85,36 +192,37 @@ namespace rlp {
 
     size_t length(const BlockHeader&);
     size_t length(const Log&);
+    size_t length(const Receipt&);
     size_t length(const Transaction&);
+    size_t length(const TransactionView&);
 
     template <class T>
-    size_t length(const std::vector<T>& v) {
-        size_t payload_length{0};
+    uint64_t payload_length(const std::vector<T>& v) {
+        uint64_t len{0};
         for (const T& x : v) {
-            payload_length += length(x);
+            len += length(x);
         }
-        return length_of_length(payload_length) + payload_length;
+        return len;
     }
 
     template <class T>
-    void encode(Bytes& to, const std::vector<T>& v) {
-        Header h{true, 0};
-        for (const T& x : v) {
-            h.payload_length += length(x);
-        }
-        encode_header(to, h);
+    size_t length(const std::vector<T>& v) {
+        uint64_t payload{payload_length(v)};
+        return length_of_length(payload) + payload;
+    }
+
+    template <class Writer, class T>
+    void encode(Writer& to, const std::vector<T>& v, uint64_t payload) {
+        encode_header(to, {true, payload});
         for (const T& x : v) {
             encode(to, x);
         }
     }
 
-    // Returns a view of a thread-local buffer,
-    // which must be consumed prior to the next invocation.
-    ByteView big_endian(uint64_t n);
-
-    // Returns a view of a thread-local buffer,
-    // which must be consumed prior to the next invocation.
-    ByteView big_endian(const intx::uint256& n);
+    template <class Writer, class T>
+    void encode(Writer& to, const std::vector<T>& v) {
+        encode(to, v, payload_length(v));
+    }
 }  // namespace rlp
 }  // namespace silkworm
 
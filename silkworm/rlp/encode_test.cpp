@@ -75,5 +75,13 @@ TEST_CASE("RLP encoding") {
         CHECK(to_hex(encoded(std::vector<uint64_t>{})) == "c0");
         CHECK(to_hex(encoded(std::vector<uint64_t>{0xFFCCB5, 0xFFC0B5})) == "c883ffccb583ffc0b5");
     }
+
+    SECTION("span writer") {
+        uint8_t buf[3];
+        rlp::SpanWriter writer{buf, sizeof(buf)};
+        rlp::encode(writer, 0x400);
+        CHECK(writer.full());
+        CHECK(to_hex(ByteView{buf, sizeof(buf)}) == "820400");
+    }
 }
 }  // namespace silkworm
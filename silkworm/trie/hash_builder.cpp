@@ -21,105 +21,123 @@
 #include <cstring>
 #include <ethash/keccak.hpp>
 #include <silkworm/common/util.hpp>
+#include <silkworm/crypto/keccak.hpp>
 #include <silkworm/rlp/encode.hpp>
 
 namespace silkworm::trie {
 
-static Bytes unpack_nibbles(ByteView packed) {
-    Bytes out(2 * packed.length(), '\0');
+static void unpack_nibbles(ByteView packed, Bytes& out) {
+    out.resize(2 * packed.length());
     for (size_t i{0}; i < packed.length(); ++i) {
         out[2 * i] = packed[i] >> 4;
         out[2 * i + 1] = packed[i] & 0xF;
     }
-    return out;
 }
 
-static Bytes encode_path(ByteView path, bool terminating) {
-    Bytes res(path.length() / 2 + 1, '\0');
+static void encode_path(ByteView path, bool terminating, Bytes& out) {
+    out.resize(path.length() / 2 + 1);
     bool odd{path.length() % 2 != 0};
 
     if (!terminating && !odd) {
-        res[0] = 0x00;
+        out[0] = 0x00;
     } else if (!terminating && odd) {
-        res[0] = 0x10;
+        out[0] = 0x10;
     } else if (terminating && !odd) {
-        res[0] = 0x20;
+        out[0] = 0x20;
     } else if (terminating && odd) {
-        res[0] = 0x30;
+        out[0] = 0x30;
     }
 
     if (odd) {
-        res[0] |= path[0];
-        for (size_t i{1}; i < res.length(); ++i) {
-            res[i] = (path[2 * i - 1] << 4) + path[2 * i];
+        out[0] |= path[0];
+        for (size_t i{1}; i < out.length(); ++i) {
+            out[i] = (path[2 * i - 1] << 4) + path[2 * i];
         }
     } else {
-        for (size_t i{1}; i < res.length(); ++i) {
-            res[i] = (path[2 * i - 2] << 4) + path[2 * i - 1];
+        for (size_t i{1}; i < out.length(); ++i) {
+            out[i] = (path[2 * i - 2] << 4) + path[2 * i - 1];
         }
     }
-
-    return res;
 }
 
-// RLP of a leaf or extension node
-static Bytes short_node_rlp(ByteView encoded_path, ByteView payload) {
-    Bytes rlp{};
+// Appends RLP of a leaf or extension node
+static void encode_short_node(Bytes& to, ByteView encoded_path, ByteView payload) {
     rlp::Header h;
     h.list = true;
     h.payload_length = rlp::length(encoded_path) + rlp::length(payload);
-    rlp::encode_header(rlp, h);
-    rlp::encode(rlp, encoded_path);
-    rlp::encode(rlp, payload);
-    return rlp;
+    rlp::encode_header(to, h);
+    rlp::encode(to, encoded_path);
+    rlp::encode(to, payload);
 }
 
-static Bytes leaf_node_rlp(ByteView path, ByteView value) {
-    return short_node_rlp(encode_path(path, /*terminating=*/true), value);
+void HashBuilder::NodeRef::assign_rlp(ByteView rlp) {
+    if (rlp.length() < kHashLength) {
+        std::memcpy(bytes, rlp.data(), rlp.length());
+        length = static_cast<uint8_t>(rlp.length());
+    } else {
+        assign_hash(keccak256(rlp).bytes);
+    }
 }
 
-static Bytes extension_node_rlp(ByteView path, ByteView child_ref) {
-    return short_node_rlp(encode_path(path, /*terminating=*/false), child_ref);
+void HashBuilder::NodeRef::assign_hash(const uint8_t* hash) {
+    std::memcpy(bytes, hash, kHashLength);
+    length = kHashLength;
 }
 
-static ByteView node_ref(ByteView rlp) {
-    if (rlp.length() < kHashLength) {
-        return rlp;
-    }
+HashBuilder::HashBuilder(ByteView key0, ByteView value0) { add(key0, value0); }
+
+void HashBuilder::add(ByteView packed, ByteView value) {
+    unpack_nibbles(packed, next_key_);
+    add_next_leaf(value);
+}
 
-    thread_local ethash::hash256 hash;
-    hash = keccak256(rlp);
-    return {hash.bytes, kHashLength};
+void HashBuilder::add_leaf(ByteView path, ByteView value) {
+    next_key_.assign(path);
+    add_next_leaf(value);
 }
 
-HashBuilder::HashBuilder(ByteView key0, ByteView value0) : key_{unpack_nibbles(key0)}, value_{value0} {}
+void HashBuilder::add_next_leaf(ByteView value) {
+    assert(!next_key_.empty() && next_key_ > key_);
+    if (!key_.empty()) {
+        gen_struct_step(key_, next_key_, value_, value_is_hash_);
+    }
+    key_.swap(next_key_);
+    value_.assign(value);
+    value_is_hash_ = false;
+}
 
-void HashBuilder::add(ByteView packed, ByteView value) {
-    Bytes key{unpack_nibbles(packed)};
-    assert(key > key_);
-    gen_struct_step(key_, key, value_);
-    key_ = key;
-    value_ = value;
+void HashBuilder::add_branch_node(ByteView path, const evmc::bytes32& hash) {
+    assert(!path.empty() && path > ByteView{key_});
+    if (!key_.empty()) {
+        gen_struct_step(key_, path, value_, value_is_hash_);
+    }
+    key_.assign(path);
+    value_.assign(hash.bytes, kHashLength);
+    value_is_hash_ = true;
 }
 
 evmc::bytes32 HashBuilder::root_hash() {
-    gen_struct_step(key_, {}, value_);
+    if (key_.empty()) {
+        return kEmptyRoot;
+    }
+    gen_struct_step(key_, {}, value_, value_is_hash_);
     key_.clear();
     value_.clear();
+    hash_pending_leaves();
 
-    Bytes& node_ref{stack_.back()};
+    const NodeRef& node_ref{stack_.back()};
     evmc::bytes32 res{};
-    if (node_ref.length() == kHashLength) {
-        std::memcpy(res.bytes, node_ref.data(), kHashLength);
+    if (node_ref.length == kHashLength) {
+        std::memcpy(res.bytes, node_ref.bytes, kHashLength);
     } else {
-        ethash::hash256 hash{keccak256(node_ref)};
+        ethash::hash256 hash{keccak256(node_ref.view())};
         std::memcpy(res.bytes, hash.bytes, kHashLength);
     }
     return res;
 }
 
 // https://github.com/ledgerwatch/turbo-geth/blob/master/docs/programmers_guide/guide.md#generating-the-structural-information-from-the-sequence-of-keys
-void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const ByteView value) {
+void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const ByteView value, bool value_is_hash) {
     for (bool build_extensions{false};; build_extensions = true) {
         const bool prec_exists{!groups_.empty()};
         const size_t prec_len{groups_.empty() ? 0 : groups_.size() - 1};
@@ -141,10 +159,14 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
         }
 
         const ByteView short_node_key{curr.substr(remainder_start)};
-        if (!build_extensions) {
-            stack_.emplace_back(node_ref(leaf_node_rlp(short_node_key, value)));
-        } else if (!short_node_key.empty()) {
-            stack_.back() = node_ref(extension_node_rlp(short_node_key, stack_.back()));
+        if (!build_extensions && value_is_hash) {
+            // The branch node is at the full path, so the remainder goes into an extension above it
+            stack_.emplace_back().assign_hash(value.data());
+        } else if (!build_extensions) {
+            leaf_ref(short_node_key, value);
+        }
+        if ((build_extensions || value_is_hash) && !short_node_key.empty()) {
+            extension_ref(short_node_key);
         }
 
         // Check for the optional part
@@ -154,7 +176,7 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
 
         // Close the immediately encompassing prefix group, if needed
         if (!succ.empty() || prec_exists) {
-            branch_ref(groups_[max_len]);
+            branch_ref(groups_[max_len], curr.substr(0, max_len));
         }
 
         groups_.resize(max_len);
@@ -172,8 +194,38 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
     }
 }
 
+// Pushes a leaf node ref, deferring the hashing of a long RLP.
+void HashBuilder::leaf_ref(ByteView path, ByteView value) {
+    encode_path(path, /*terminating=*/true, encoded_path_);
+
+    // Encode right into the pending area and take it back if the node turns out to be embedded
+    const size_t offset{leaf_rlps_.length()};
+    encode_short_node(leaf_rlps_, encoded_path_, value);
+    const size_t length{leaf_rlps_.length() - offset};
+
+    NodeRef& ref{stack_.emplace_back()};
+    if (length < kHashLength) {
+        ref.assign_rlp(ByteView{leaf_rlps_}.substr(offset));
+        leaf_rlps_.resize(offset);
+    } else {
+        pending_leaves_.push_back({stack_.size() - 1, offset, length});
+    }
+}
+
+// Replaces the top of the stack with an extension node ref pointing to it.
+void HashBuilder::extension_ref(ByteView path) {
+    hash_pending_leaves();
+
+    encode_path(path, /*terminating=*/false, encoded_path_);
+    rlp_.clear();
+    encode_short_node(rlp_, encoded_path_, stack_.back().view());
+    stack_.back().assign_rlp(rlp_);
+}
+
 // Takes children from the stack and replaces them with branch node ref.
-void HashBuilder::branch_ref(uint16_t mask) {
+void HashBuilder::branch_ref(uint16_t mask, ByteView path) {
+    hash_pending_leaves();
+
     const size_t first_child_idx{stack_.size() - popcount(mask)};
 
     rlp::Header h;
@@ -182,25 +234,52 @@ void HashBuilder::branch_ref(uint16_t mask) {
 
     for (size_t i{first_child_idx}, digit{0}; digit < 16; ++digit) {
         if (mask & (1u << digit)) {
-            h.payload_length += stack_[i++].length();
+            h.payload_length += stack_[i++].length;
         }
     }
 
-    Bytes rlp{};
-    rlp::encode_header(rlp, h);
+    rlp_.clear();
+    rlp::encode_header(rlp_, h);
 
     for (size_t i{first_child_idx}, digit{0}; digit < 16; ++digit) {
         if (mask & (1u << digit)) {
-            rlp::encode(rlp, stack_[i++]);
+            rlp::encode(rlp_, stack_[i++].view());
         } else {
-            rlp.push_back(rlp::kEmptyStringCode);
+            rlp_.push_back(rlp::kEmptyStringCode);
         }
     }
 
     // branch nodes with values are not supported
-    rlp.push_back(rlp::kEmptyStringCode);
+    rlp_.push_back(rlp::kEmptyStringCode);
 
     stack_.resize(first_child_idx + 1);
-    stack_.back() = node_ref(rlp);
+    NodeRef& ref{stack_.back()};
+    ref.assign_rlp(rlp_);
+
+    if (node_collector && ref.length == kHashLength) {
+        evmc::bytes32 hash;
+        std::memcpy(hash.bytes, ref.bytes, kHashLength);
+        node_collector(path, hash);
+    }
+}
+
+void HashBuilder::hash_pending_leaves() {
+    const size_t n{pending_leaves_.size()};
+    if (n == 0) {
+        return;
+    }
+
+    batch_in_.resize(n);
+    batch_out_.resize(n);
+    for (size_t i{0}; i < n; ++i) {
+        batch_in_[i] = ByteView{leaf_rlps_}.substr(pending_leaves_[i].offset, pending_leaves_[i].length);
+    }
+    keccak256_batch(batch_in_.data(), n, batch_out_.data());
+
+    for (size_t i{0}; i < n; ++i) {
+        stack_[pending_leaves_[i].stack_index].assign_hash(batch_out_[i].bytes);
+    }
+    pending_leaves_.clear();
+    leaf_rlps_.clear();
 }
 }  // namespace silkworm::trie
@@ -17,6 +17,8 @@
 #ifndef SILKWORM_TRIE_HASH_BUILDER_H_
 #define SILKWORM_TRIE_HASH_BUILDER_H_
 
+#include <ethash/hash_types.hpp>
+#include <functional>
 #include <silkworm/common/base.hpp>
 #include <vector>
 
@@ -30,7 +32,12 @@ class HashBuilder {
     HashBuilder(const HashBuilder&) = delete;
     HashBuilder& operator=(const HashBuilder&) = delete;
 
-    // Must be constructed with the very first (lexicographically) key/value pair.
+    // Path (unpacked nibbles) and hash of a branch node
+    using NodeCollector = std::function<void(ByteView path, const evmc::bytes32& hash)>;
+
+    HashBuilder() = default;
+
+    // Same as the default constructor followed by add(key0, value0).
     HashBuilder(ByteView key0, ByteView value0);
 
     // Entries must be added in the strictly increasing lexicographic order (by key).
@@ -39,19 +46,71 @@ class HashBuilder {
     // (e.g. keys "ab" & "ab05" are mutually exclusive).
     void add(ByteView key, ByteView value);
 
+    // Same as add, but with the key in unpacked nibbles, so that it may be of odd length.
+    void add_leaf(ByteView path, ByteView value);
+
+    // Adds a branch node known by its hash, which stands for all the entries under its path.
+    // The path is in unpacked nibbles and may be of odd length;
+    // otherwise the same constraints as for keys apply.
+    void add_branch_node(ByteView path, const evmc::bytes32& hash);
+
     // May only be called after all entries have been added.
+    // The root of an empty trie is kEmptyRoot.
     evmc::bytes32 root_hash();
 
+    // If set, called for every branch node built whose RLP is long enough to be hashed
+    NodeCollector node_collector;
+
    private:
-    void gen_struct_step(ByteView curr, ByteView succ, ByteView value);
+    // Reference to a node: its RLP if shorter than 32 bytes, otherwise its hash
+    struct NodeRef {
+        uint8_t length{0};
+        uint8_t bytes[kHashLength];
+
+        ByteView view() const { return {bytes, length}; }
+        void assign_rlp(ByteView rlp);  // embeds or hashes
+        void assign_hash(const uint8_t* hash);
+    };
+
+    // Leaf RLP kept in leaf_rlps_ until hashed
+    struct PendingLeaf {
+        size_t stack_index;
+        size_t offset;
+        size_t length;
+    };
 
-    void branch_ref(uint16_t mask);
+    // Adds the leaf at next_key_
+    void add_next_leaf(ByteView value);
 
-    Bytes key_;  // unpacked – one nibble per byte
+    void gen_struct_step(ByteView curr, ByteView succ, ByteView value, bool value_is_hash);
+
+    void leaf_ref(ByteView path, ByteView value);
+    void extension_ref(ByteView path);
+    void branch_ref(uint16_t mask, ByteView path);
+
+    // Replaces the leaf RLPs awaiting hashing with their hashes, all in one keccak256_batch
+    void hash_pending_leaves();
+
+    // All the buffers below are reused from entry to entry,
+    // so that they only grow to the depth of the trie and the sizes of its nodes.
+
+    Bytes key_;  // unpacked – one nibble per byte; empty before the first entry
     Bytes value_;
+    bool value_is_hash_{false};  // of a branch node
+    Bytes next_key_;             // unpacked key being added
 
     std::vector<uint16_t> groups_;
-    std::vector<Bytes> stack_;  // node references: hashes or embedded RLPs
+    std::vector<NodeRef> stack_;
+
+    Bytes rlp_;           // scratch for extension & branch node RLPs
+    Bytes encoded_path_;  // scratch for hex-prefix encoded paths
+
+    // Leaf RLPs too long to be embedded but not hashed yet.
+    // Leaves are only hashed once a node above them needs their references.
+    std::vector<PendingLeaf> pending_leaves_;
+    Bytes leaf_rlps_;
+    std::vector<ByteView> batch_in_;
+    std::vector<ethash::hash256> batch_out_;
 };
 }  // namespace silkworm::trie
 
@@ -21,6 +21,7 @@
 #include <ethash/keccak.hpp>
 #include <iterator>
 #include <silkworm/common/util.hpp>
+#include <vector>
 
 namespace silkworm::trie {
 
@@ -64,4 +65,80 @@ TEST_CASE("HashBuilder") {
     hb1.add(key1, val1);
     CHECK(to_hex(hb1.root_hash()) == to_hex(full_view(hash1.bytes)));
 }
+TEST_CASE("HashBuilder with branch nodes") {
+    HashBuilder empty{};
+    CHECK(empty.root_hash() == kEmptyRoot);
+
+    std::vector<Bytes> keys;
+    for (size_t i{0}; i < 300; ++i) {
+        ethash::hash256 hash{keccak256(Bytes(1, static_cast<uint8_t>(i)) + Bytes(1, static_cast<uint8_t>(i >> 8)))};
+        keys.emplace_back(hash.bytes, kHashLength);
+    }
+    std::sort(keys.begin(), keys.end());
+    const Bytes value(40, '\x07');
+
+    std::vector<std::pair<Bytes, evmc::bytes32>> nodes;
+    HashBuilder full{};
+    full.node_collector = [&nodes](ByteView path, const evmc::bytes32& hash) { nodes.emplace_back(path, hash); };
+    for (const Bytes& key : keys) {
+        full.add(key, value);
+    }
+    const evmc::bytes32 root{full.root_hash()};
+
+    // Every branch node is collected once, the root one last
+    REQUIRE(nodes.size() > 16);
+    CHECK(nodes.back().first.empty());
+    CHECK(nodes.back().second == root);
+
+    // Replace the entries under some branch nodes with their hashes
+    for (size_t step : {1u, 3u, 7u}) {
+        std::vector<std::pair<Bytes, evmc::bytes32>> used;
+        for (size_t i{0}; i + 1 < nodes.size(); i += step) {
+            const Bytes& path{nodes[i].first};
+            // A parent node comes after its children, so drop those already used
+            while (!used.empty() && used.back().first.substr(0, path.length()) == path) {
+                used.pop_back();
+            }
+            used.push_back(nodes[i]);
+        }
+        std::sort(used.begin(), used.end());
+
+        HashBuilder partial{};
+        auto node{used.begin()};
+        for (const Bytes& key : keys) {
+            Bytes nibbles;
+            for (uint8_t byte : key) {
+                nibbles.push_back(byte >> 4);
+                nibbles.push_back(byte & 0xF);
+            }
+            for (; node != used.end() && node->first < nibbles; ++node) {
+                partial.add_branch_node(node->first, node->second);
+            }
+            if (std::none_of(used.begin(), used.end(),
+                             [&nibbles](const auto& n) { return nibbles.substr(0, n.first.length()) == n.first; })) {
+                partial.add(key, value);
+            }
+        }
+        for (; node != used.end(); ++node) {
+            partial.add_branch_node(node->first, node->second);
+        }
+        CHECK(partial.root_hash() == root);
+    }
+
+    // The subtrie under the first nibble 0xa built separately from the paths below it
+    HashBuilder subtrie{};
+    for (const Bytes& key : keys) {
+        if (key[0] >> 4 == 0xa) {
+            Bytes path(1, key[0] & 0xF);
+            for (size_t i{1}; i < key.length(); ++i) {
+                path.push_back(key[i] >> 4);
+                path.push_back(key[i] & 0xF);
+            }
+            subtrie.add_leaf(path, value);
+        }
+    }
+    auto node_a{std::find_if(nodes.begin(), nodes.end(), [](const auto& n) { return n.first == Bytes(1, 0xa); })};
+    REQUIRE(node_a != nodes.end());
+    CHECK(subtrie.root_hash() == node_a->second);
+}
 }  // namespace silkworm::trie
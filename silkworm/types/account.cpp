@@ -26,38 +26,44 @@ bool operator==(const Account& a, const Account& b) {
 }
 
 Bytes Account::encode_for_storage(bool omit_code_hash) const {
-    Bytes res(1, '\0');
+    Bytes res{};
+    encode_for_storage(res, omit_code_hash);
+    return res;
+}
+
+void Account::encode_for_storage(Bytes& to, bool omit_code_hash) const {
+    size_t pos{to.length()};
+    to.push_back('\0');
     uint8_t field_set{0};
 
     if (nonce != 0) {
         field_set = 1;
         ByteView be{rlp::big_endian(nonce)};
-        res.push_back(static_cast<uint8_t>(be.length()));
-        res.append(be);
+        to.push_back(static_cast<uint8_t>(be.length()));
+        to.append(be);
     }
 
     if (balance != 0) {
         field_set |= 2;
         ByteView be{rlp::big_endian(balance)};
-        res.push_back(static_cast<uint8_t>(be.length()));
-        res.append(be);
+        to.push_back(static_cast<uint8_t>(be.length()));
+        to.append(be);
     }
 
     if (incarnation != 0) {
         field_set |= 4;
         ByteView be{rlp::big_endian(incarnation)};
-        res.push_back(static_cast<uint8_t>(be.length()));
-        res.append(be);
+        to.push_back(static_cast<uint8_t>(be.length()));
+        to.append(be);
     }
 
     if (code_hash != kEmptyHash && !omit_code_hash) {
         field_set |= 8;
-        res.push_back(kHashLength);
-        res.append(code_hash.bytes, kHashLength);
+        to.push_back(kHashLength);
+        to.append(code_hash.bytes, kHashLength);
     }
 
-    res[0] = field_set;
-    return res;
+    to[pos] = field_set;
 }
 
 size_t Account::encoding_length_for_storage() const {
@@ -33,6 +33,9 @@ struct Account {
     // Turbo-Geth (*Account)EncodeForStorage
     Bytes encode_for_storage(bool omit_code_hash) const;
 
+    // Appends the encoding for storage to the given buffer
+    void encode_for_storage(Bytes& to, bool omit_code_hash) const;
+
     // Turbo-Geth (*Account)EncodingLengthForStorage
     size_t encoding_length_for_storage() const;
 };
@@ -17,6 +17,7 @@
 #include "block.hpp"
 
 #include <cstring>
+#include <silkworm/crypto/keccak.hpp>
 #include <silkworm/rlp/encode.hpp>
 
 namespace silkworm {
@@ -55,7 +56,8 @@ namespace rlp {
         return length_of_length(rlp_head.payload_length) + rlp_head.payload_length;
     }
 
-    void encode(Bytes& to, const BlockHeader& header) {
+    template <class Writer>
+    void encode(Writer& to, const BlockHeader& header) {
         encode_header(to, rlp_header(header));
         encode(to, header.parent_hash.bytes);
         encode(to, header.ommers_hash.bytes);
@@ -74,6 +76,10 @@ namespace rlp {
         encode(to, header.nonce);
     }
 
+    template void encode(Bytes&, const BlockHeader&);
+    template void encode(KeccakHasher&, const BlockHeader&);
+    template void encode(SpanWriter&, const BlockHeader&);
+
     template <>
     void decode(ByteView& from, BlockHeader& to) {
         Header rlp_head{decode_header(from)};
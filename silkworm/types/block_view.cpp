@@ -0,0 +1,81 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "block_view.hpp"
+
+namespace silkworm {
+
+TransactionView::TransactionView(const Transaction& txn)
+    : nonce{txn.nonce},
+      gas_price{txn.gas_price},
+      gas_limit{txn.gas_limit},
+      to{txn.to},
+      value{txn.value},
+      data{txn.data},
+      v{txn.v},
+      r{txn.r},
+      s{txn.s},
+      from{txn.from} {}
+
+namespace rlp {
+
+    template <>
+    void decode(ByteView& from, TransactionView& to) {
+        const ByteView encoded{from};
+
+        Header h{decode_header(from)};
+        if (!h.list) {
+            throw DecodingError("unexpected string");
+        }
+
+        decode(from, to.nonce);
+        decode(from, to.gas_price);
+        decode(from, to.gas_limit);
+
+        if (from[0] == kEmptyStringCode) {
+            to.to = {};
+            from.remove_prefix(1);
+        } else {
+            to.to = evmc::address{};
+            decode(from, to.to->bytes);
+        }
+
+        decode(from, to.value);
+        decode(from, to.data);
+        decode(from, to.v);
+        decode(from, to.r);
+        decode(from, to.s);
+
+        to.from.reset();
+        to.rlp = encoded.substr(0, encoded.length() - from.length());
+    }
+
+    void decode_body(ByteView& from, BlockView& to) {
+        Header rlp_head{decode_header(from)};
+        if (!rlp_head.list) {
+            throw DecodingError("unexpected string");
+        }
+
+        decode_vector(from, to.transactions);
+
+        const ByteView ommers{from};
+        decode_vector(from, to.ommers);
+        to.ommers_rlp = ommers.substr(0, ommers.length() - from.length());
+    }
+
+}  // namespace rlp
+
+}  // namespace silkworm
@@ -0,0 +1,78 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_TYPES_BLOCK_VIEW_H_
+#define SILKWORM_TYPES_BLOCK_VIEW_H_
+
+/*
+Blocks decoded in place: variable-length fields view the RLP they were decoded from instead of copying it,
+so the encoding must outlive the view, e.g. as an LMDB page for the duration of the DB transaction.
+Only scalars are decoded, into vectors that keep their capacity when a BlockView is reused for the next block.
+*/
+
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <optional>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/block.hpp>
+#include <silkworm/types/transaction.hpp>
+#include <vector>
+
+namespace silkworm {
+
+// Same fields as Transaction, with data viewed
+struct TransactionView {
+    uint64_t nonce{0};
+    intx::uint256 gas_price;
+    uint64_t gas_limit{0};
+    std::optional<evmc::address> to;
+    intx::uint256 value;
+    ByteView data;
+    intx::uint256 v, r, s;              // signature
+    std::optional<evmc::address> from;  // sender recovered from the signature
+
+    ByteView rlp;  // whole encoding of the transaction; set by decoding only, otherwise encoded field by field
+
+    TransactionView() = default;
+
+    // Views txn.data; rlp is left empty
+    explicit TransactionView(const Transaction& txn);
+};
+
+struct BlockView {
+    BlockHeader header;
+    std::vector<TransactionView> transactions;
+    std::vector<BlockHeader> ommers;
+
+    ByteView ommers_rlp;  // encoded list of ommers; set by decoding only, otherwise empty
+};
+
+namespace rlp {
+    // Same as for Transaction, e.g. to hash it for signing. Instantiated for KeccakHasher.
+    template <class Writer>
+    void encode(Writer& to, const TransactionView& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id);
+
+    template <>
+    void decode(ByteView& from, TransactionView& to);
+
+    // Decodes a block body into the transactions & ommers of to, keeping its header.
+    // As when decoding a BlockBody, the end of the body list isn't checked: anything past the ommers is left in from.
+    void decode_body(ByteView& from, BlockView& to);
+}  // namespace rlp
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_TYPES_BLOCK_VIEW_H_
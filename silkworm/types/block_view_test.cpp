@@ -0,0 +1,155 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "block_view.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/trie/vector_root.hpp>
+
+namespace silkworm {
+
+TEST_CASE("BlockView RLP") {
+    BlockBody body{};
+    body.transactions.resize(2);
+
+    body.transactions[0].nonce = 172339;
+    body.transactions[0].gas_price = 50 * kGiga;
+    body.transactions[0].gas_limit = 90'000;
+    body.transactions[0].to = 0xe5ef458d37212a06e3f59d40c454e76150ae7c32_address;
+    body.transactions[0].value = 1'027'501'080 * kGiga;
+    body.transactions[0].v = 27;
+    body.transactions[0].r =
+        intx::from_string<intx::uint256>("0x48b55bfa915ac795c431978d8a6a992b628d557da5ff759b307d495a36649353");
+    body.transactions[0].s =
+        intx::from_string<intx::uint256>("0x1fffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804");
+
+    body.transactions[1].nonce = 1;
+    body.transactions[1].gas_price = 50 * kGiga;
+    body.transactions[1].gas_limit = 1'000'000;
+    body.transactions[1].data = from_hex("602a6000556101c960015560068060166000396000f3600035600055");
+    body.transactions[1].v = 37;
+    body.transactions[1].r =
+        intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+    body.transactions[1].s =
+        intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+
+    body.ommers.resize(1);
+    body.ommers[0].parent_hash = 0xb397a22bb95bf14753ec174f02f99df3f0bdf70d1851cdff813ebf745f5aeb55_bytes32;
+    body.ommers[0].ommers_hash = kEmptyListHash;
+    body.ommers[0].beneficiary = 0x0c729be7c39543c3d549282a40395299d987cec2_address;
+    body.ommers[0].difficulty = 12'555'442'155'599;
+    body.ommers[0].number = 1'000'013;
+    body.ommers[0].gas_limit = 3'141'592;
+    body.ommers[0].timestamp = 1455404305;
+
+    Bytes rlp{};
+    rlp::encode(rlp, body);
+
+    BlockView block{};
+    block.header.number = 1'000'014;
+
+    ByteView view{rlp};
+    rlp::decode_body(view, block);
+    CHECK(view.empty());
+    CHECK(block.header.number == 1'000'014);
+
+    REQUIRE(block.transactions.size() == 2);
+    for (size_t i{0}; i < 2; ++i) {
+        const Transaction& txn{body.transactions[i]};
+        const TransactionView& decoded{block.transactions[i]};
+        CHECK(decoded.nonce == txn.nonce);
+        CHECK(decoded.gas_price == txn.gas_price);
+        CHECK(decoded.gas_limit == txn.gas_limit);
+        CHECK(decoded.to == txn.to);
+        CHECK(decoded.value == txn.value);
+        CHECK(decoded.data == ByteView{txn.data});
+        CHECK(decoded.v == txn.v);
+        CHECK(decoded.r == txn.r);
+        CHECK(decoded.s == txn.s);
+
+        Bytes encoded{};
+        rlp::encode(encoded, txn);
+        CHECK(decoded.rlp == ByteView{encoded});
+    }
+
+    // Data is viewed in place
+    CHECK(block.transactions[1].data.data() >= rlp.data());
+    CHECK(block.transactions[1].data.data() < rlp.data() + rlp.size());
+
+    CHECK(block.ommers == body.ommers);
+    Bytes ommers_rlp{};
+    rlp::encode(ommers_rlp, body.ommers);
+    CHECK(block.ommers_rlp == ByteView{ommers_rlp});
+
+    CHECK(trie::root_hash(block.transactions) == trie::root_hash(body.transactions));
+
+    // Reused for an empty body
+    Bytes empty_rlp{};
+    rlp::encode(empty_rlp, BlockBody{});
+    view = empty_rlp;
+    rlp::decode_body(view, block);
+    CHECK(block.transactions.empty());
+    CHECK(block.ommers.empty());
+    CHECK(to_hex(block.ommers_rlp) == "c0");
+
+    // Data past the ommers is left
+    Bytes extended_rlp{from_hex("c3c0c001")};
+    view = extended_rlp;
+    rlp::decode_body(view, block);
+    CHECK(to_hex(view) == "01");
+    CHECK(to_hex(block.ommers_rlp) == "c0");
+}
+
+TEST_CASE("TransactionView from Transaction") {
+    Transaction txn{};
+    txn.nonce = 1;
+    txn.gas_price = 50 * kGiga;
+    txn.gas_limit = 1'000'000;
+    txn.data = from_hex("602a6000556101c960015560068060166000396000f3600035600055");
+    txn.v = 37;
+    txn.r = intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+    txn.s = intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+
+    Bytes rlp{};
+    rlp::encode(rlp, txn);
+    ByteView view{rlp};
+    Transaction decoded{};
+    rlp::decode(view, decoded);
+    REQUIRE(decoded == txn);
+
+    std::vector<TransactionView> converted{TransactionView{decoded}};
+    decoded.to = 0xe5ef458d37212a06e3f59d40c454e76150ae7c32_address;
+    decoded.value = 1'027'501'080 * kGiga;
+    converted.emplace_back(decoded);
+
+    std::vector<Transaction> transactions{txn, decoded};
+    for (size_t i{0}; i < transactions.size(); ++i) {
+        // Encoded field by field, since there's no encoding to copy
+        CHECK(converted[i].rlp.empty());
+        Bytes expected{};
+        rlp::encode(expected, transactions[i]);
+        CHECK(rlp::length(converted[i]) == expected.length());
+        Bytes encoded{};
+        rlp::encode(encoded, converted[i]);
+        CHECK(to_hex(encoded) == to_hex(expected));
+    }
+
+    CHECK(trie::root_hash(converted) == trie::root_hash(transactions));
+}
+
+}  // namespace silkworm
@@ -0,0 +1,72 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_TYPES_CBOR_OUTPUT_H_
+#define SILKWORM_TYPES_CBOR_OUTPUT_H_
+
+// cbor-cpp outputs for encoding in two passes: measure first, then write in place.
+// For use in the implementation of the CBOR encoders only, as cbor-cpp is a private dependency.
+
+#include <cassert>
+#include <cstring>
+
+#include "cbor-cpp/src/output.h"
+
+namespace silkworm {
+
+// Counts the bytes put without storing them
+class CborLengthCounter : public cbor::output {
+  public:
+    unsigned char* data() override { return nullptr; }
+    unsigned int size() override { return size_; }
+
+    void put_byte(unsigned char) override { ++size_; }
+    void put_bytes(const unsigned char*, int size) override { size_ += static_cast<unsigned>(size); }
+
+  private:
+    unsigned size_{0};
+};
+
+// Writes into a preallocated buffer, which must fit all the bytes put
+class CborSpanOutput : public cbor::output {
+  public:
+    CborSpanOutput(unsigned char* data, size_t capacity) : data_{data}, capacity_{capacity} {}
+
+    unsigned char* data() override { return data_; }
+    unsigned int size() override { return static_cast<unsigned>(size_); }
+
+    void put_byte(unsigned char value) override {
+        assert(size_ < capacity_);
+        data_[size_++] = value;
+    }
+
+    void put_bytes(const unsigned char* data, int size) override {
+        assert(size_ + static_cast<size_t>(size) <= capacity_);
+        if (size > 0) {
+            std::memcpy(data_ + size_, data, static_cast<size_t>(size));
+            size_ += static_cast<size_t>(size);
+        }
+    }
+
+  private:
+    unsigned char* data_{nullptr};
+    [[maybe_unused]] size_t capacity_{0};
+    size_t size_{0};
+};
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_TYPES_CBOR_OUTPUT_H_
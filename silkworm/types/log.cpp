@@ -16,11 +16,13 @@
 
 #include "log.hpp"
 
+#include <cassert>
+#include <cstring>
 #include <silkworm/common/util.hpp>
 #include <silkworm/rlp/encode.hpp>
 
 #include "cbor-cpp/src/encoder.h"
-#include "cbor-cpp/src/output_dynamic.h"
+#include "cbor_output.hpp"
 
 namespace silkworm {
 
@@ -40,17 +42,20 @@ namespace rlp {
         return length_of_length(h.payload_length) + h.payload_length;
     }
 
-    void encode(Bytes& to, const Log& l) {
+    template <class Writer>
+    void encode(Writer& to, const Log& l) {
         encode_header(to, header(l));
         encode(to, full_view(l.address));
         encode(to, l.topics);
         encode(to, l.data);
     }
 
+    template void encode(Bytes&, const Log&);
+    template void encode(SpanWriter&, const Log&);
+
 }  // namespace rlp
 
-Bytes cbor_encode(const std::vector<Log>& v) {
-    cbor::output_dynamic output{};
+static void cbor_encode(cbor::output& output, const std::vector<Log>& v) {
     cbor::encoder encoder{output};
 
     encoder.write_array(v.size());
@@ -64,8 +69,113 @@ Bytes cbor_encode(const std::vector<Log>& v) {
         }
         encoder.write_bytes(l.data.data(), l.data.size());
     }
+}
+
+size_t cbor_length(const std::vector<Log>& v) {
+    CborLengthCounter counter{};
+    cbor_encode(counter, v);
+    return counter.size();
+}
+
+void cbor_encode(uint8_t* to, size_t length, const std::vector<Log>& v) {
+    CborSpanOutput output{to, length};
+    cbor_encode(output, v);
+    assert(output.size() == length);
+}
+
+Bytes cbor_encode(const std::vector<Log>& v) {
+    Bytes encoded(cbor_length(v), '\0');
+    cbor_encode(encoded.data(), encoded.length(), v);
+    return encoded;
+}
 
-    return Bytes{output.data(), output.size()};
+namespace {
+
+    // CBOR major types
+    constexpr uint8_t kCborBytes{2};
+    constexpr uint8_t kCborArray{4};
+
+    constexpr uint8_t kCborNull{0xf6};
+
+}  // namespace
+
+// Reads the head of a data item of the given major type and returns its argument (length, count or value)
+static uint64_t cbor_read_head(ByteView& from, uint8_t major_type) {
+    if (from.empty()) {
+        throw DecodingError("CBOR: input too short");
+    }
+    if (from[0] >> 5 != major_type) {
+        throw DecodingError("CBOR: unexpected major type");
+    }
+    const auto info{static_cast<uint8_t>(from[0] & 0x1F)};
+    from.remove_prefix(1);
+    if (info < 24) {
+        return info;
+    }
+    if (info > 27) {
+        throw DecodingError("CBOR: unsupported additional information");
+    }
+    const size_t n{1u << (info - 24)};
+    if (from.length() < n) {
+        throw DecodingError("CBOR: input too short");
+    }
+    uint64_t res{0};
+    for (size_t i{0}; i < n; ++i) {
+        res = (res << 8) | from[i];
+    }
+    from.remove_prefix(n);
+    return res;
+}
+
+static ByteView cbor_read_bytes(ByteView& from) {
+    const uint64_t length{cbor_read_head(from, kCborBytes)};
+    if (from.length() < length) {
+        throw DecodingError("CBOR: input too short");
+    }
+    ByteView res{from.substr(0, length)};
+    from.remove_prefix(length);
+    return res;
+}
+
+static ByteView cbor_read_fixed_bytes(ByteView& from, size_t length) {
+    ByteView res{cbor_read_bytes(from)};
+    if (res.length() != length) {
+        throw DecodingError("CBOR: unexpected length");
+    }
+    return res;
+}
+
+void cbor_decode(ByteView from, std::vector<Log>& to) {
+    to.clear();
+    if (from.length() == 1 && from[0] == kCborNull) {
+        return;
+    }
+
+    const uint64_t n{cbor_read_head(from, kCborArray)};
+    // Every log takes more than one byte, which bounds the allocation
+    if (n > from.length()) {
+        throw DecodingError("CBOR: input too short");
+    }
+    to.resize(n);
+    for (Log& l : to) {
+        if (cbor_read_head(from, kCborArray) != 3) {
+            throw DecodingError("CBOR: unexpected log fields");
+        }
+        std::memcpy(l.address.bytes, cbor_read_fixed_bytes(from, kAddressLength).data(), kAddressLength);
+        const uint64_t num_topics{cbor_read_head(from, kCborArray)};
+        if (num_topics > from.length()) {
+            throw DecodingError("CBOR: input too short");
+        }
+        l.topics.resize(num_topics);
+        for (evmc::bytes32& topic : l.topics) {
+            std::memcpy(topic.bytes, cbor_read_fixed_bytes(from, kHashLength).data(), kHashLength);
+        }
+        l.data = cbor_read_bytes(from);
+    }
+
+    if (!from.empty()) {
+        throw DecodingError("CBOR: unexpected trailing bytes");
+    }
 }
 
 }  // namespace silkworm
@@ -33,6 +33,15 @@ struct Log {
 // See core/types/log.go
 Bytes cbor_encode(const std::vector<Log>& v);
 
+// Length of cbor_encode(v)
+size_t cbor_length(const std::vector<Log>& v);
+
+// Encodes into length = cbor_length(v) bytes of preallocated memory, e.g. reserved in the DB
+void cbor_encode(uint8_t* to, size_t length, const std::vector<Log>& v);
+
+// Inverse of cbor_encode. Throws DecodingError.
+void cbor_decode(ByteView from, std::vector<Log>& to);
+
 }  // namespace silkworm
 
 #endif  // SILKWORM_TYPES_LOG_H_
@@ -0,0 +1,69 @@
+/*
+   Copyright 2020 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkworm {
+
+TEST_CASE("CBOR encoding of logs") {
+    std::vector<Log> v{
+        Log{
+            0xea674fdde714fd979de3edf0f56aa9716b898ec8_address,
+            {},
+            from_hex("0x010043"),
+        },
+        Log{
+            0x44fd3ab8381cc3d14afa7c4af7fd13cdc65026e1_address,
+            {to_bytes32(from_hex("dead")), to_bytes32(from_hex("abba"))},
+            from_hex("0xaabbff780043"),
+        },
+    };
+
+    Bytes encoded{from_hex(
+        "8283"
+        "54ea674fdde714fd979de3edf0f56aa9716b898ec8"
+        "80"
+        "43010043"
+        "83"
+        "5444fd3ab8381cc3d14afa7c4af7fd13cdc65026e1"
+        "82"
+        "5820000000000000000000000000000000000000000000000000000000000000dead"
+        "5820000000000000000000000000000000000000000000000000000000000000abba"
+        "46aabbff780043")};
+    CHECK(to_hex(cbor_encode(v)) == to_hex(encoded));
+    CHECK(cbor_length(v) == encoded.length());
+
+    std::vector<Log> decoded;
+    cbor_decode(encoded, decoded);
+    REQUIRE(decoded.size() == 2);
+    CHECK(decoded[0].address == v[0].address);
+    CHECK(decoded[0].topics.empty());
+    CHECK(decoded[0].data == v[0].data);
+    CHECK(decoded[1].address == v[1].address);
+    CHECK(decoded[1].topics == v[1].topics);
+    CHECK(decoded[1].data == v[1].data);
+
+    cbor_decode(cbor_encode({}), decoded);
+    CHECK(decoded.empty());
+
+    CHECK_THROWS_AS(cbor_decode(ByteView{encoded}.substr(0, encoded.length() - 1), decoded), DecodingError);
+    CHECK_THROWS_AS(cbor_decode(encoded + from_hex("00"), decoded), DecodingError);
+}
+
+}  // namespace silkworm
@@ -16,38 +16,49 @@
 
 #include "receipt.hpp"
 
+#include <cassert>
 #include <silkworm/common/util.hpp>
 #include <silkworm/rlp/encode.hpp>
 
 #include "cbor-cpp/src/encoder.h"
-#include "cbor-cpp/src/output_dynamic.h"
+#include "cbor_output.hpp"
 
 namespace silkworm {
 
 namespace rlp {
 
-    static Header header(const Receipt& r) {
+    static Header header(const Receipt& r, uint64_t logs_payload_length) {
         Header h;
         h.list = true;
         h.payload_length = 1;
         h.payload_length += length(r.cumulative_gas_used);
-        h.payload_length += length(full_view(r.bloom));
-        h.payload_length += length(r.logs);
+        h.payload_length += kBloomByteLength + length_of_length(kBloomByteLength);
+        h.payload_length += length_of_length(logs_payload_length) + logs_payload_length;
         return h;
     }
 
-    void encode(Bytes& to, const Receipt& r) {
-        encode_header(to, header(r));
+    size_t length(const Receipt& r) {
+        Header h{header(r, payload_length(r.logs))};
+        return length_of_length(h.payload_length) + h.payload_length;
+    }
+
+    template <class Writer>
+    void encode(Writer& to, const Receipt& r) {
+        // The logs are walked once for both headers
+        const uint64_t logs_payload_length{payload_length(r.logs)};
+        encode_header(to, header(r, logs_payload_length));
         encode(to, r.success);
         encode(to, r.cumulative_gas_used);
         encode(to, full_view(r.bloom));
-        encode(to, r.logs);
+        encode(to, r.logs, logs_payload_length);
     }
 
+    template void encode(Bytes&, const Receipt&);
+    template void encode(SpanWriter&, const Receipt&);
+
 }  // namespace rlp
 
-Bytes cbor_encode(const std::vector<Receipt>& v) {
-    cbor::output_dynamic output{};
+static void cbor_encode(cbor::output& output, const std::vector<Receipt>& v) {
     cbor::encoder encoder{output};
 
     if (v.empty()) {
@@ -63,8 +74,24 @@ Bytes cbor_encode(const std::vector<Receipt>& v) {
         encoder.write_int(r.success ? 1u : 0u);
         encoder.write_int(static_cast<unsigned long long>(r.cumulative_gas_used));
     }
+}
 
-    return Bytes{output.data(), output.size()};
+size_t cbor_length(const std::vector<Receipt>& v) {
+    CborLengthCounter counter{};
+    cbor_encode(counter, v);
+    return counter.size();
+}
+
+void cbor_encode(uint8_t* to, size_t length, const std::vector<Receipt>& v) {
+    CborSpanOutput output{to, length};
+    cbor_encode(output, v);
+    assert(output.size() == length);
+}
+
+Bytes cbor_encode(const std::vector<Receipt>& v) {
+    Bytes encoded(cbor_length(v), '\0');
+    cbor_encode(encoded.data(), encoded.length(), v);
+    return encoded;
 }
 
 }  // namespace silkworm
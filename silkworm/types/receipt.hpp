@@ -33,6 +33,12 @@ struct Receipt {
 // See core/types/receipt.go
 Bytes cbor_encode(const std::vector<Receipt>& v);
 
+// Length of cbor_encode(v)
+size_t cbor_length(const std::vector<Receipt>& v);
+
+// Encodes into length = cbor_length(v) bytes of preallocated memory, e.g. reserved in the DB
+void cbor_encode(uint8_t* to, size_t length, const std::vector<Receipt>& v);
+
 }  // namespace silkworm
 
 #endif  // SILKWORM_TYPES_RECEIPT_H_
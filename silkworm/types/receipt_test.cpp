@@ -18,6 +18,7 @@
 
 #include <catch2/catch.hpp>
 #include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
 
 namespace silkworm {
 
@@ -52,4 +53,32 @@ TEST_CASE("CBOR encoding of receipts") {
     CHECK(to_hex(encoded) == "8283f6001a0032f05d83f6011a00beadd0");
 }
 
+TEST_CASE("Exact RLP encoding of receipts") {
+    Receipt r{};
+    r.success = true;
+    r.cumulative_gas_used = 0x32f05d;
+    r.logs = {
+        Log{
+            0xea674fdde714fd979de3edf0f56aa9716b898ec8_address,
+            {},
+            from_hex("0x010043"),
+        },
+        Log{
+            0x44fd3ab8381cc3d14afa7c4af7fd13cdc65026e1_address,
+            {to_bytes32(from_hex("dead")), to_bytes32(from_hex("abba"))},
+            Bytes(100, '\xaa'),
+        },
+    };
+
+    Bytes appended{};
+    rlp::encode(appended, r);
+    CHECK(rlp::length(r) == appended.length());
+
+    Bytes spanned(rlp::length(r), '\0');
+    rlp::SpanWriter writer{spanned.data(), spanned.length()};
+    rlp::encode(writer, r);
+    CHECK(writer.full());
+    CHECK(spanned == appended);
+}
+
 }  // namespace silkworm
@@ -20,7 +20,9 @@
 #include <ethash/keccak.hpp>
 #include <silkworm/common/util.hpp>
 #include <silkworm/crypto/ecdsa.hpp>
+#include <silkworm/crypto/keccak.hpp>
 #include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/block_view.hpp>
 namespace silkworm {
 
 bool operator==(const Transaction& a, const Transaction& b) {
@@ -30,7 +32,9 @@ bool operator==(const Transaction& a, const Transaction& b) {
 
 namespace rlp {
 
-    static Header rlp_header(const Transaction& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id) {
+    // Shared by Transaction & TransactionView, which have the same fields
+    template <class T>
+    static Header rlp_header(const T& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id) {
         Header h{true, 0};
         h.payload_length += length(txn.nonce);
         h.payload_length += length(txn.gas_price);
@@ -53,7 +57,16 @@ namespace rlp {
         return length_of_length(rlp_head.payload_length) + rlp_head.payload_length;
     }
 
-    void encode(Bytes& to, const Transaction& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id) {
+    size_t length(const TransactionView& txn) {
+        if (!txn.rlp.empty()) {
+            return txn.rlp.length();
+        }
+        Header rlp_head = rlp_header(txn, /*for_signing=*/false, {});
+        return length_of_length(rlp_head.payload_length) + rlp_head.payload_length;
+    }
+
+    template <class Writer, class T>
+    static void encode_fields(Writer& to, const T& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id) {
         encode_header(to, rlp_header(txn, for_signing, eip155_chain_id));
         encode(to, txn.nonce);
         encode(to, txn.gas_price);
@@ -76,7 +89,40 @@ namespace rlp {
         };
     }
 
-    void encode(Bytes& to, const Transaction& txn) { encode(to, txn, /*for_signing=*/false, {}); }
+    template <class Writer>
+    void encode(Writer& to, const Transaction& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id) {
+        encode_fields(to, txn, for_signing, eip155_chain_id);
+    }
+
+    template <class Writer>
+    void encode(Writer& to, const TransactionView& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id) {
+        encode_fields(to, txn, for_signing, eip155_chain_id);
+    }
+
+    template <class Writer>
+    void encode(Writer& to, const Transaction& txn) {
+        encode(to, txn, /*for_signing=*/false, {});
+    }
+
+    // Views converted from a Transaction have no encoding to copy
+    template <class Writer>
+    void encode(Writer& to, const TransactionView& txn) {
+        if (!txn.rlp.empty()) {
+            to.append(txn.rlp);
+        } else {
+            encode_fields(to, txn, /*for_signing=*/false, {});
+        }
+    }
+
+    template void encode(Bytes&, const Transaction&, bool, std::optional<uint64_t>);
+    template void encode(KeccakHasher&, const Transaction&, bool, std::optional<uint64_t>);
+    template void encode(SpanWriter&, const Transaction&, bool, std::optional<uint64_t>);
+    template void encode(Bytes&, const Transaction&);
+    template void encode(KeccakHasher&, const Transaction&);
+    template void encode(SpanWriter&, const Transaction&);
+    template void encode(KeccakHasher&, const TransactionView&, bool, std::optional<uint64_t>);
+    template void encode(Bytes&, const TransactionView&);
+    template void encode(SpanWriter&, const TransactionView&);
 
     template <>
     void decode(ByteView& from, Transaction& to) {
@@ -117,24 +163,21 @@ void Transaction::recover_sender(bool homestead, std::optional<uint64_t> eip155_
         return;
     }
 
-    Bytes rlp{};
+    KeccakHasher hasher;
     bool for_signing{true};
     if (x.eip155_chain_id) {
-        rlp::encode(rlp, *this, for_signing, eip155_chain_id);
+        rlp::encode(hasher, *this, for_signing, eip155_chain_id);
     } else {
-        rlp::encode(rlp, *this, for_signing, {});
+        rlp::encode(hasher, *this, for_signing, {});
     }
-    ethash::hash256 hash{keccak256(rlp)};
+    ethash::hash256 hash{hasher.finalize()};
 
-    uint8_t signature[32 * 2];
-    intx::be::unsafe::store(signature, r);
-    intx::be::unsafe::store(signature + 32, s);
+    ecdsa::RecoverableSignature signature;
+    std::memcpy(signature.message, hash.bytes, kHashLength);
+    intx::be::unsafe::store(signature.signature, r);
+    intx::be::unsafe::store(signature.signature + 32, s);
+    signature.recovery_id = x.recovery_id;
 
-    std::optional<Bytes> recovered{ecdsa::recover(full_view(hash.bytes), full_view(signature), x.recovery_id)};
-    if (recovered) {
-        hash = ethash::keccak256(recovered->data() + 1, recovered->length() - 1);
-        from = evmc::address{};
-        std::memcpy(from->bytes, &hash.bytes[12], 32 - 12);
-    }
+    from = ecdsa::recover_address(signature);
 }
 }  // namespace silkworm
@@ -45,7 +45,9 @@ struct Transaction {
 bool operator==(const Transaction& a, const Transaction& b);
 
 namespace rlp {
-    void encode(Bytes& to, const Transaction& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id);
+    // Instantiated for Bytes, KeccakHasher and SpanWriter
+    template <class Writer>
+    void encode(Writer& to, const Transaction& txn, bool for_signing, std::optional<uint64_t> eip155_chain_id);
 
     template <>
     void decode(ByteView& from, Transaction& to);
@@ -16,17 +16,36 @@
 
 #include "silkworm_tg_api.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <gsl/gsl_util>
+#include <optional>
 #include <silkworm/chain/config.hpp>
 #include <silkworm/common/log.hpp>
+#include <silkworm/common/thread_pool.hpp>
 #include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/block_range_reader.hpp>
+#include <silkworm/db/intermediate_hashes.hpp>
+#include <silkworm/db/sender_recovery.hpp>
+#include <silkworm/db/tables.hpp>
+#include <silkworm/db/util.hpp>
 #include <silkworm/execution/execution.hpp>
+#include <thread>
 
 SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uint64_t chain_id, uint64_t start_block,
                                                            uint64_t max_block, uint64_t batch_size, bool write_receipts,
                                                            uint64_t* last_executed_block,
                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT {
+    return silkworm_execute_blocks_ex(mdb_txn, chain_id, start_block, max_block, batch_size, write_receipts,
+                                      last_executed_block, lmdb_error_code, /*validate_bodies=*/false);
+}
+
+SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks_ex(MDB_txn* mdb_txn, uint64_t chain_id, uint64_t start_block,
+                                                              uint64_t max_block, uint64_t batch_size,
+                                                              bool write_receipts, uint64_t* last_executed_block,
+                                                              int* lmdb_error_code,
+                                                              bool validate_bodies) SILKWORM_NOEXCEPT {
     assert(mdb_txn);
 
     using namespace silkworm;
@@ -44,16 +63,26 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uin
         db::Buffer buffer{&txn};
         AnalysisCache analysis_cache;
 
+        ThreadPool* pool{nullptr};
+        if (validate_bodies) {
+            // Started on first use and shared by all later calls; execution keeps one core busy
+            static ThreadPool validation_pool{std::max(std::thread::hardware_concurrency(), 2u) - 1};
+            pool = &validation_pool;
+        }
+
+        // Reused from block to block; its views are valid since the block tables aren't written to
+        BlockView block;
+        db::BlockRangeReader reader{txn, start_block, max_block, /*read_senders=*/true};
+
         for (uint64_t block_num{start_block}; block_num <= max_block; ++block_num) {
-            std::optional<BlockWithHash> bh{db::read_block(txn, block_num, /*read_senders=*/true)};
-            if (!bh) {
+            if (!reader.next(block)) {
                 return kSilkwormBlockNotFound;
             }
 
-            std::vector<Receipt> receipts{execute_block(bh->block, buffer, *config, &analysis_cache)};
+            std::vector<Receipt> receipts{execute_block(block, buffer, *config, &analysis_cache, pool)};
 
             if (write_receipts) {
-                db::append_receipts(txn, block_num, receipts);
+                buffer.insert_receipts(block_num, std::move(receipts));
             }
 
             if (last_executed_block) {
@@ -88,3 +117,94 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uin
         return kSilkwormUnknownError;
     }
 }
+
+SILKWORM_EXPORT SilkwormStatusCode silkworm_recover_senders(MDB_txn* mdb_txn, uint64_t chain_id, uint64_t start_block,
+                                                            uint64_t max_block, uint32_t num_threads,
+                                                            uint64_t* last_processed_block,
+                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT {
+    assert(mdb_txn);
+
+    using namespace silkworm;
+    Logger::default_logger().set_local_timezone(true);  // for compatibility with TG logging
+
+    const ChainConfig* config{lookup_chain_config(chain_id)};
+    if (!config) {
+        return kSilkwormUnknownChainId;
+    }
+
+    try {
+        lmdb::Transaction txn{/*parent=*/nullptr, mdb_txn, /*flags=*/0};
+        auto cleanup{gsl::finally([&txn] { *txn.handle() = nullptr; })};  // avoid aborting mdb_txn
+
+        ThreadPool pool{num_threads};
+        std::optional<uint64_t> last_block{db::recover_senders(txn, *config, start_block, max_block, pool)};
+        if (last_block && last_processed_block) {
+            *last_processed_block = *last_block;
+        }
+        if (last_block) {
+            SILKWORM_LOG(LogInfo) << "Senders of blocks <= " << *last_block << " recovered" << std::endl;
+        }
+
+        return last_block == max_block ? kSilkwormSuccess : kSilkwormBlockNotFound;
+
+    } catch (const lmdb::exception& e) {
+        if (lmdb_error_code) {
+            *lmdb_error_code = e.err();
+        }
+        return kSilkwormLmdbError;
+    } catch (const ValidationError&) {
+        return kSilkwormInvalidBlock;
+    } catch (const DecodingError&) {
+        return kSilkwormDecodingError;
+    } catch (...) {
+        return kSilkwormUnknownError;
+    }
+}
+
+SILKWORM_EXPORT SilkwormStatusCode silkworm_increment_intermediate_hashes(MDB_txn* mdb_txn, uint64_t start_block,
+                                                                          uint64_t end_block,
+                                                                          int* lmdb_error_code) SILKWORM_NOEXCEPT {
+    assert(mdb_txn);
+
+    using namespace silkworm;
+    Logger::default_logger().set_local_timezone(true);  // for compatibility with TG logging
+
+    try {
+        lmdb::Transaction txn{/*parent=*/nullptr, mdb_txn, /*flags=*/0};
+        auto cleanup{gsl::finally([&txn] { *txn.handle() = nullptr; })};  // avoid aborting mdb_txn
+
+        std::optional<BlockHeader> header{};
+        {
+            auto header_table{txn.open(db::table::kBlockHeaders)};
+            if (std::optional<ByteView> hash{header_table->get(db::header_hash_key(end_block))};
+                hash && hash->length() == kHashLength) {
+                evmc::bytes32 block_hash;
+                std::memcpy(block_hash.bytes, hash->data(), kHashLength);
+                header = db::read_header(txn, end_block, block_hash);
+            }
+        }
+        if (!header) {
+            return kSilkwormBlockNotFound;
+        }
+
+        evmc::bytes32 state_root{db::increment_intermediate_hashes(txn, start_block, end_block)};
+        if (state_root != header->state_root) {
+            SILKWORM_LOG(LogError) << "Wrong state root " << to_hex(state_root) << " after block " << end_block
+                                   << ", expected " << to_hex(header->state_root) << std::endl;
+            return kSilkwormInvalidBlock;
+        }
+        SILKWORM_LOG(LogInfo) << "State root of block " << end_block << " verified" << std::endl;
+
+        return kSilkwormSuccess;
+
+    } catch (const lmdb::exception& e) {
+        if (lmdb_error_code) {
+            *lmdb_error_code = e.err();
+        }
+        return kSilkwormLmdbError;
+    } catch (const DecodingError&) {
+        return kSilkwormDecodingError;
+    } catch (...) {
+        return kSilkwormUnknownError;
+    }
+}
@@ -76,6 +76,62 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* txn, uint64_
                                                            uint64_t* last_executed_block,
                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT;
 
+/** @brief Same as silkworm_execute_blocks, optionally validating block bodies against their headers.
+ *
+ * @param[in] validate_bodies Whether to also check transactions roots, ommers hashes and logs blooms of the headers.
+ * Done on spare cores while the blocks are executed. kSilkwormInvalidBlock is returned on a mismatch.
+ */
+SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks_ex(MDB_txn* txn, uint64_t chain_id, uint64_t start_block,
+                                                              uint64_t max_block, uint64_t batch_size,
+                                                              bool write_receipts, uint64_t* last_executed_block,
+                                                              int* lmdb_error_code,
+                                                              bool validate_bodies) SILKWORM_NOEXCEPT;
+
+/** @brief Recovers transaction senders of a range of Ethereum blocks and writes them into the database.
+ *
+ * @param[in] txn Valid read-write LMDB transaction. Must not be NULL.
+ * This function does not commit nor abort the transaction.
+ * @param[in] chain_id EIP-155 chain ID. kSilkwormUnknownChainId is returned in case of an unknown or unsupported chain.
+ * @param[in] start_block The block height to start the recovery from.
+ * @param[in] max_block Do not recover senders after this block.
+ * @param[in] num_threads The number of recovery threads. Pass 0 to use all available cores.
+ *
+ * @param[out] last_processed_block The height of the last block whose senders were recovered.
+ * Not written to if no blocks were processed, otherwise *last_processed_block ≤ max_block.
+ * @param[out] lmdb_error_code If an LMDB error occurs (this function returns kSilkwormLmdbError)
+ * and lmdb_error_code isn't NULL, it's populated with the relevant LMDB error code.
+ *
+ * @return A non-zero error value on failure and kSilkwormSuccess(=0) on success.
+ * kSilkwormBlockNotFound is probably OK: it simply means that the recovery reached the end of the chain
+ * (senders of blocks up to and incl. last_processed_block were still recovered).
+ * kSilkwormInvalidBlock means that a transaction signature is invalid; nothing should be committed then.
+ */
+SILKWORM_EXPORT SilkwormStatusCode silkworm_recover_senders(MDB_txn* txn, uint64_t chain_id, uint64_t start_block,
+                                                            uint64_t max_block, uint32_t num_threads,
+                                                            uint64_t* last_processed_block,
+                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT;
+
+/** @brief Applies the state changes of a range of Ethereum blocks to the hashed state and the intermediate trie hashes,
+ * then checks the resulting state root against the header of the last block.
+ *
+ * The hashed state and the intermediate trie hashes must reflect the state before start_block.
+ *
+ * @param[in] txn Valid read-write LMDB transaction. Must not be NULL.
+ * This function does not commit nor abort the transaction.
+ * @param[in] start_block The first block whose changes to apply.
+ * @param[in] end_block The last block whose changes to apply.
+ *
+ * @param[out] lmdb_error_code If an LMDB error occurs (this function returns kSilkwormLmdbError)
+ * and lmdb_error_code isn't NULL, it's populated with the relevant LMDB error code.
+ *
+ * @return A non-zero error value on failure and kSilkwormSuccess(=0) on success.
+ * kSilkwormBlockNotFound means that the canonical header of end_block is missing.
+ * kSilkwormInvalidBlock means that the state root doesn't match the header; nothing should be committed then.
+ */
+SILKWORM_EXPORT SilkwormStatusCode silkworm_increment_intermediate_hashes(MDB_txn* txn, uint64_t start_block,
+                                                                          uint64_t end_block,
+                                                                          int* lmdb_error_code) SILKWORM_NOEXCEPT;
+
 #if __cplusplus
 }
 #endif